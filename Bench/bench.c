@@ -0,0 +1,310 @@
+/**
+ * @file bench.c
+ * @brief 目标端基准：SysTick/DWT测量与半主机输出
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./bench.h"
+
+#define BENCH_ST_LOAD SysTick_LOAD_RELOAD_Msk ///< SysTick自由计数，满24位重装
+
+/**
+ * @brief SysTick计数频率，QEMU的 netduinoplus2/olimex-stm32-h405 固定为168MHz
+ */
+#ifndef BENCH_SYSTICK_HZ
+#define BENCH_SYSTICK_HZ SystemCoreClock
+#endif
+
+#define SH_SYS_OPEN 0x01
+#define SH_SYS_CLOSE 0x02
+#define SH_SYS_WRITE0 0x04
+#define SH_SYS_WRITE 0x05
+#define SH_SYS_EXIT 0x18
+#define SH_MODE_W 4                       ///< fopen模式"w"
+#define SH_ADP_STOPPED_APP_EXIT 0x20026 ///< 正常退出
+
+volatile uint32_t bench_irq_cycles;
+volatile uint32_t bench_irq_val;
+volatile uint8_t bench_irq_hit;
+
+static volatile uint32_t bench_st_wraps;
+static uint8_t bench_dwt;
+static int bench_file = -1;
+
+/**
+ * @brief ARM半主机调用
+ */
+static int BENCH_Semihost(int op, void *arg)
+{
+  register int r0 __asm("r0") = op;
+  register void *r1 __asm("r1") = arg;
+
+  __asm volatile("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+  return r0;
+}
+
+static uint32_t BENCH_Strlen(const char *s)
+{
+  uint32_t n = 0;
+
+  while (s[n])
+  {
+    n++;
+  }
+  return n;
+}
+
+static void BENCH_Write(const char *s)
+{
+  BENCH_Semihost(SH_SYS_WRITE0, (void *)s);
+  if (bench_file >= 0)
+  {
+    uint32_t args[3];
+
+    args[0] = (uint32_t)bench_file;
+    args[1] = (uint32_t)s;
+    args[2] = BENCH_Strlen(s);
+    BENCH_Semihost(SH_SYS_WRITE, args);
+  }
+}
+
+/**
+ * @brief 无符号数转十进制，x100为1时按两位小数输出
+ */
+static char *BENCH_Format(char *p, uint64_t v, uint8_t x100)
+{
+  char tmp[24];
+  int n = 0;
+
+  if (x100)
+  {
+    uint32_t frac = (uint32_t)(v % 100);
+
+    v /= 100;
+    tmp[n++] = (char)('0' + frac % 10);
+    tmp[n++] = (char)('0' + frac / 10);
+    tmp[n++] = '.';
+  }
+  do
+  {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+
+  while (n)
+  {
+    *p++ = tmp[--n];
+  }
+  *p = 0;
+  return p;
+}
+
+void BENCH_Emit(const char *key, const char *value)
+{
+  char line[96];
+  char *p = line;
+
+  while (*key && p < line + 60)
+  {
+    *p++ = *key++;
+  }
+  *p++ = '=';
+  while (*value && p < line + sizeof(line) - 2)
+  {
+    *p++ = *value++;
+  }
+  *p++ = '\n';
+  *p = 0;
+  BENCH_Write(line);
+}
+
+/**
+ * @brief 以 bench.<name>.<field> 为键输出一个数值
+ */
+static void BENCH_EmitNum(const char *name, const char *field, uint64_t v, uint8_t x100)
+{
+  char key[64];
+  char value[24];
+  char *p = key;
+  const char *s;
+
+  for (s = "bench."; *s; s++)
+  {
+    *p++ = *s;
+  }
+  for (s = name; *s && p < key + 40; s++)
+  {
+    *p++ = *s;
+  }
+  *p++ = '.';
+  for (s = field; *s && p < key + sizeof(key) - 1; s++)
+  {
+    *p++ = *s;
+  }
+  *p = 0;
+
+  BENCH_Format(value, v, x100);
+  BENCH_Emit(key, value);
+}
+
+void SysTick_Handler(void)
+{
+  bench_st_wraps++;
+}
+
+/**
+ * @brief 64位SysTick计数
+ */
+static uint64_t BENCH_Ticks(void)
+{
+  uint32_t wraps;
+  uint32_t val;
+
+  do
+  {
+    wraps = bench_st_wraps;
+    val = SysTick->VAL;
+  } while (wraps != bench_st_wraps);
+
+  // 计数器已回绕但中断尚未执行
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && val > (BENCH_ST_LOAD >> 1))
+  {
+    wraps++;
+  }
+  return (uint64_t)wraps * (BENCH_ST_LOAD + 1) + (BENCH_ST_LOAD - val);
+}
+
+void BENCH_Init(void)
+{
+  volatile uint32_t spin;
+
+  SysTick->LOAD = BENCH_ST_LOAD;
+  SysTick->VAL = 0;
+  NVIC_SetPriority(SysTick_IRQn, 0);
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+  // QEMU不实现DWT，CYCCNT读出恒为0
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  for (spin = 0; spin < 16; spin++)
+    ;
+  bench_dwt = DWT->CYCCNT != 0;
+}
+
+/**
+ * @brief 调用fn共n次，返回SysTick计数与DWT周期
+ * @note 不内联，保证被测函数与空函数经过完全相同的调用路径
+ */
+static void __attribute__((noinline)) BENCH_Loop(void (*fn)(void), uint32_t n, uint64_t *ticks, uint32_t *cycles)
+{
+  uint32_t c0 = DWT->CYCCNT;
+  uint64_t t0 = BENCH_Ticks();
+
+  while (n--)
+  {
+    fn();
+  }
+
+  *ticks = BENCH_Ticks() - t0;
+  *cycles = DWT->CYCCNT - c0;
+}
+
+static void __attribute__((noinline)) BENCH_Empty(void)
+{
+  __NOP();
+}
+
+void BENCH_Measure(void (*fn)(void), uint32_t iterations, BENCH_Result_t *res)
+{
+  uint64_t base_ticks;
+  uint64_t ticks;
+  uint32_t base_cycles;
+  uint32_t cycles;
+
+  BENCH_Loop(BENCH_Empty, iterations, &base_ticks, &base_cycles);
+  BENCH_Loop(fn, iterations, &ticks, &cycles);
+
+  res->iterations = iterations;
+  res->ticks_x100 = ticks > base_ticks ? (ticks - base_ticks) * 100 / iterations : 0;
+  res->cycles_x100 = bench_dwt && cycles > base_cycles ? (uint64_t)(cycles - base_cycles) * 100 / iterations : 0;
+}
+
+void BENCH_MeasureIrq(IRQn_Type irq, uint32_t iterations, BENCH_Result_t *res)
+{
+  uint64_t ticks = 0;
+  uint64_t cycles = 0;
+  uint32_t c0;
+  uint32_t v0;
+  uint32_t i;
+
+  NVIC_SetPriority(irq, 0);
+  NVIC_EnableIRQ(irq);
+
+  for (i = 0; i < iterations; i++)
+  {
+    bench_irq_hit = 0;
+    c0 = DWT->CYCCNT;
+    v0 = SysTick->VAL;
+    NVIC->STIR = (uint32_t)irq;
+    while (!bench_irq_hit)
+      ;
+    // SysTick向下计数，24位回绕
+    ticks += (v0 - bench_irq_val) & BENCH_ST_LOAD;
+    cycles += bench_irq_cycles - c0;
+  }
+
+  NVIC_DisableIRQ(irq);
+
+  res->iterations = iterations;
+  res->ticks_x100 = ticks * 100 / iterations;
+  res->cycles_x100 = bench_dwt ? cycles * 100 / iterations : 0;
+}
+
+void BENCH_Report(const char *name, const BENCH_Result_t *res)
+{
+  BENCH_EmitNum(name, "iterations", res->iterations, 0);
+  BENCH_EmitNum(name, "ticks_per_call", res->ticks_x100, 1);
+  if (bench_dwt)
+  {
+    BENCH_EmitNum(name, "cycles_per_call", res->cycles_x100, 1);
+  }
+  else
+  {
+    // -icount下每条指令 2^shift 纳秒，SysTick计数换算为指令数
+    BENCH_EmitNum(name, "instructions_per_call",
+                  res->ticks_x100 * 1000000000ULL / BENCH_SYSTICK_HZ >> BENCH_ICOUNT_SHIFT, 1);
+  }
+}
+
+int main(void)
+{
+  const char *path = "bench_results.txt";
+  uint32_t args[3];
+  char num[24];
+
+  args[0] = (uint32_t)path;
+  args[1] = SH_MODE_W;
+  args[2] = BENCH_Strlen(path);
+  bench_file = BENCH_Semihost(SH_SYS_OPEN, args);
+
+  BENCH_Init();
+  BENCH_Emit("bench.meta.source", bench_dwt ? "dwt" : "systick");
+  BENCH_Format(num, BENCH_SYSTICK_HZ, 0);
+  BENCH_Emit("bench.meta.systick_hz", num);
+  BENCH_Format(num, BENCH_ICOUNT_SHIFT, 0);
+  BENCH_Emit("bench.meta.icount_shift", num);
+
+  BENCH_RunCases();
+
+  if (bench_file >= 0)
+  {
+    args[0] = (uint32_t)bench_file;
+    BENCH_Semihost(SH_SYS_CLOSE, args);
+  }
+  BENCH_Semihost(SH_SYS_EXIT, (void *)SH_ADP_STOPPED_APP_EXIT);
+  while (1)
+    ;
+}
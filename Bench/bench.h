@@ -0,0 +1,98 @@
+/**
+ * @file bench.h
+ * @brief 目标端（QEMU / 开发板）驱动热点路径基准
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 每个用例重复调用若干次，用SysTick（处理器时钟、24位、溢出中断计数）
+ * 测量整批耗时，减去空调用的循环开销后求平均。DWT->CYCCNT可用时
+ * （开发板）同时给出周期数；QEMU不实现DWT，只给出SysTick计数，
+ * 配合 `-icount shift=N` 换算为指令数。
+ *
+ * 中断延迟用例由 BENCH_MeasureIrq() 通过 NVIC->STIR 软件触发中断，
+ * 测量从触发到处理函数第一条语句（BENCH_IRQ_ENTRY()）的时间。
+ *
+ * 结果通过半主机写入 bench_results.txt，每行一个 key=value。
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @brief QEMU -icount 的shift参数：每条指令 2^shift 纳秒
+ */
+#ifndef BENCH_ICOUNT_SHIFT
+#define BENCH_ICOUNT_SHIFT 0
+#endif
+
+/**
+ * @brief 单个用例的测量结果（每次调用的平均值，放大100倍以保留两位小数）
+ */
+typedef struct
+{
+  uint32_t iterations;
+  uint64_t ticks_x100;  ///< SysTick计数
+  uint64_t cycles_x100; ///< DWT周期数，DWT不可用时为0
+} BENCH_Result_t;
+
+/**
+ * @brief 中断延迟测量的入口时间戳，由被测中断处理函数写入
+ */
+extern volatile uint32_t bench_irq_cycles;
+extern volatile uint32_t bench_irq_val;
+extern volatile uint8_t bench_irq_hit;
+
+/**
+ * @brief 被测中断处理函数的第一条语句
+ * @note 宏展开在处理函数内，避免调用位于Flash的函数影响测量
+ */
+#define BENCH_IRQ_ENTRY()          \
+  do                               \
+  {                                \
+    bench_irq_cycles = DWT->CYCCNT; \
+    bench_irq_val = SysTick->VAL;  \
+    bench_irq_hit = 1;             \
+  } while (0)
+
+/**
+ * @brief 测量初始化：启动SysTick自由计数，探测DWT是否可用
+ */
+void BENCH_Init(void);
+
+/**
+ * @brief 测量一个用例
+ * @param fn 被测函数
+ * @param iterations 调用次数
+ * @param res 输出结果
+ */
+void BENCH_Measure(void (*fn)(void), uint32_t iterations, BENCH_Result_t *res);
+
+/**
+ * @brief 测量中断延迟
+ * @param irq 被测中断，其处理函数须以 BENCH_IRQ_ENTRY() 开始
+ * @param iterations 触发次数
+ * @param res 输出结果（每次中断的平均延迟）
+ */
+void BENCH_MeasureIrq(IRQn_Type irq, uint32_t iterations, BENCH_Result_t *res);
+
+/**
+ * @brief 输出一个用例的结果
+ * @param name 用例名
+ * @param res 测量结果
+ */
+void BENCH_Report(const char *name, const BENCH_Result_t *res);
+
+/**
+ * @brief 输出一行 key=value
+ */
+void BENCH_Emit(const char *key, const char *value);
+
+/**
+ * @brief 运行全部用例（bench_cases.c）
+ */
+void BENCH_RunCases(void);
+
+#endif
@@ -0,0 +1,281 @@
+/**
+ * @file bench_cases.c
+ * @brief 基准用例：StdPeriph驱动与板级驱动热点路径
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./bench.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_rcc.h"
+#include "stm32f4xx_crc.h"
+#include "stm32f4xx_usart.h"
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_tim.h"
+#include "stm32f4xx_exti.h"
+#include "myInit/myInit.h"
+#include "myMem/myMem.h"
+#include "myVec/myVec.h"
+#include "myPool/myPool.h"
+#include "myLed/myLed.h"
+#include "myKey/myKey.h"
+
+#define BENCH_CRC_WORDS 256 ///< CRC用例数据长度（字）
+#define BENCH_USART_BYTES 64 ///< 串口用例每次发送字节数
+#define BENCH_IRQn FPU_IRQn   ///< 中断延迟用例使用的空闲中断
+#define BENCH_IRQ_COUNT 1000  ///< 中断延迟用例触发次数
+
+/**
+ * @brief 用例描述
+ */
+typedef struct
+{
+  const char *name;     ///< 用例名，输出键为 bench.<name>.*
+  void (*fn)(void);     ///< 被测函数
+  uint32_t iterations; ///< 调用次数
+} BENCH_Case_t;
+
+static GPIO_InitTypeDef bench_gpio;
+static uint32_t bench_crc_buf[BENCH_CRC_WORDS];
+static volatile uint32_t bench_sink; ///< 防止结果被优化掉
+
+static void Case_GPIO_Init(void)
+{
+  GPIO_Init(GPIOF, &bench_gpio);
+}
+
+static void Case_GPIO_SetBits(void)
+{
+  GPIO_SetBits(GPIOF, GPIO_Pin_9);
+}
+
+static void Case_CRC_CalcBlockCRC(void)
+{
+  CRC_ResetDR();
+  bench_sink = CRC_CalcBlockCRC(bench_crc_buf, BENCH_CRC_WORDS);
+}
+
+static void Case_USART_SendData(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < BENCH_USART_BYTES; i++)
+  {
+    while (USART_GetFlagStatus(USART6, USART_FLAG_TXE) == RESET)
+      ;
+    USART_SendData(USART6, i);
+  }
+}
+
+static void Case_RCC_GetClocksFreq(void)
+{
+  RCC_ClocksTypeDef clocks;
+
+  RCC_GetClocksFreq(&clocks);
+  bench_sink = clocks.HCLK_Frequency;
+}
+
+/**
+ * @brief 缓存失效后的首次查询，即未缓存时每次调用的开销
+ */
+static void Case_RCC_GetClocksFreq_Cold(void)
+{
+  RCC_ClocksCacheInvalidate();
+  Case_RCC_GetClocksFreq();
+}
+
+static void Case_USART_Init(void)
+{
+  USART_InitTypeDef USART_InitStructure;
+
+  USART_StructInit(&USART_InitStructure);
+  USART_InitStructure.USART_Mode = USART_Mode_Tx;
+  USART_Init(USART6, &USART_InitStructure);
+}
+
+static void Case_USART_Init_Cold(void)
+{
+  RCC_ClocksCacheInvalidate();
+  Case_USART_Init();
+}
+
+static void Case_DMA_Init(void)
+{
+  DMA_InitTypeDef DMA_InitStructure;
+
+  DMA_DeInit(DMA2_Stream0);
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_Channel = DMA_Channel_0;
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)bench_crc_buf;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)&bench_crc_buf[BENCH_CRC_WORDS / 2];
+  DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToMemory;
+  DMA_InitStructure.DMA_BufferSize = BENCH_CRC_WORDS / 2;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Enable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+  DMA_Init(DMA2_Stream0, &DMA_InitStructure);
+}
+
+static void Case_BOARD_Init(void)
+{
+  BOARD_Init();
+}
+
+/**
+ * @brief 基线参考：原 Key_Read 的逐个引脚读取（固件已不使用，保留以便对比）
+ */
+static void Case_KEY_Read(void)
+{
+  uint8_t v;
+
+  v = PIN_Read(BOARD_KEY0);
+  v |= PIN_Read(BOARD_KEY1) << 1;
+  v |= PIN_Read(BOARD_KEY2) << 2;
+  v |= PIN_Read(BOARD_KEY3) << 3;
+  bench_sink = v;
+}
+
+/**
+ * @brief 固件当前的按键路径：一次EXTI唤醒加一次整端口采样与消抖
+ * @note KEY_Tick() 每 KEY_SCAN_MS 个节拍采样一次，每次调用计入一个完整的采样周期
+ */
+static void Case_KEY_Tick(void)
+{
+  uint8_t i;
+
+  KEY_EXTI_IRQHandler(EXTI_Line0);
+  for (i = 0; i < KEY_SCAN_MS; i++)
+  {
+    KEY_Tick();
+  }
+}
+
+/**
+ * @brief 单个引脚开关（一次BSRR写入）
+ */
+static void Case_PIN_Write(void)
+{
+  PIN_Write(BOARD_LED0, 1);
+}
+
+static void Case_PIN_BankWrite(void)
+{
+  PIN_BankWrite(BOARD_LED_MASK, BOARD_LED_MASK);
+}
+
+/**
+ * @brief main.c 中 LED_Control() 的函数体：亮灭交替，每次都改写帧缓冲
+ * @note main.c 含 main()，不能链接进基准固件，此处照搬其唯一的一行
+ */
+static void Case_LED_Control(void)
+{
+  static uint8_t state;
+
+  state ^= 1;
+  LED_SetBrightness(0, state ? 0 : LED_BRIGHTNESS_MAX);
+}
+
+static void Case_POOL_AllocFree(void)
+{
+  POOL_Free(POOL_Alloc(100));
+}
+
+/**
+ * @brief 中断延迟：处理函数位于Flash
+ */
+static void Isr_Flash(void)
+{
+  BENCH_IRQ_ENTRY();
+}
+
+/**
+ * @brief 中断延迟：处理函数位于SRAM
+ */
+static MEM_RAMFUNC void Isr_Ram(void)
+{
+  BENCH_IRQ_ENTRY();
+}
+
+static const BENCH_Case_t bench_cases[] = {
+    {"GPIO_Init", Case_GPIO_Init, 1000},
+    {"GPIO_SetBits", Case_GPIO_SetBits, 10000},
+    {"CRC_CalcBlockCRC", Case_CRC_CalcBlockCRC, 100},
+    {"USART_SendData", Case_USART_SendData, 20},
+    {"RCC_GetClocksFreq", Case_RCC_GetClocksFreq, 1000},
+    {"RCC_GetClocksFreq_Cold", Case_RCC_GetClocksFreq_Cold, 1000},
+    {"USART_Init", Case_USART_Init, 1000},
+    {"USART_Init_Cold", Case_USART_Init_Cold, 1000},
+    {"DMA_Init", Case_DMA_Init, 1000},
+    {"BOARD_Init", Case_BOARD_Init, 100},
+    {"KEY_Read", Case_KEY_Read, 10000},
+    {"KEY_Tick", Case_KEY_Tick, 10000},
+    {"PIN_Write", Case_PIN_Write, 10000},
+    {"PIN_BankWrite", Case_PIN_BankWrite, 10000},
+    {"LED_Control", Case_LED_Control, 1000},
+    {"POOL_AllocFree", Case_POOL_AllocFree, 10000},
+};
+
+/**
+ * @brief 用例所需的外设时钟与初始数据
+ */
+static void BENCH_SetupCases(void)
+{
+  USART_InitTypeDef USART_InitStructure;
+  uint32_t i;
+
+  RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC | RCC_AHB1Periph_DMA2, ENABLE);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART6, ENABLE);
+
+  for (i = 0; i < BENCH_CRC_WORDS; i++)
+  {
+    bench_crc_buf[i] = i * 0x9E3779B9UL;
+  }
+
+  GPIO_StructInit(&bench_gpio);
+  bench_gpio.GPIO_Pin = GPIO_Pin_9;
+  bench_gpio.GPIO_Mode = GPIO_Mode_OUT;
+
+  USART_StructInit(&USART_InitStructure);
+  USART_InitStructure.USART_Mode = USART_Mode_Tx;
+  USART_Init(USART6, &USART_InitStructure);
+  USART_Cmd(USART6, ENABLE);
+
+  BOARD_Init();
+
+  // 只测量LED引擎的软件路径：停止TIM1，帧缓冲DMA不再运行，不影响其他用例
+  LED_EngineInit();
+  TIM_Cmd(TIM1, DISABLE);
+
+  // 按键引擎由用例直接驱动，关闭EXTI0~EXTI4中断（基准向量表中为默认处理函数）
+  KEY_EngineInit();
+  for (i = EXTI0_IRQn; i <= EXTI4_IRQn; i++)
+  {
+    NVIC_DisableIRQ((IRQn_Type)i);
+  }
+}
+
+void BENCH_RunCases(void)
+{
+  BENCH_Result_t res;
+  uint32_t i;
+
+  BENCH_SetupCases();
+
+  for (i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+  {
+    BENCH_Measure(bench_cases[i].fn, bench_cases[i].iterations, &res);
+    BENCH_Report(bench_cases[i].name, &res);
+  }
+
+  // 向量表已在SRAM，分别注册Flash与SRAM中的处理函数
+  VEC_Init();
+  VEC_SetHandler(BENCH_IRQn, Isr_Flash);
+  BENCH_MeasureIrq(BENCH_IRQn, BENCH_IRQ_COUNT, &res);
+  BENCH_Report("ISR_Latency_Flash", &res);
+  VEC_SetHandler(BENCH_IRQn, Isr_Ram);
+  BENCH_MeasureIrq(BENCH_IRQn, BENCH_IRQ_COUNT, &res);
+  BENCH_Report("ISR_Latency_Ram", &res);
+}
@@ -0,0 +1,53 @@
+#!/bin/sh
+# 在QEMU的STM32F405机型上运行基准固件，结果写入 results-<机型>.txt
+#
+#   ./run.sh                     运行全部机型
+#   BASELINE=dir ./run.sh        与 dir/results-<机型>.txt 比较，
+#                                任一 *_per_call 增加超过 THRESHOLD% 则返回1
+#
+# 环境变量：QEMU（默认 qemu-system-arm）、MACHINES、ICOUNT_SHIFT（须与编译时一致）、
+#          THRESHOLD（默认5）
+
+set -eu
+cd "$(dirname "$0")"
+
+QEMU=${QEMU:-qemu-system-arm}
+MACHINES=${MACHINES:-"netduinoplus2 olimex-stm32-h405"}
+ICOUNT_SHIFT=${ICOUNT_SHIFT:-0}
+THRESHOLD=${THRESHOLD:-5}
+ELF=build/bench.elf
+status=0
+
+[ -f "$ELF" ] || make
+
+for m in $MACHINES; do
+  rm -f bench_results.txt
+  # 半主机以当前目录为根创建 bench_results.txt；-icount 使计时只取决于指令数
+  timeout 120 "$QEMU" -M "$m" -display none -monitor none -serial null \
+    -semihosting-config enable=on,target=native \
+    -icount shift="$ICOUNT_SHIFT" -kernel "$ELF" >/dev/null
+  if [ ! -s bench_results.txt ]; then
+    echo "$m: no results" >&2
+    status=1
+    continue
+  fi
+  mv bench_results.txt "results-$m.txt"
+  echo "== $m"
+  cat "results-$m.txt"
+
+  if [ -n "${BASELINE:-}" ] && [ -f "$BASELINE/results-$m.txt" ]; then
+    awk -F= -v th="$THRESHOLD" -v m="$m" '
+      NR == FNR { base[$1] = $2; next }
+      $1 ~ /_per_call$/ && ($1 in base) && base[$1] > 0 {
+        pct = ($2 - base[$1]) * 100 / base[$1]
+        if (pct > th) {
+          printf "%s: %s regressed %.1f%% (%s -> %s)\n", m, $1, pct, base[$1], $2
+          bad = 1
+        }
+      }
+      END { exit bad }
+    ' "$BASELINE/results-$m.txt" "results-$m.txt" || status=1
+  fi
+done
+
+exit $status
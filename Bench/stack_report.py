@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""静态栈用量报告：合并GCC -fstack-usage/-fcallgraph-info=su 的输出
+
+用法：stack_report.py [--frame N] [--indirect 调用者=目标1,目标2 ...] build/stack/*.ci
+
+逐个翻译单元读取 .ci 调用图（节点带本函数的静态栈帧大小），按名称合并为
+全局调用图，对每个函数求调用链上的最深栈用量。输出为 key=value：
+
+  stack.<函数>.self=<字节>     本函数栈帧
+  stack.<函数>.max=<字节>      含全部被调函数的最深用量
+  stack.<函数>.flags=...       recursive / indirect / unknown:<未编译的被调函数>
+  stack.thread_max=<字节>      非中断入口（main等）中的最大值
+  stack.isr.<入口>=<字节>      每个 *Handler 入口（含异常入栈帧）
+  stack.total_estimate=<字节>  thread_max + 全部中断嵌套时的总和
+  stack.unresolved_indirect=.. 未解析的函数指针调用者（none表示全部已解析）
+
+--indirect 给出函数指针调用的目标（可重复），目标的最深用量计入调用者，例如
+调度器的 SCHED_Dispatch=<各任务函数>，使 main->SCHED_Run->任务 按一条调用链
+相加。带 flags 的结果是下界：递归、未解析的函数指针调用与未编译的库函数不计入；
+total_estimate 只在 unresolved_indirect 为 none 且入口没有其他 flags 时是上界。
+"""
+
+import re
+import sys
+from collections import defaultdict
+
+NODE_RE = re.compile(r'node:\s*\{\s*title:\s*"([^"]+)"\s*label:\s*"([^"]*)"(.*)\}')
+EDGE_RE = re.compile(r'edge:\s*\{\s*sourcename:\s*"([^"]+)"\s*targetname:\s*"([^"]+)"')
+SIZE_RE = re.compile(r'\\n(\d+) bytes \((static|dynamic|dynamic,bounded)\)')
+
+INDIRECT = "__indirect_call"
+
+
+def parse(paths):
+    """返回 defs: 名称 -> [(单元, 栈帧, 是否动态)]，edges: (单元, 调用者) -> [被调函数]"""
+    defs = defaultdict(list)
+    edges = defaultdict(list)
+    for path in paths:
+        with open(path, encoding="utf-8", errors="replace") as f:
+            for line in f:
+                m = NODE_RE.search(line)
+                if m:
+                    title, label, rest = m.groups()
+                    s = SIZE_RE.search(label)
+                    if s and "ellipse" not in rest:
+                        defs[title].append((path, int(s.group(1)), s.group(2) != "static"))
+                    continue
+                m = EDGE_RE.search(line)
+                if m:
+                    edges[(path, m.group(1))].append(m.group(2))
+    return defs, edges
+
+
+def resolve(defs, unit, name):
+    """优先同一单元内的定义（static函数），否则取唯一的定义
+
+    --indirect 中的static函数可以不带GCC加在名称前的 "文件名:" 前缀。
+    """
+    cands = [(c[0], name) for c in defs.get(name, [])]
+    if not cands:
+        cands = [(c[0], title) for title in defs if title.endswith(":" + name) for c in defs[title]]
+    for c in cands:
+        if c[0] == unit:
+            return c
+    if len(cands) >= 1:
+        return cands[0]
+    return None
+
+
+def indirect_targets(indirect, caller):
+    """调用者的函数指针目标，None表示未给出（调用者同样可以不带 "文件名:" 前缀）"""
+    if caller in indirect:
+        return indirect[caller]
+    return indirect.get(caller.rsplit(":", 1)[-1])
+
+
+def analyse(defs, edges, indirect):
+    size = {}
+    for name, cands in defs.items():
+        for unit, sz, dyn in cands:
+            size[(unit, name)] = (sz, dyn)
+
+    memo = {}
+    flags = defaultdict(set)
+    onstack = set()
+
+    def depth(node):
+        if node in memo:
+            return memo[node]
+        if node in onstack:
+            flags[node].add("recursive")
+            return 0
+        onstack.add(node)
+        worst = 0
+        for callee in edges.get(node, []):
+            if callee == INDIRECT:
+                names = indirect_targets(indirect, node[1])
+                if names is None:
+                    flags[node].add("indirect")
+                    continue
+            else:
+                names = [callee]
+            for name in names:
+                target = resolve(defs, node[0], name)
+                if target is None:
+                    flags[node].add("unknown:" + name)
+                    continue
+                worst = max(worst, depth(target))
+                flags[node] |= flags[target]
+        onstack.discard(node)
+        sz, dyn = size[node]
+        if dyn:
+            flags[node].add("dynamic")
+        memo[node] = sz + worst
+        return memo[node]
+
+    for node in size:
+        depth(node)
+    return size, memo, flags
+
+
+def main(argv):
+    frame = 32  # 无FPU上下文的异常入栈帧；使用FPU的中断为104
+    paths = []
+    indirect = defaultdict(list)
+    args = iter(argv[1:])
+    for a in args:
+        if a == "--frame":
+            frame = int(next(args))
+        elif a == "--indirect":
+            caller, _, targets = next(args).partition("=")
+            indirect[caller] += [t for t in targets.split(",") if t]
+        else:
+            paths.append(a)
+    if not paths:
+        print(__doc__, file=sys.stderr)
+        return 1
+
+    defs, edges = parse(paths)
+    size, memo, flags = analyse(defs, edges, indirect)
+
+    called = set()
+    unresolved = set()
+    for (unit, caller), callees in edges.items():
+        for callee in callees:
+            if callee == INDIRECT:
+                names = indirect_targets(indirect, caller)
+                if names is None:
+                    unresolved.add(caller)
+                    names = []
+            else:
+                names = [callee]
+            for name in names:
+                target = resolve(defs, unit, name)
+                if target:
+                    called.add(target)
+
+    for node in sorted(memo, key=lambda n: -memo[n]):
+        name = node[1]
+        print("stack.%s.self=%d" % (name, size[node][0]))
+        print("stack.%s.max=%d" % (name, memo[node]))
+        if flags[node]:
+            print("stack.%s.flags=%s" % (name, ",".join(sorted(flags[node]))))
+
+    roots = [n for n in memo if n not in called]
+    isrs = [n for n in roots if n[1].endswith("Handler")]
+    threads = [n for n in roots if n not in isrs]
+    thread_max = max([memo[n] for n in threads] or [0])
+    isr_total = 0
+    for n in sorted(isrs, key=lambda n: n[1]):
+        print("stack.isr.%s=%d" % (n[1], memo[n] + frame))
+        isr_total += memo[n] + frame
+    print("stack.thread_max=%d" % thread_max)
+    print("stack.unresolved_indirect=%s" % (",".join(sorted(unresolved)) or "none"))
+    print("stack.total_estimate=%d" % (thread_max + isr_total))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,80 @@
+/**
+ * @file startup_gcc.c
+ * @brief 基准固件的GCC启动代码与向量表
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * Keil工程使用 startup_stm32f40_41xxx.s，此文件仅供 arm-none-eabi-gcc 构建基准固件。
+ */
+
+#include "stm32f4xx.h"
+
+extern uint32_t _sidata, _sdata, _edata, _sbss, _ebss, _estack; ///< 链接脚本定义
+extern uint32_t _siccmdata, _sccmdata, _eccmdata, _sccmbss, _eccmbss;
+
+extern int main(void);
+
+void Reset_Handler(void)
+{
+  uint32_t *src = &_sidata;
+  uint32_t *dst = &_sdata;
+
+  while (dst < &_edata)
+  {
+    *dst++ = *src++;
+  }
+  for (dst = &_sbss; dst < &_ebss;)
+  {
+    *dst++ = 0;
+  }
+
+  // CCM（复位后时钟默认开启）
+  for (src = &_siccmdata, dst = &_sccmdata; dst < &_eccmdata;)
+  {
+    *dst++ = *src++;
+  }
+  for (dst = &_sccmbss; dst < &_eccmbss;)
+  {
+    *dst++ = 0;
+  }
+
+  SystemInit();
+  main();
+  while (1)
+    ;
+}
+
+void Default_Handler(void)
+{
+  while (1)
+    ;
+}
+
+void NMI_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void HardFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void MemManage_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void BusFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void UsageFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SVC_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void DebugMon_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void PendSV_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SysTick_Handler(void) __attribute__((weak, alias("Default_Handler")));
+
+/**
+ * @brief 向量表：16个内核异常 + 82个外设中断（基准不使用外设中断）
+ */
+__attribute__((section(".isr_vector"), used)) void (*const __Vectors[16 + 82])(void) = {
+    [0] = (void (*)(void))&_estack,
+    [1] = Reset_Handler,
+    [2] = NMI_Handler,
+    [3] = HardFault_Handler,
+    [4] = MemManage_Handler,
+    [5] = BusFault_Handler,
+    [6] = UsageFault_Handler,
+    [11] = SVC_Handler,
+    [12] = DebugMon_Handler,
+    [14] = PendSV_Handler,
+    [15] = SysTick_Handler,
+    [16 ... 16 + 81] = Default_Handler,
+};
@@ -38,9 +38,15 @@
 ;   <o> Stack Size (in Bytes) <0x0-0xFFFFFFFF:8>
 ; </h>
 
+; STACK and HEAP are placed in CCM RAM (0x10000000) by Project/stm32f407_ccm.sct;
+; the CCM execution region is initialised by __main, or by Reset_Handler when
+; FAST_BOOT is defined in the assembler options.
 Stack_Size      EQU     0x00000400
 
                 AREA    STACK, NOINIT, READWRITE, ALIGN=3
+                EXPORT  __stack_base
+                EXPORT  __initial_sp
+__stack_base
 Stack_Mem       SPACE   Stack_Size
 __initial_sp
 
@@ -49,9 +55,13 @@ __initial_sp
 ;   <o>  Heap Size (in Bytes) <0x0-0xFFFFFFFF:8>
 ; </h>
 
-Heap_Size       EQU     0x00000200
+; The C heap is not used: dynamic buffers come from the O(1) block pools in
+; User/myPool, which are deterministic and safe to use from interrupts.
+Heap_Size       EQU     0x00000000
 
                 AREA    HEAP, NOINIT, READWRITE, ALIGN=3
+                EXPORT  __heap_base
+                EXPORT  __heap_limit
 __heap_base
 Heap_Mem        SPACE   Heap_Size
 __heap_limit
@@ -177,14 +187,147 @@ __Vectors_Size  EQU  __Vectors_End - __Vectors
 Reset_Handler    PROC
                  EXPORT  Reset_Handler             [WEAK]
         IMPORT  SystemInit
-        IMPORT  __main
+        IMPORT  BOOT_Stamps
+
+; Start DWT->CYCCNT at reset so that myBoot can report boot phases
+                 LDR     R0, =0xE000EDFC           ; CoreDebug->DEMCR
+                 LDR     R1, [R0]
+                 ORR     R1, R1, #0x01000000       ; TRCENA
+                 STR     R1, [R0]
+                 LDR     R0, =0xE0001000           ; DWT->CTRL
+                 MOVS    R1, #0
+                 STR     R1, [R0, #4]              ; DWT->CYCCNT = 0
+                 LDR     R1, [R0]
+                 ORR     R1, R1, #1                ; CYCCNTENA
+                 STR     R1, [R0]
+
+; Paint stack and heap with STACK_PAINT for high-water measurement (myStack.h).
+; Nothing has been pushed yet, so the whole stack can be painted. Both sizes
+; are multiples of 8.
+                 LDR     R0, =0xA5A5A5A5
+                 MOV     R1, R0
+                 LDR     R2, =Stack_Mem
+                 LDR     R3, =__initial_sp
+Paint_Stack      STMIA   R2!, {R0, R1}
+                 CMP     R2, R3
+                 BLO     Paint_Stack
+                 LDR     R2, =Heap_Mem
+                 LDR     R3, =__heap_limit
+Paint_Heap       CMP     R2, R3
+                 BHS     Paint_Done
+                 STMIA   R2!, {R0, R1}
+                 B       Paint_Heap
+Paint_Done
 
                  LDR     R0, =SystemInit
                  BLX     R0
+
+                 LDR     R0, =0xE0001004           ; DWT->CYCCNT
+                 LDR     R1, [R0]
+                 LDR     R0, =BOOT_Stamps
+                 STR     R1, [R0]                  ; BOOT_Stamps[BOOT_STAMP_SYSINIT]
+
+                 IF      :DEF:FAST_BOOT
+; Initialise the regions of Project/stm32f407_ccm.sct directly and enter main
+; without __main. Requires MicroLIB (or no C library init) and the linker
+; option --datacompressor=off. UNINIT regions (.bss.noinit, stack, heap)
+; are left untouched.
+        IMPORT  main
+        IMPORT  |Load$$ER_RAMFUNC$$Base|
+        IMPORT  |Image$$ER_RAMFUNC$$Base|
+        IMPORT  |Image$$ER_RAMFUNC$$Limit|
+        IMPORT  |Load$$RW_IRAM1$$Base|
+        IMPORT  |Image$$RW_IRAM1$$Base|
+        IMPORT  |Image$$RW_IRAM1$$RW$$Limit|
+        IMPORT  |Image$$RW_IRAM1$$ZI$$Base|
+        IMPORT  |Image$$RW_IRAM1$$ZI$$Limit|
+        IMPORT  |Load$$RW_CCM$$Base|
+        IMPORT  |Image$$RW_CCM$$Base|
+        IMPORT  |Image$$RW_CCM$$RW$$Limit|
+        IMPORT  |Image$$RW_CCM$$ZI$$Base|
+        IMPORT  |Image$$RW_CCM$$ZI$$Limit|
+
+                 LDR     R0, =|Load$$ER_RAMFUNC$$Base|
+                 LDR     R1, =|Image$$ER_RAMFUNC$$Base|
+                 LDR     R2, =|Image$$ER_RAMFUNC$$Limit|
+                 BL      FastBoot_Copy
+                 LDR     R0, =|Load$$RW_IRAM1$$Base|
+                 LDR     R1, =|Image$$RW_IRAM1$$Base|
+                 LDR     R2, =|Image$$RW_IRAM1$$RW$$Limit|
+                 BL      FastBoot_Copy
+                 LDR     R1, =|Image$$RW_IRAM1$$ZI$$Base|
+                 LDR     R2, =|Image$$RW_IRAM1$$ZI$$Limit|
+                 BL      FastBoot_Zero
+                 LDR     R0, =|Load$$RW_CCM$$Base|
+                 LDR     R1, =|Image$$RW_CCM$$Base|
+                 LDR     R2, =|Image$$RW_CCM$$RW$$Limit|
+                 BL      FastBoot_Copy
+                 LDR     R1, =|Image$$RW_CCM$$ZI$$Base|
+                 LDR     R2, =|Image$$RW_CCM$$ZI$$Limit|
+                 BL      FastBoot_Zero
+
+                 LDR     R0, =main
+                 BX      R0
+                 ELSE
+        IMPORT  __main
                  LDR     R0, =__main
                  BX      R0
+                 ENDIF
+                 ENDP
+
+                 IF      :DEF:FAST_BOOT
+; Copy [R1, R2) from R0 in 32-byte LDM/STM bursts, then words, then bytes.
+; Clobbers R0-R11.
+FastBoot_Copy    PROC
+FB_Copy32        SUB     R3, R2, R1
+                 CMP     R3, #32
+                 BLO     FB_Copy4
+                 LDMIA   R0!, {R4-R11}
+                 STMIA   R1!, {R4-R11}
+                 B       FB_Copy32
+FB_Copy4         CMP     R3, #4
+                 BLO     FB_Copy1
+                 LDR     R4, [R0], #4
+                 STR     R4, [R1], #4
+                 SUB     R3, R3, #4
+                 B       FB_Copy4
+FB_Copy1         CBZ     R3, FB_CopyDone
+                 LDRB    R4, [R0], #1
+                 STRB    R4, [R1], #1
+                 SUB     R3, R3, #1
+                 B       FB_Copy1
+FB_CopyDone      BX      LR
                  ENDP
 
+; Zero [R1, R2) in 32-byte STM bursts, then words, then bytes.
+; Clobbers R1-R11.
+FastBoot_Zero    PROC
+                 MOVS    R4, #0
+                 MOVS    R5, #0
+                 MOVS    R6, #0
+                 MOVS    R7, #0
+                 MOV     R8, R4
+                 MOV     R9, R4
+                 MOV     R10, R4
+                 MOV     R11, R4
+FB_Zero32        SUB     R3, R2, R1
+                 CMP     R3, #32
+                 BLO     FB_Zero4
+                 STMIA   R1!, {R4-R11}
+                 B       FB_Zero32
+FB_Zero4         CMP     R3, #4
+                 BLO     FB_Zero1
+                 STR     R4, [R1], #4
+                 SUB     R3, R3, #4
+                 B       FB_Zero4
+FB_Zero1         CBZ     R3, FB_ZeroDone
+                 STRB    R4, [R1], #1
+                 SUB     R3, R3, #1
+                 B       FB_Zero1
+FB_ZeroDone      BX      LR
+                 ENDP
+                 ENDIF
+
 ; Dummy Exception Handlers (infinite loops which can be modified)
 
 NMI_Handler     PROC
@@ -408,10 +551,6 @@ FPU_IRQHandler
 ;*******************************************************************************
                  IF      :DEF:__MICROLIB
                 
-                 EXPORT  __initial_sp
-                 EXPORT  __heap_base
-                 EXPORT  __heap_limit
-                
                  ELSE
                 
                  IMPORT  __use_two_region_memory
@@ -366,6 +366,16 @@
 /******************************************************************************/
 
 /************************* PLL Parameters *************************************/
+#if defined(STM32F40_41xxx)
+/* PLL_M/N/P/Q are solved at compile time from HSE_VALUE and CLOCK_SYSCLK_HZ /
+   CLOCK_USB_HZ, with range checks, by the project-supplied stm32f4xx_pll_conf.h
+   (found on the include path, like stm32f4xx_conf.h) */
+#include "stm32f4xx_pll_conf.h"
+#define PLL_M      CLOCK_PLL_M
+#define PLL_N      CLOCK_PLL_N
+#define PLL_P      CLOCK_PLL_P
+#define PLL_Q      CLOCK_PLL_Q
+#else
 #if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F401xx) || defined(STM32F469_479xx)
  /* PLL_VCO = (HSE_VALUE or HSI_VALUE / PLL_M) * PLL_N */
  #define PLL_M      8
@@ -414,6 +424,7 @@
 /* SYSCLK = PLL_VCO / PLL_P */
 #define PLL_P      4   
 #endif /* STM32F410xx || STM32F411xE || STM32F412xG || STM32F413_423xx */
+#endif /* STM32F40_41xxx */
 
 /******************************************************************************/
 
@@ -434,7 +445,7 @@
   */
 
 #if defined(STM32F40_41xxx)
-  uint32_t SystemCoreClock = 168000000;
+  uint32_t SystemCoreClock = CLOCK_SYSCLK_HZ;
 #endif /* STM32F40_41xxx */
 
 #if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
@@ -943,6 +943,8 @@ void        RCC_HCLKConfig(uint32_t RCC_SYSCLK);
 void        RCC_PCLK1Config(uint32_t RCC_HCLK);
 void        RCC_PCLK2Config(uint32_t RCC_HCLK);
 void        RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks);
+void        RCC_ClocksCacheInvalidate(void);
+uint32_t    RCC_GetClocksGeneration(void);
 
 /* Peripheral clocks configuration functions **********************************/
 void        RCC_RTCCLKConfig(uint32_t RCC_RTCCLKSource);
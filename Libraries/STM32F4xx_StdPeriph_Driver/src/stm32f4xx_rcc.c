@@ -152,7 +152,15 @@
 /* Private variables ---------------------------------------------------------*/
 static __I uint8_t APBAHBPrescTable[16] = {0, 0, 0, 0, 1, 2, 3, 4, 1, 2, 3, 4, 6, 7, 8, 9};
 
+/* Cached result of RCC_GetClocksFreq(), valid while RCC_ClocksCacheGen equals
+   RCC_ClocksGen + 1 (0 means empty). Every clock configuration function of
+   this driver increments RCC_ClocksGen. */
+static RCC_ClocksTypeDef RCC_ClocksCache;
+static __IO uint32_t RCC_ClocksGen = 0;
+static __IO uint32_t RCC_ClocksCacheGen = 0;
+
 /* Private function prototypes -----------------------------------------------*/
+static void RCC_ComputeClocksFreq(RCC_ClocksTypeDef* RCC_Clocks);
 /* Private functions ---------------------------------------------------------*/
 
 /** @defgroup RCC_Private_Functions
@@ -259,6 +267,8 @@ void RCC_DeInit(void)
   /* Disable LPTIM and FMPI2C clock prescalers selection, only available for STM32F410xx and STM32F413_423xx devices */
   RCC->DCKCFGR2 = 0x00000000;
 #endif /* STM32F410xx || STM32F413_423xx */  
+
+  RCC_ClocksCacheInvalidate();
 }
 
 /**
@@ -497,6 +507,8 @@ void RCC_PLLConfig(uint32_t RCC_PLLSource, uint32_t PLLM, uint32_t PLLN, uint32_
   
   RCC->PLLCFGR = PLLM | (PLLN << 6) | (((PLLP >> 1) -1) << 16) | (RCC_PLLSource) |
                  (PLLQ << 24) | (PLLR << 28);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F410xx || STM32F412xG || STM32F413_423xx || STM32F446xx || STM32F469_479xx */
 
@@ -547,6 +559,8 @@ void RCC_PLLConfig(uint32_t RCC_PLLSource, uint32_t PLLM, uint32_t PLLN, uint32_
 
   RCC->PLLCFGR = PLLM | (PLLN << 6) | (((PLLP >> 1) -1) << 16) | (RCC_PLLSource) |
                  (PLLQ << 24);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F40_41xxx || STM32F427_437xx || STM32F429_439xx || STM32F401xx || STM32F411xE */
 
@@ -565,6 +579,7 @@ void RCC_PLLCmd(FunctionalState NewState)
   /* Check the parameters */
   assert_param(IS_FUNCTIONAL_STATE(NewState));
   *(__IO uint32_t *) CR_PLLON_BB = (uint32_t)NewState;
+  RCC_ClocksCacheInvalidate();
 }
 
 #if defined(STM32F40_41xxx) || defined(STM32F401xx)
@@ -597,6 +612,8 @@ void RCC_PLLI2SConfig(uint32_t PLLI2SN, uint32_t PLLI2SR)
   assert_param(IS_RCC_PLLI2SR_VALUE(PLLI2SR));
 
   RCC->PLLI2SCFGR = (PLLI2SN << 6) | (PLLI2SR << 28);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F40_41xxx || STM32F401xx */
 
@@ -636,6 +653,8 @@ void RCC_PLLI2SConfig(uint32_t PLLI2SN, uint32_t PLLI2SR, uint32_t PLLI2SM)
   assert_param(IS_RCC_PLLI2SR_VALUE(PLLI2SR));
 
   RCC->PLLI2SCFGR = (PLLI2SN << 6) | (PLLI2SR << 28) | PLLI2SM;
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F411xE */
 
@@ -672,6 +691,8 @@ void RCC_PLLI2SConfig(uint32_t PLLI2SN, uint32_t PLLI2SQ, uint32_t PLLI2SR)
   assert_param(IS_RCC_PLLI2SR_VALUE(PLLI2SR));
 
   RCC->PLLI2SCFGR = (PLLI2SN << 6) | (PLLI2SQ << 24) | (PLLI2SR << 28);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F427_437xx || STM32F429_439xx || STM32F469_479xx */
 
@@ -720,6 +741,8 @@ void RCC_PLLI2SConfig(uint32_t PLLI2SM, uint32_t PLLI2SN, uint32_t PLLI2SP, uint
   assert_param(IS_RCC_PLLI2SR_VALUE(PLLI2SR));
 
   RCC->PLLI2SCFGR =  PLLI2SM | (PLLI2SN << 6) | (((PLLI2SP >> 1) -1) << 16) | (PLLI2SQ << 24) | (PLLI2SR << 28);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F412xG || STM32F413_423xx || STM32F446xx */
 
@@ -734,6 +757,7 @@ void RCC_PLLI2SCmd(FunctionalState NewState)
   /* Check the parameters */
   assert_param(IS_FUNCTIONAL_STATE(NewState));
   *(__IO uint32_t *) CR_PLLI2SON_BB = (uint32_t)NewState;
+  RCC_ClocksCacheInvalidate();
 }
 
 #if defined(STM32F469_479xx)
@@ -771,6 +795,8 @@ void RCC_PLLSAIConfig(uint32_t PLLSAIN, uint32_t PLLSAIP, uint32_t PLLSAIQ, uint
   assert_param(IS_RCC_PLLSAIR_VALUE(PLLSAIR));
 
   RCC->PLLSAICFGR = (PLLSAIN << 6) | (((PLLSAIP >> 1) -1) << 16) | (PLLSAIQ << 24) | (PLLSAIR << 28);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F469_479xx */
 
@@ -812,6 +838,8 @@ void RCC_PLLSAIConfig(uint32_t PLLSAIM, uint32_t PLLSAIN, uint32_t PLLSAIP, uint
   assert_param(IS_RCC_PLLSAIQ_VALUE(PLLSAIQ));
 
   RCC->PLLSAICFGR = PLLSAIM | (PLLSAIN << 6) | (((PLLSAIP >> 1) -1) << 16)  | (PLLSAIQ << 24);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F446xx */
 
@@ -846,6 +874,8 @@ void RCC_PLLSAIConfig(uint32_t PLLSAIN, uint32_t PLLSAIQ, uint32_t PLLSAIR)
   assert_param(IS_RCC_PLLSAIQ_VALUE(PLLSAIQ));
   
   RCC->PLLSAICFGR = (PLLSAIN << 6) | (PLLSAIQ << 24) | (PLLSAIR << 28);
+
+  RCC_ClocksCacheInvalidate();
 }
 #endif /* STM32F40_41xxx || STM32F427_437xx || STM32F429_439xx || STM32F401xx || STM32F411xE */
 
@@ -1163,6 +1193,8 @@ void RCC_SYSCLKConfig(uint32_t RCC_SYSCLKSource)
 
   /* Store the new value */
   RCC->CFGR = tmpreg;
+
+  RCC_ClocksCacheInvalidate();
 }
 
 /**
@@ -1217,6 +1249,8 @@ void RCC_HCLKConfig(uint32_t RCC_SYSCLK)
 
   /* Store the new value */
   RCC->CFGR = tmpreg;
+
+  RCC_ClocksCacheInvalidate();
 }
 
 /**
@@ -1248,6 +1282,8 @@ void RCC_PCLK1Config(uint32_t RCC_HCLK)
 
   /* Store the new value */
   RCC->CFGR = tmpreg;
+
+  RCC_ClocksCacheInvalidate();
 }
 
 /**
@@ -1279,6 +1315,8 @@ void RCC_PCLK2Config(uint32_t RCC_HCLK)
 
   /* Store the new value */
   RCC->CFGR = tmpreg;
+
+  RCC_ClocksCacheInvalidate();
 }
 
 /**
@@ -1311,10 +1349,67 @@ void RCC_PCLK2Config(uint32_t RCC_HCLK)
   * @note   Each time SYSCLK, HCLK, PCLK1 and/or PCLK2 clock changes, this function
   *         must be called to update the structure's field. Otherwise, any
   *         configuration based on this function will be incorrect.
+  * @note   The result is cached and returned by copy until one of the clock
+  *         configuration functions of this driver is called. Code that writes
+  *         RCC->CFGR/PLLCFGR directly must call RCC_ClocksCacheInvalidate().
+  *         The cache may be read from interrupt handlers.
   *    
   * @retval None
   */
 void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks)
+{
+  uint32_t gen = RCC_ClocksGen;
+
+  if (RCC_ClocksCacheGen == gen + 1)
+  {
+    *RCC_Clocks = RCC_ClocksCache;
+    if (RCC_ClocksGen == gen)
+    {
+      return;
+    }
+  }
+
+  RCC_ComputeClocksFreq(RCC_Clocks);
+
+  /* Do not cache while a SYSCLK switch is still in progress (SWS != SW) */
+  if ((RCC_ClocksGen == gen) && (((RCC->CFGR & RCC_CFGR_SW) << 2) == (RCC->CFGR & RCC_CFGR_SWS)))
+  {
+    RCC_ClocksCache = *RCC_Clocks;
+    RCC_ClocksCacheGen = gen + 1;
+  }
+}
+
+/**
+  * @brief  Invalidates the frequencies cached by RCC_GetClocksFreq().
+  * @note   Called by the clock configuration functions of this driver; call it
+  *         after changing RCC->CFGR, RCC->PLLCFGR or RCC->PLLI2SCFGR directly.
+  * @param  None
+  * @retval None
+  */
+void RCC_ClocksCacheInvalidate(void)
+{
+  RCC_ClocksGen++;
+}
+
+/**
+  * @brief  Returns a counter incremented on every clock tree change.
+  * @note   Lets other clock caches detect that they are stale with one compare.
+  * @param  None
+  * @retval Clock tree generation
+  */
+uint32_t RCC_GetClocksGeneration(void)
+{
+  return RCC_ClocksGen;
+}
+
+/**
+  * @brief  Computes the frequencies of SYSCLK, HCLK, PCLK1 and PCLK2 from the
+  *         RCC registers.
+  * @param  RCC_Clocks: pointer to a RCC_ClocksTypeDef structure which will hold
+  *          the clocks frequencies.
+  * @retval None
+  */
+static void RCC_ComputeClocksFreq(RCC_ClocksTypeDef* RCC_Clocks)
 {
   uint32_t tmp = 0, presc = 0, pllvco = 0, pllp = 2, pllsource = 0, pllm = 2;
 #if defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx)  
@@ -2065,6 +2160,8 @@ void RCC_TIMCLKPresConfig(uint32_t RCC_TIMCLKPrescaler)
   assert_param(IS_RCC_TIMCLK_PRESCALER(RCC_TIMCLKPrescaler));
 
   *(__IO uint32_t *) DCKCFGR_TIMPRE_BB = RCC_TIMCLKPrescaler;
+
+  RCC_ClocksCacheInvalidate();
 }
 
 /**
@@ -0,0 +1,111 @@
+/**
+ * @file core_cmFunc.h
+ * @brief 主机仿真：替换CMSIS内核寄存器访问头文件
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * PRIMASK/BASEPRI/IPSR由仿真器维护，开中断时仿真器立即分发挂起的中断。
+ */
+
+#ifndef __CORE_CMFUNC_H
+#define __CORE_CMFUNC_H
+
+#include "sim_cpu.h"
+
+static inline void __enable_irq(void)
+{
+  SIM_SetPrimask(0);
+}
+
+static inline void __disable_irq(void)
+{
+  SIM_SetPrimask(1);
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+  return SIM_GetPrimask();
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+  SIM_SetPrimask(priMask & 1);
+}
+
+static inline uint32_t __get_BASEPRI(void)
+{
+  return SIM_GetBasepri();
+}
+
+static inline void __set_BASEPRI(uint32_t value)
+{
+  SIM_SetBasepri(value & 0xFF);
+}
+
+static inline void __set_BASEPRI_MAX(uint32_t value)
+{
+  uint32_t cur = SIM_GetBasepri();
+
+  value &= 0xFF;
+  if (value != 0 && (cur == 0 || value < cur))
+  {
+    SIM_SetBasepri(value);
+  }
+}
+
+/**
+ * @brief 主机上没有MSP；默认返回0，使栈探针判定SP不在固件栈区而不生效，
+ *        测试可用 SIM_SetMsp() 指定一个栈区内的地址
+ */
+static inline uint32_t __get_MSP(void)
+{
+  return SIM_GetMsp();
+}
+
+static inline uint32_t __get_IPSR(void)
+{
+  return SIM_GetIPSR();
+}
+
+static inline uint32_t __get_xPSR(void)
+{
+  return SIM_GetIPSR();
+}
+
+static inline uint32_t __get_APSR(void)
+{
+  return 0;
+}
+
+static inline uint32_t __get_CONTROL(void)
+{
+  return 0;
+}
+
+static inline void __set_CONTROL(uint32_t control)
+{
+  (void)control;
+}
+
+static inline uint32_t __get_FAULTMASK(void)
+{
+  return 0;
+}
+
+static inline void __set_FAULTMASK(uint32_t faultMask)
+{
+  (void)faultMask;
+}
+
+static inline uint32_t __get_FPSCR(void)
+{
+  return 0;
+}
+
+static inline void __set_FPSCR(uint32_t fpscr)
+{
+  (void)fpscr;
+}
+
+#endif
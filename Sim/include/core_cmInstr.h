@@ -0,0 +1,100 @@
+/**
+ * @file core_cmInstr.h
+ * @brief 主机仿真：替换CMSIS内核指令访问头文件
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 仿真构建时 Sim/include 位于 Libraries/CMSIS 之前，core_cm4.h 通过
+ * <core_cmInstr.h> 包含到本文件。屏障映射为编译器/主机内存屏障，
+ * WFI/WFE进入仿真器的空闲推进，位操作用可移植C实现。
+ */
+
+#ifndef __CORE_CMINSTR_H
+#define __CORE_CMINSTR_H
+
+#include "sim_cpu.h"
+
+#define __NOP() ((void)0)
+#define __WFI() SIM_WaitForInterrupt()
+#define __WFE() SIM_WaitForInterrupt()
+#define __SEV() ((void)0)
+#define __ISB() __sync_synchronize()
+#define __DSB() __sync_synchronize()
+#define __DMB() __sync_synchronize()
+#define __BKPT(value) __builtin_trap()
+#define __CLREX() ((void)0)
+
+static inline uint32_t __REV(uint32_t value)
+{
+  return __builtin_bswap32(value);
+}
+
+static inline uint32_t __REV16(uint32_t value)
+{
+  return ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8);
+}
+
+static inline int32_t __REVSH(int32_t value)
+{
+  return (int16_t)__builtin_bswap16((uint16_t)value);
+}
+
+static inline uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+  op2 &= 31;
+  return op2 ? (op1 >> op2) | (op1 << (32 - op2)) : op1;
+}
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0;
+  int i;
+
+  for (i = 0; i < 32; i++)
+  {
+    result = (result << 1) | (value & 1);
+    value >>= 1;
+  }
+  return result;
+}
+
+static inline uint8_t __CLZ(uint32_t value)
+{
+  return value ? (uint8_t)__builtin_clz(value) : 32;
+}
+
+static inline uint32_t __LDREXW(volatile uint32_t *addr)
+{
+  return *addr;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+  *addr = value;
+  return 0;
+}
+
+static inline uint8_t __LDREXB(volatile uint8_t *addr)
+{
+  return *addr;
+}
+
+static inline uint32_t __STREXB(uint8_t value, volatile uint8_t *addr)
+{
+  *addr = value;
+  return 0;
+}
+
+static inline uint16_t __LDREXH(volatile uint16_t *addr)
+{
+  return *addr;
+}
+
+static inline uint32_t __STREXH(uint16_t value, volatile uint16_t *addr)
+{
+  *addr = value;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,12 @@
+/**
+ * @file core_cmSimd.h
+ * @brief 主机仿真：替换CMSIS SIMD头文件（工程未使用SIMD内建函数）
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#ifndef __CORE_CMSIMD_H
+#define __CORE_CMSIMD_H
+
+#endif
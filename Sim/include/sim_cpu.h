@@ -0,0 +1,22 @@
+/**
+ * @file sim_cpu.h
+ * @brief 主机仿真：Cortex-M内核状态接口（供替换后的CMSIS内核头文件使用）
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#ifndef _SIM_CPU_H_
+#define _SIM_CPU_H_
+
+#include <stdint.h>
+
+uint32_t SIM_GetPrimask(void);
+void SIM_SetPrimask(uint32_t primask);
+uint32_t SIM_GetBasepri(void);
+void SIM_SetBasepri(uint32_t basepri);
+uint32_t SIM_GetMsp(void);
+uint32_t SIM_GetIPSR(void);
+void SIM_WaitForInterrupt(void);
+
+#endif
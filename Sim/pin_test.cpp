@@ -0,0 +1,122 @@
+/**
+ * @file pin_test.cpp
+ * @brief myPin.hpp 编译期引脚模板的主机测试（C++11）
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 与固件目标文件、仿真器一起链接：Pin<>::set/clear/write/read 各只有一次
+ * 寄存器访问，toggle 为一次ODR读取加一次BSRR写入；myInit.h 的引脚宏在C++中
+ * 解析为类型别名，端口与掩码和C编译的 BOARD_Pins[] 一致。
+ */
+
+#include <stdio.h>
+
+#include "stm32f4xx.h"
+#include "myInit/myInit.h"
+#include "myPin/myPin.hpp"
+
+extern "C"
+{
+#include "sim.h"
+}
+
+static unsigned pin_test_fail;
+
+/**
+ * @brief 检查条件，失败时输出所在行
+ */
+#define SIM_CHECK(cond) SIM_Check((cond) != 0, #cond, __LINE__)
+
+static void SIM_Check(bool ok, const char *expr, int line)
+{
+  if (!ok)
+  {
+    pin_test_fail++;
+    fprintf(stderr, "pin_test.cpp:%d: check failed: %s\n", line, expr);
+  }
+}
+
+/**
+ * @brief 一次调用的寄存器访问次数
+ */
+template <typename F>
+static uint64_t Test_Accesses(F fn)
+{
+  SIM_Meter_t m;
+
+  SIM_MeterBegin(&m);
+  fn();
+  SIM_MeterEnd(&m);
+  return m.accesses;
+}
+
+/**
+ * @brief 宏解析到的别名与C描述表一致
+ */
+template <typename P>
+static void Test_Alias(uint32_t id, GPIO_TypeDef *port, uint16_t mask)
+{
+  SIM_CHECK(port == P::port::regs() && mask == P::mask);
+  SIM_CHECK(BOARD_Pins[id].port == P::port::regs());
+  SIM_CHECK(BOARD_Pins[id].mask == P::mask);
+  SIM_CHECK(BOARD_Pins[id].active_low == P::active_low);
+}
+
+static void Test_Pin(void)
+{
+  typedef pin::Led0 Led;
+  typedef pin::Key0 Key;
+  static_assert(LED0_PIN == GPIO_Pin_9, "LED0_PIN must stay a constant expression");
+
+  Test_Alias<pin::Led0>(BOARD_LED0, LED0_PORT, LED0_PIN);
+  Test_Alias<pin::Led1>(BOARD_LED1, LED1_PORT, LED1_PIN);
+  Test_Alias<pin::Led2>(BOARD_LED2, LED2_PORT, LED2_PIN);
+  Test_Alias<pin::Led3>(BOARD_LED3, LED3_PORT, LED3_PIN);
+  Test_Alias<pin::Key0>(BOARD_KEY0, KEY0_PORT, KEY0_PIN);
+  Test_Alias<pin::Key1>(BOARD_KEY1, KEY1_PORT, KEY1_PIN);
+  Test_Alias<pin::Key2>(BOARD_KEY2, KEY2_PORT, KEY2_PIN);
+  Test_Alias<pin::Key3>(BOARD_KEY3, KEY3_PORT, KEY3_PIN);
+  Test_Alias<pin::Beep0>(BOARD_BEEP0, BEEP0_PORT, BEEP0_PIN);
+
+  BOARD_Init();
+
+  // 输出：每次操作一次BSRR写入
+  SIM_CHECK(Test_Accesses(Led::set) == 1);
+  SIM_CHECK(GPIOF->ODR & GPIO_Pin_9);
+  SIM_CHECK(Test_Accesses(Led::clear) == 1);
+  SIM_CHECK(!(GPIOF->ODR & GPIO_Pin_9));
+  SIM_CHECK(Test_Accesses([] { Led::write(true); }) == 1);
+  SIM_CHECK(GPIOF->ODR & GPIO_Pin_9);
+  SIM_CHECK(Test_Accesses(Led::on) == 1);
+  SIM_CHECK(!(GPIOF->ODR & GPIO_Pin_9));
+  SIM_CHECK(PIN_Read(BOARD_LED0) == 1);
+
+  // 翻转：一次ODR读取加一次BSRR写入，不影响同端口的其他引脚
+  GPIOF->ODR |= GPIO_Pin_10;
+  SIM_CHECK(Test_Accesses(Led::toggle) == 2);
+  SIM_CHECK((GPIOF->ODR & (GPIO_Pin_9 | GPIO_Pin_10)) == (GPIO_Pin_9 | GPIO_Pin_10));
+  SIM_CHECK(Test_Accesses(Led::toggle) == 2);
+  SIM_CHECK((GPIOF->ODR & (GPIO_Pin_9 | GPIO_Pin_10)) == GPIO_Pin_10);
+
+  // 输入：一次IDR读取；未按下时外部上拉为高电平
+  bool level = false;
+  SIM_CHECK(Test_Accesses([&level] { level = Key::read(); }) == 1);
+  SIM_CHECK(level);
+  SIM_CHECK(!Key::isOn());
+  SIM_CHECK(Key::isOn() == (PIN_Read(BOARD_KEY0) != 0));
+}
+
+int main(void)
+{
+  SIM_End end;
+
+  if (SIM_Init() != 0)
+  {
+    return 1;
+  }
+  SystemInit();
+  end = SIM_Run(Test_Pin);
+  printf("test.pin.ok=%d\n", end == SIM_END_RETURN && pin_test_fail == 0);
+  return end != SIM_END_RETURN || pin_test_fail != 0;
+}
@@ -0,0 +1,2243 @@
+/**
+ * @file sim.c
+ * @brief 主机端外设寄存器仿真器实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#define _GNU_SOURCE
+#include <setjmp.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "stm32f4xx.h"
+#include "sim.h"
+#include "myStack/myStack.h"
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "the register simulator relies on x86-64 Linux page faults and single-stepping"
+#endif
+
+#define SIM_PAGE 4096UL
+#define SIM_STEP_MAX 4       ///< 一条指令最多同时访问的外设页数
+#define SIM_IRQ_NUM 82       ///< STM32F40x外部中断数量
+#define SIM_EXC_SYSTICK 15   ///< SysTick异常号
+#define SIM_EXC_IRQ0 16      ///< 外部中断0的异常号
+#define SIM_PRIO_THREAD 0x100 ///< 线程模式的执行优先级（低于任何异常）
+#define SIM_EFLAGS_TF 0x100  ///< x86单步标志
+#define SIM_LSE_HZ 32768     ///< LSE晶振频率
+#define SIM_LSI_HZ 32000     ///< LSI标称频率
+#define SIM_EXTI_RTC_WKUP (1UL << 22) ///< RTC唤醒事件所在EXTI线
+
+/* ------------------------------------------------------------------------ */
+/*                               地址空间                                    */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief 映射区域：固定地址视图（陷入）与别名视图（仿真器内部读写）共享同一内存
+ */
+typedef struct
+{
+  uint32_t base;
+  uint32_t size;
+  uint8_t *alias;
+} SIM_Region_t;
+
+static SIM_Region_t sim_regions[] = {
+    {PERIPH_BASE, 0x00080000, 0},     // APB1/APB2/AHB1
+    {PERIPH_BB_BASE, 0x01000000, 0},  // 外设位带别名区
+    {AHB2PERIPH_BASE, 0x00061000, 0}, // AHB2
+    {0xE0000000, 0x00100000, 0},      // 内核私有外设
+};
+#define SIM_REGION_NUM (sizeof(sim_regions) / sizeof(sim_regions[0]))
+
+static SIM_Region_t *SIM_FindRegion(uintptr_t addr)
+{
+  uint32_t i;
+
+  for (i = 0; i < SIM_REGION_NUM; i++)
+  {
+    if (addr >= sim_regions[i].base && addr - sim_regions[i].base < sim_regions[i].size)
+    {
+      return &sim_regions[i];
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 外设地址在别名视图中的位置
+ */
+static volatile void *SIM_Alias(uint32_t addr)
+{
+  SIM_Region_t *r = SIM_FindRegion(addr);
+
+  return r ? (volatile void *)(r->alias + (addr - r->base)) : 0;
+}
+
+#define SIM_REG32(addr) (*(volatile uint32_t *)SIM_Alias(addr))
+#define SIM_REG8(addr) (*(volatile uint8_t *)SIM_Alias(addr))
+#define SIM_PERIPH_REG(base, type, field) SIM_REG32((base) + offsetof(type, field))
+
+/* ------------------------------------------------------------------------ */
+/*                               外设描述                                    */
+/* ------------------------------------------------------------------------ */
+
+enum
+{
+  SIM_K_OTHER = 0,
+  SIM_K_GPIO,
+  SIM_K_RCC,
+  SIM_K_EXTI,
+  SIM_K_TIM,
+  SIM_K_USART,
+  SIM_K_SYSTICK,
+  SIM_K_NVIC,
+  SIM_K_SCB,
+  SIM_K_DWT,
+  SIM_K_RTC,
+  SIM_K_DMA
+};
+
+/**
+ * @brief 外设描述与访问统计
+ */
+typedef struct
+{
+  const char *name;
+  uint32_t base;
+  uint32_t size;
+  uint8_t kind;
+  uint8_t unit; ///< 同类外设中的编号（GPIO端口、定时器、串口）
+  uint8_t cost; ///< 每次访问的周期数
+  uint64_t reads;
+  uint64_t writes;
+  uint64_t cycles;
+} SIM_Periph_t;
+
+/**
+ * @note 按顺序查找，具体外设在前，总线兜底项在后
+ */
+static SIM_Periph_t sim_periphs[] = {
+    {"GPIOA", GPIOA_BASE, 0x400, SIM_K_GPIO, 0, SIM_COST_AHB},
+    {"GPIOB", GPIOB_BASE, 0x400, SIM_K_GPIO, 1, SIM_COST_AHB},
+    {"GPIOC", GPIOC_BASE, 0x400, SIM_K_GPIO, 2, SIM_COST_AHB},
+    {"GPIOD", GPIOD_BASE, 0x400, SIM_K_GPIO, 3, SIM_COST_AHB},
+    {"GPIOE", GPIOE_BASE, 0x400, SIM_K_GPIO, 4, SIM_COST_AHB},
+    {"GPIOF", GPIOF_BASE, 0x400, SIM_K_GPIO, 5, SIM_COST_AHB},
+    {"GPIOG", GPIOG_BASE, 0x400, SIM_K_GPIO, 6, SIM_COST_AHB},
+    {"GPIOH", GPIOH_BASE, 0x400, SIM_K_GPIO, 7, SIM_COST_AHB},
+    {"GPIOI", GPIOI_BASE, 0x400, SIM_K_GPIO, 8, SIM_COST_AHB},
+    {"RCC", RCC_BASE, 0x400, SIM_K_RCC, 0, SIM_COST_AHB},
+    {"FLASH", FLASH_R_BASE, 0x400, SIM_K_OTHER, 0, SIM_COST_AHB},
+    {"DMA1", DMA1_BASE, 0x400, SIM_K_DMA, 0, SIM_COST_AHB},
+    {"DMA2", DMA2_BASE, 0x400, SIM_K_DMA, 1, SIM_COST_AHB},
+    {"TIM2", TIM2_BASE, 0x400, SIM_K_TIM, 0, SIM_COST_APB1},
+    {"TIM3", TIM3_BASE, 0x400, SIM_K_TIM, 1, SIM_COST_APB1},
+    {"TIM4", TIM4_BASE, 0x400, SIM_K_TIM, 2, SIM_COST_APB1},
+    {"TIM5", TIM5_BASE, 0x400, SIM_K_TIM, 3, SIM_COST_APB1},
+    {"TIM6", TIM6_BASE, 0x400, SIM_K_TIM, 4, SIM_COST_APB1},
+    {"TIM7", TIM7_BASE, 0x400, SIM_K_TIM, 5, SIM_COST_APB1},
+    {"TIM12", TIM12_BASE, 0x400, SIM_K_TIM, 6, SIM_COST_APB1},
+    {"TIM13", TIM13_BASE, 0x400, SIM_K_TIM, 7, SIM_COST_APB1},
+    {"TIM14", TIM14_BASE, 0x400, SIM_K_TIM, 8, SIM_COST_APB1},
+    {"TIM1", TIM1_BASE, 0x400, SIM_K_TIM, 9, SIM_COST_APB2},
+    {"TIM8", TIM8_BASE, 0x400, SIM_K_TIM, 10, SIM_COST_APB2},
+    {"TIM9", TIM9_BASE, 0x400, SIM_K_TIM, 11, SIM_COST_APB2},
+    {"TIM10", TIM10_BASE, 0x400, SIM_K_TIM, 12, SIM_COST_APB2},
+    {"TIM11", TIM11_BASE, 0x400, SIM_K_TIM, 13, SIM_COST_APB2},
+    {"USART1", USART1_BASE, 0x400, SIM_K_USART, 0, SIM_COST_APB2},
+    {"USART2", USART2_BASE, 0x400, SIM_K_USART, 1, SIM_COST_APB1},
+    {"USART3", USART3_BASE, 0x400, SIM_K_USART, 2, SIM_COST_APB1},
+    {"UART4", UART4_BASE, 0x400, SIM_K_USART, 3, SIM_COST_APB1},
+    {"UART5", UART5_BASE, 0x400, SIM_K_USART, 4, SIM_COST_APB1},
+    {"USART6", USART6_BASE, 0x400, SIM_K_USART, 5, SIM_COST_APB2},
+    {"PWR", PWR_BASE, 0x400, SIM_K_OTHER, 0, SIM_COST_APB1},
+    {"RTC", RTC_BASE, 0x400, SIM_K_RTC, 0, SIM_COST_APB1},
+    {"SYSCFG", SYSCFG_BASE, 0x400, SIM_K_OTHER, 0, SIM_COST_APB2},
+    {"EXTI", EXTI_BASE, 0x400, SIM_K_EXTI, 0, SIM_COST_APB2},
+    {"SysTick", SysTick_BASE, 0x10, SIM_K_SYSTICK, 0, SIM_COST_CORE},
+    {"NVIC", NVIC_BASE, 0x400, SIM_K_NVIC, 0, SIM_COST_CORE},
+    {"SCB", SCB_BASE, 0x90, SIM_K_SCB, 0, SIM_COST_CORE},
+    {"DWT", DWT_BASE, 0x1000, SIM_K_DWT, 0, SIM_COST_CORE},
+    {"APB1", APB1PERIPH_BASE, 0x10000, SIM_K_OTHER, 0, SIM_COST_APB1},
+    {"APB2", APB2PERIPH_BASE, 0x10000, SIM_K_OTHER, 0, SIM_COST_APB2},
+    {"AHB1", AHB1PERIPH_BASE, 0x60000, SIM_K_OTHER, 0, SIM_COST_AHB},
+    {"AHB2", AHB2PERIPH_BASE, 0x61000, SIM_K_OTHER, 0, SIM_COST_AHB},
+    {"CORE", 0xE0000000, 0x100000, SIM_K_OTHER, 0, SIM_COST_CORE},
+};
+#define SIM_PERIPH_NUM (sizeof(sim_periphs) / sizeof(sim_periphs[0]))
+
+static SIM_Periph_t *SIM_FindPeriph(uint32_t addr)
+{
+  uint32_t i;
+
+  for (i = 0; i < SIM_PERIPH_NUM; i++)
+  {
+    if (addr - sim_periphs[i].base < sim_periphs[i].size)
+    {
+      return &sim_periphs[i];
+    }
+  }
+  return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               中断向量                                    */
+/* ------------------------------------------------------------------------ */
+
+#define SIM_IRQ_LIST(X)                                                                                     \
+  X(WWDG) X(PVD) X(TAMP_STAMP) X(RTC_WKUP) X(FLASH) X(RCC) X(EXTI0) X(EXTI1) X(EXTI2) X(EXTI3) X(EXTI4)     \
+  X(DMA1_Stream0) X(DMA1_Stream1) X(DMA1_Stream2) X(DMA1_Stream3) X(DMA1_Stream4) X(DMA1_Stream5)           \
+  X(DMA1_Stream6) X(ADC) X(CAN1_TX) X(CAN1_RX0) X(CAN1_RX1) X(CAN1_SCE) X(EXTI9_5) X(TIM1_BRK_TIM9)         \
+  X(TIM1_UP_TIM10) X(TIM1_TRG_COM_TIM11) X(TIM1_CC) X(TIM2) X(TIM3) X(TIM4) X(I2C1_EV) X(I2C1_ER)           \
+  X(I2C2_EV) X(I2C2_ER) X(SPI1) X(SPI2) X(USART1) X(USART2) X(USART3) X(EXTI15_10) X(RTC_Alarm)            \
+  X(OTG_FS_WKUP) X(TIM8_BRK_TIM12) X(TIM8_UP_TIM13) X(TIM8_TRG_COM_TIM14) X(TIM8_CC) X(DMA1_Stream7)       \
+  X(FSMC) X(SDIO) X(TIM5) X(SPI3) X(UART4) X(UART5) X(TIM6_DAC) X(TIM7) X(DMA2_Stream0) X(DMA2_Stream1)    \
+  X(DMA2_Stream2) X(DMA2_Stream3) X(DMA2_Stream4) X(ETH) X(ETH_WKUP) X(CAN2_TX) X(CAN2_RX0) X(CAN2_RX1)    \
+  X(CAN2_SCE) X(OTG_FS) X(DMA2_Stream5) X(DMA2_Stream6) X(DMA2_Stream7) X(USART6) X(I2C3_EV) X(I2C3_ER)    \
+  X(OTG_HS_EP1_OUT) X(OTG_HS_EP1_IN) X(OTG_HS_WKUP) X(OTG_HS) X(DCMI) X(CRYP) X(HASH_RNG) X(FPU)
+
+// 固件未定义的中断处理函数为弱引用，地址为NULL
+#define SIM_DECLARE_IRQ(name) void name##_IRQHandler(void) __attribute__((weak));
+SIM_IRQ_LIST(SIM_DECLARE_IRQ)
+void SysTick_Handler(void) __attribute__((weak));
+
+#define SIM_IRQ_HANDLER(name) name##_IRQHandler,
+static void (*const sim_vectors[SIM_IRQ_NUM])(void) = {SIM_IRQ_LIST(SIM_IRQ_HANDLER)};
+
+/**
+ * @brief Flash向量表，对应启动文件中的 __Vectors
+ * @note 固件以-no-pie链接，函数与变量地址都在低4GB，可按32位存放。
+ *       复位后VTOR指向此表，异常分发按VTOR查表，支持向量表重定位。
+ */
+uint32_t __Vectors[SIM_EXC_IRQ0 + SIM_IRQ_NUM];
+
+/**
+ * @brief 启动文件中的栈/堆符号，供 myStack 链接
+ * @note 固件实际运行在主机栈上，此处的栈区只做填充，不会被使用
+ */
+#define SIM_STACK_SIZE 0x400
+#define SIM_HEAP_SIZE 0
+uint32_t __stack_base[SIM_STACK_SIZE / 4];
+uint32_t __heap_base[SIM_HEAP_SIZE / 4];
+#define SIM_STR_(x) #x
+#define SIM_STR(x) SIM_STR_(x)
+__asm__(".globl __initial_sp\n.set __initial_sp, __stack_base + " SIM_STR(SIM_STACK_SIZE) "\n"
+        ".globl __heap_limit\n.set __heap_limit, __heap_base + " SIM_STR(SIM_HEAP_SIZE) "\n");
+
+#define SIM_IRQ_NAME(name) #name,
+static const char *const sim_irq_names[SIM_IRQ_NUM] = {SIM_IRQ_LIST(SIM_IRQ_NAME)};
+
+/* ------------------------------------------------------------------------ */
+/*                               仿真状态                                    */
+/* ------------------------------------------------------------------------ */
+
+static uint64_t sim_now;    ///< 虚拟周期
+static uint64_t sim_ns;     ///< 虚拟时间（纳秒）
+static uint64_t sim_ns_rem; ///< 周期换算纳秒的余数
+static uint64_t sim_end_ns; ///< 结束时间，0表示不限
+static uint64_t sim_accesses;
+static uint64_t sim_idle_cycles;
+static uint64_t sim_poll_cycles;
+
+static uint32_t sim_primask;
+static uint32_t sim_basepri;
+static uint32_t sim_msp; ///< 测试设置的MSP，0表示不在固件栈区
+static uint32_t sim_nvic_en[3];
+static uint32_t sim_nvic_pend[3];
+static uint32_t sim_nvic_act[3];
+static uint8_t sim_st_pend;
+static uint8_t sim_act_stack[SIM_EXC_IRQ0 + SIM_IRQ_NUM]; ///< 活动异常栈
+static uint8_t sim_act_depth;
+static uint64_t sim_exc_count[SIM_EXC_IRQ0 + SIM_IRQ_NUM];
+
+/**
+ * @brief SysTick状态
+ */
+static struct
+{
+  uint8_t enabled;
+  uint8_t countflag;
+  uint32_t div;  ///< 每个SysTick计数的CPU周期数（1或8）
+  uint64_t zero; ///< 计数值从1减到0的时刻
+} sim_st;
+
+static uint64_t sim_cyc_base; ///< CYCCNT = sim_now - sim_cyc_base
+
+/**
+ * @brief STOP模式状态：期间内核时钟、SysTick、定时器与DWT停止
+ */
+static uint8_t sim_stopped;
+static uint64_t sim_stop_ns; ///< 累计处于STOP的时间
+
+/**
+ * @brief RTC状态（只建模日历秒/亚秒计数与唤醒定时器）
+ */
+static struct
+{
+  uint64_t base_ns;    ///< 退出初始化模式的时刻
+  uint64_t base_units; ///< 该时刻的ck_apre计数（秒 * (PREDIV_S+1)）
+  uint8_t wut_on;      ///< 唤醒定时器运行中
+  uint64_t wut_ns;     ///< 下一次唤醒时刻
+} sim_rtc;
+
+/**
+ * @brief DMA数据流状态（DMA2的存储器到存储器传输与基本定时器更新请求）
+ */
+#define SIM_DMA_STREAMS 16
+#define SIM_DMA_SETUP 6 ///< 数据流启动到第一次传输的周期数
+static struct
+{
+  uint8_t busy;   ///< 传输进行中
+  uint64_t done;  ///< 传输完成时刻
+  uint32_t ndtr0; ///< 使能时的NDTR（循环模式的重装值）
+} sim_dma[SIM_DMA_STREAMS];
+static SIM_DmaHook sim_dma_hook;
+static uint64_t sim_dma_bytes; ///< 累计搬运的字节数
+static uint32_t sim_dma_stale; ///< 事件标志未清除就置位EN的次数
+
+/**
+ * @brief 定时器状态（只建模向上计数与更新事件）
+ */
+typedef struct
+{
+  uint32_t base;
+  IRQn_Type irqn;
+  uint8_t apb2;
+  uint8_t running;
+  uint64_t cpc;      ///< 每个计数的CPU周期数
+  uint64_t t_zero;   ///< 本周期CNT为0的时刻
+  uint64_t next_upd; ///< 下一次更新事件时刻
+} SIM_Tim_t;
+
+static SIM_Tim_t sim_tims[] = {
+    {TIM2_BASE, TIM2_IRQn, 0}, {TIM3_BASE, TIM3_IRQn, 0}, {TIM4_BASE, TIM4_IRQn, 0},
+    {TIM5_BASE, TIM5_IRQn, 0}, {TIM6_BASE, TIM6_DAC_IRQn, 0}, {TIM7_BASE, TIM7_IRQn, 0},
+    {TIM12_BASE, TIM8_BRK_TIM12_IRQn, 0}, {TIM13_BASE, TIM8_UP_TIM13_IRQn, 0},
+    {TIM14_BASE, TIM8_TRG_COM_TIM14_IRQn, 0}, {TIM1_BASE, TIM1_UP_TIM10_IRQn, 1},
+    {TIM8_BASE, TIM8_UP_TIM13_IRQn, 1}, {TIM9_BASE, TIM1_BRK_TIM9_IRQn, 1},
+    {TIM10_BASE, TIM1_UP_TIM10_IRQn, 1}, {TIM11_BASE, TIM1_TRG_COM_TIM11_IRQn, 1},
+};
+#define SIM_TIM_NUM (sizeof(sim_tims) / sizeof(sim_tims[0]))
+
+/**
+ * @brief 串口状态
+ */
+typedef struct
+{
+  uint32_t base;
+  IRQn_Type irqn;
+  const char *name;
+  uint8_t rx[256];
+  uint8_t rx_head;
+  uint8_t rx_tail;
+  char *tx;
+  size_t tx_len;
+  size_t tx_cap;
+} SIM_Uart_t;
+
+static SIM_Uart_t sim_uarts[] = {
+    {USART1_BASE, USART1_IRQn, "USART1"}, {USART2_BASE, USART2_IRQn, "USART2"},
+    {USART3_BASE, USART3_IRQn, "USART3"}, {UART4_BASE, UART4_IRQn, "UART4"},
+    {UART5_BASE, UART5_IRQn, "UART5"},    {USART6_BASE, USART6_IRQn, "USART6"},
+};
+#define SIM_UART_NUM (sizeof(sim_uarts) / sizeof(sim_uarts[0]))
+
+#define SIM_GPIO_NUM 9
+static uint16_t sim_pin_driven[SIM_GPIO_NUM]; ///< 由激励驱动的引脚
+static uint16_t sim_pin_level[SIM_GPIO_NUM];  ///< 激励电平
+static uint16_t sim_odr_last[SIM_GPIO_NUM];   ///< 上次跟踪输出的ODR
+static FILE *sim_trace;
+
+/**
+ * @brief 激励
+ */
+typedef struct
+{
+  uint64_t ns;
+  uint8_t uart; ///< 0xFF表示引脚激励
+  uint8_t port;
+  uint8_t pin;
+  uint8_t level;
+  char *text;
+} SIM_Stim_t;
+
+static SIM_Stim_t *sim_stims;
+static size_t sim_stim_num;
+static size_t sim_stim_next;
+
+/**
+ * @brief 正在单步的访问
+ */
+typedef struct
+{
+  uintptr_t page;
+  uint32_t addr;   ///< 访问的字地址（位带访问时为目标字地址）
+  uint32_t before; ///< 访问前的寄存器值
+  uint32_t bb;     ///< 位带别名字地址，0表示非位带访问
+  uint8_t bit;     ///< 位带访问的目标位
+  uint8_t write;
+} SIM_Step_t;
+
+static SIM_Step_t sim_steps[SIM_STEP_MAX];
+static int sim_step_num;
+
+static uintptr_t sim_poll_pc;
+static uint32_t sim_poll_addr;
+static uint64_t sim_poll_start;
+
+static sigjmp_buf sim_exit_jmp;
+static uint8_t sim_in_run;
+
+/* ------------------------------------------------------------------------ */
+/*                               虚拟时钟                                    */
+/* ------------------------------------------------------------------------ */
+
+static uint32_t SIM_Hclk(void)
+{
+  return SystemCoreClock ? SystemCoreClock : HSI_VALUE;
+}
+
+static uint64_t SIM_NsToCycles(uint64_t ns)
+{
+  return (ns * SIM_Hclk() + 999999999ULL) / 1000000000ULL;
+}
+
+static void SIM_SetNow(uint64_t t)
+{
+  uint64_t num = (t - sim_now) * 1000000000ULL + sim_ns_rem;
+
+  sim_ns += num / SIM_Hclk();
+  sim_ns_rem = num % SIM_Hclk();
+  sim_now = t;
+}
+
+static uint32_t SIM_TimReg(SIM_Tim_t *t, uint32_t offset)
+{
+  return SIM_REG32(t->base + offset);
+}
+
+static uint64_t SIM_TimPeriod(SIM_Tim_t *t)
+{
+  return ((uint64_t)SIM_TimReg(t, offsetof(TIM_TypeDef, ARR)) + 1) * t->cpc;
+}
+
+/**
+ * @brief 定时器时钟相对HCLK的分频乘以预分频
+ */
+static uint64_t SIM_TimCpc(SIM_Tim_t *t)
+{
+  uint32_t cfgr = SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CFGR);
+  uint32_t ppre = t->apb2 ? (cfgr >> 13) & 7 : (cfgr >> 10) & 7;
+  // APB分频为1时定时器时钟等于PCLK，否则为PCLK的2倍
+  uint32_t ratio = ppre < 4 ? 1 : (1U << (ppre - 3)) / 2;
+
+  return (uint64_t)ratio * (SIM_TimReg(t, offsetof(TIM_TypeDef, PSC)) + 1);
+}
+
+static void SIM_TimUpdateDma(SIM_Tim_t *t, uint64_t n);
+
+/**
+ * @brief 把定时器推进到当前时刻，经过更新事件时置UIF
+ */
+static void SIM_TimCatchUp(SIM_Tim_t *t)
+{
+  uint64_t period;
+  uint64_t n;
+
+  if (!t->running || sim_now < t->next_upd)
+  {
+    return;
+  }
+
+  period = SIM_TimPeriod(t);
+  n = (sim_now - t->next_upd) / period;
+  t->t_zero = t->next_upd + n * period;
+  t->next_upd = t->t_zero + period;
+  SIM_PERIPH_REG(t->base, TIM_TypeDef, SR) |= TIM_SR_UIF;
+  SIM_TimUpdateDma(t, n + 1);
+}
+
+/**
+ * @brief 寄存器写入后按当前CNT重新建立时间基准
+ */
+static void SIM_TimResync(SIM_Tim_t *t)
+{
+  uint32_t cnt = SIM_TimReg(t, offsetof(TIM_TypeDef, CNT));
+  uint32_t arr = SIM_TimReg(t, offsetof(TIM_TypeDef, ARR));
+
+  t->running = (SIM_TimReg(t, offsetof(TIM_TypeDef, CR1)) & TIM_CR1_CEN) != 0;
+  t->cpc = SIM_TimCpc(t);
+  if (cnt > arr)
+  {
+    cnt = arr;
+  }
+  t->t_zero = sim_now - (uint64_t)cnt * t->cpc;
+  t->next_upd = t->t_zero + SIM_TimPeriod(t);
+}
+
+static void SIM_StCatchUp(void)
+{
+  uint64_t period;
+  uint64_t n;
+  uint32_t load = SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, LOAD) & SysTick_LOAD_RELOAD_Msk;
+
+  if (!sim_st.enabled || load == 0 || sim_now < sim_st.zero)
+  {
+    return;
+  }
+
+  period = (uint64_t)(load + 1) * sim_st.div;
+  n = (sim_now - sim_st.zero) / period;
+  sim_st.zero += (n + 1) * period;
+  sim_st.countflag = 1;
+  if (SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, CTRL) & SysTick_CTRL_TICKINT_Msk)
+  {
+    sim_st_pend = 1;
+  }
+}
+
+/**
+ * @brief RTCCLK频率，未选择时钟源返回0
+ */
+static uint32_t SIM_RtcClk(void)
+{
+  switch (SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, BDCR) & RCC_BDCR_RTCSEL)
+  {
+  case RCC_BDCR_RTCSEL_0:
+    return SIM_LSE_HZ;
+  case RCC_BDCR_RTCSEL_1:
+    return SIM_LSI_HZ;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief 唤醒定时器周期（纳秒），时钟源为RTCCLK/16~/2或ck_spre(1Hz)
+ */
+static uint64_t SIM_RtcWutPeriod(void)
+{
+  uint32_t cr = SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, CR);
+  uint64_t cnt = (uint64_t)(SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, WUTR) & 0xFFFF) + 1;
+  uint32_t clk = SIM_RtcClk();
+
+  if (clk == 0)
+  {
+    return (uint64_t)-1;
+  }
+  if (cr & RTC_CR_WUCKSEL_2)
+  {
+    return cnt * 1000000000ULL;
+  }
+  return cnt * (16U >> (cr & RTC_CR_WUCKSEL)) * 1000000000ULL / clk;
+}
+
+/**
+ * @brief 当前ck_apre计数（自日历零点以来）
+ */
+static uint64_t SIM_RtcUnits(void)
+{
+  uint32_t prer = SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, PRER);
+  uint32_t apre = ((prer & RTC_PRER_PREDIV_A) >> 16) + 1;
+
+  if (SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, ISR) & RTC_ISR_INIT)
+  {
+    return sim_rtc.base_units;
+  }
+  return sim_rtc.base_units + (sim_ns - sim_rtc.base_ns) * SIM_RtcClk() / apre / 1000000000ULL;
+}
+
+static void SIM_RtcCatchUp(void)
+{
+  if (!sim_rtc.wut_on || sim_ns < sim_rtc.wut_ns)
+  {
+    return;
+  }
+  sim_rtc.wut_ns += SIM_RtcWutPeriod();
+  SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, ISR) |= RTC_ISR_WUTF;
+  // 唤醒事件接EXTI线22（上升沿）
+  if (SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, RTSR) & SIM_EXTI_RTC_WKUP)
+  {
+    SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, PR) |= SIM_EXTI_RTC_WKUP;
+  }
+}
+
+/**
+ * @brief 数据流寄存器地址，句柄0~7为DMA1，8~15为DMA2
+ */
+static uint32_t SIM_DmaStream(uint32_t h)
+{
+  return (h < 8 ? DMA1_Stream0_BASE : DMA2_Stream0_BASE) + (h & 7) * 0x18;
+}
+
+static const uint8_t sim_dma_shift[4] = {0, 6, 16, 22};
+
+static const IRQn_Type sim_dma_irqn[SIM_DMA_STREAMS] = {
+    DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+};
+
+/**
+ * @brief 数据流状态标志（LISR/HISR中该数据流的6位）
+ */
+static volatile uint32_t *SIM_DmaIsr(uint32_t h)
+{
+  uint32_t base = h < 8 ? DMA1_BASE : DMA2_BASE;
+
+  return &SIM_REG32(base + ((h & 7) < 4 ? offsetof(DMA_TypeDef, LISR) : offsetof(DMA_TypeDef, HISR)));
+}
+
+/**
+ * @brief 数据流使能：存储器到存储器传输按数据项与突发数计时，完成时一次搬运
+ */
+static void SIM_DmaStart(uint32_t h)
+{
+  uint32_t sb = SIM_DmaStream(h);
+  uint32_t cr = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR);
+  uint32_t ndtr = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, NDTR);
+  uint32_t mburst = (cr & DMA_SxCR_MBURST) >> 23;
+  uint32_t beats = mburst ? 2U << mburst : 1;
+
+  sim_dma[h].ndtr0 = ndtr;
+  // 参考手册要求置位EN之前清除该数据流的全部事件标志
+  if ((*SIM_DmaIsr(h) >> sim_dma_shift[h & 3]) & 0x3D)
+  {
+    sim_dma_stale++;
+  }
+  if (h < 8 || (cr & DMA_SxCR_DIR) != DMA_SxCR_DIR_1)
+  {
+    return;
+  }
+  // 每个数据项一次源读与一次目的写，每次突发另加一次总线仲裁
+  sim_dma[h].busy = 1;
+  sim_dma[h].done = sim_now + SIM_DMA_SETUP + (uint64_t)ndtr * 2 + (ndtr + beats - 1) / beats * 2;
+}
+
+/**
+ * @brief 到期的传输：搬运数据，置TCIF/HTIF，清除EN与NDTR
+ */
+static void SIM_DmaCatchUp(void)
+{
+  uint32_t h;
+
+  for (h = 0; h < SIM_DMA_STREAMS; h++)
+  {
+    uint32_t sb = SIM_DmaStream(h);
+    uint32_t cr;
+    uint32_t size;
+    uint32_t n;
+    uint32_t i;
+    uint8_t *src;
+    uint8_t *dst;
+
+    if (!sim_dma[h].busy || sim_now < sim_dma[h].done)
+    {
+      continue;
+    }
+    sim_dma[h].busy = 0;
+    cr = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR);
+    size = 1U << ((cr & DMA_SxCR_PSIZE) >> 11);
+    n = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, NDTR);
+    src = (uint8_t *)(uintptr_t)SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, PAR);
+    dst = (uint8_t *)(uintptr_t)SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, M0AR);
+    for (i = 0; i < n; i++)
+    {
+      memcpy(dst, src, size);
+      dst += (cr & DMA_SxCR_MINC) ? size : 0;
+      src += (cr & DMA_SxCR_PINC) ? size : 0;
+    }
+    sim_dma_bytes += (uint64_t)n * size;
+    SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, NDTR) = 0;
+    SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR) = cr & ~DMA_SxCR_EN;
+    *SIM_DmaIsr(h) |= (uint32_t)(DMA_LISR_TCIF0 | DMA_LISR_HTIF0) << sim_dma_shift[h & 3];
+  }
+}
+
+static void SIM_Effect(SIM_Periph_t *p, uint32_t addr, uint8_t write, uint32_t before);
+
+/**
+ * @brief 定时器更新事件的DMA请求：定时器基地址、数据流句柄、通道
+ * @note 只建模基本定时器；通用/高级定时器的DMA请求仍不搬运数据
+ */
+static const struct
+{
+  uint32_t tim;
+  uint8_t h;
+  uint8_t ch;
+} sim_tim_up_dma[] = {
+    {TIM6_BASE, 1, 7}, // DMA1 Stream1 通道7
+    {TIM7_BASE, 2, 1}, // DMA1 Stream2 通道1
+    {TIM7_BASE, 4, 1}, // DMA1 Stream4 通道1
+};
+
+/**
+ * @brief 定时器使能了更新DMA请求且有建模的数据流
+ */
+static uint8_t SIM_TimUpDmaActive(SIM_Tim_t *t)
+{
+  uint32_t i;
+
+  if (!(SIM_TimReg(t, offsetof(TIM_TypeDef, DIER)) & TIM_DIER_UDE))
+  {
+    return 0;
+  }
+  for (i = 0; i < sizeof(sim_tim_up_dma) / sizeof(sim_tim_up_dma[0]); i++)
+  {
+    if (sim_tim_up_dma[i].tim == t->base)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 外设请求触发的一次数据项传输：推进NDTR，过半置HTIF，
+ *        到0置TCIF，循环模式重装NDTR（双缓冲模式切换CT），否则清除EN
+ */
+static void SIM_DmaItem(uint32_t h, uint8_t ch)
+{
+  uint32_t sb = SIM_DmaStream(h);
+  uint32_t cr = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR);
+  uint32_t ndtr = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, NDTR);
+  uint32_t msize = 1U << ((cr & DMA_SxCR_MSIZE) >> 13);
+  uint32_t psize = 1U << ((cr & DMA_SxCR_PSIZE) >> 11);
+  uint32_t idx = sim_dma[h].ndtr0 - ndtr;
+  uint32_t mem;
+  uint32_t per;
+  uint32_t before;
+  uint32_t value = 0;
+  SIM_Periph_t *p;
+
+  if (!(cr & DMA_SxCR_EN) || ((cr & DMA_SxCR_CHSEL) >> 25) != ch || ndtr == 0)
+  {
+    return;
+  }
+  mem = (cr & DMA_SxCR_CT) ? SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, M1AR)
+                           : SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, M0AR);
+  mem += (cr & DMA_SxCR_MINC) ? idx * msize : 0;
+  per = SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, PAR) + ((cr & DMA_SxCR_PINC) ? idx * psize : 0);
+  p = SIM_FindPeriph(per);
+
+  if ((cr & DMA_SxCR_DIR) == DMA_SxCR_DIR_0 && p)
+  {
+    // 存储器到外设：经别名视图写入，再执行与CPU写入相同的副作用
+    memcpy(&value, (const void *)(uintptr_t)mem, msize);
+    before = SIM_REG32(per & ~3U);
+    memcpy((void *)SIM_Alias(per), &value, psize);
+    SIM_Effect(p, per, 1, before);
+    if (sim_dma_hook)
+    {
+      sim_dma_hook(per, value, sim_ns / 1000);
+    }
+  }
+  else if ((cr & DMA_SxCR_DIR) == 0 && p)
+  {
+    memcpy(&value, (const void *)SIM_Alias(per), psize);
+    memcpy((void *)(uintptr_t)mem, &value, msize);
+  }
+  sim_dma_bytes += msize;
+
+  if (--ndtr == sim_dma[h].ndtr0 / 2)
+  {
+    *SIM_DmaIsr(h) |= (uint32_t)DMA_LISR_HTIF0 << sim_dma_shift[h & 3];
+  }
+  if (ndtr == 0)
+  {
+    *SIM_DmaIsr(h) |= (uint32_t)DMA_LISR_TCIF0 << sim_dma_shift[h & 3];
+    if (cr & DMA_SxCR_CIRC)
+    {
+      ndtr = sim_dma[h].ndtr0;
+      if (cr & DMA_SxCR_DBM)
+      {
+        SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR) = cr ^ DMA_SxCR_CT;
+      }
+    }
+    else
+    {
+      SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR) = cr & ~DMA_SxCR_EN;
+    }
+  }
+  SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, NDTR) = ndtr;
+}
+
+/**
+ * @brief 定时器经过n次更新事件，向映射的数据流发出n次DMA请求
+ */
+static void SIM_TimUpdateDma(SIM_Tim_t *t, uint64_t n)
+{
+  uint32_t i;
+  uint64_t k;
+
+  if (!SIM_TimUpDmaActive(t))
+  {
+    return;
+  }
+  for (i = 0; i < sizeof(sim_tim_up_dma) / sizeof(sim_tim_up_dma[0]); i++)
+  {
+    if (sim_tim_up_dma[i].tim != t->base)
+    {
+      continue;
+    }
+    for (k = 0; k < n; k++)
+    {
+      SIM_DmaItem(sim_tim_up_dma[i].h, sim_tim_up_dma[i].ch);
+    }
+  }
+}
+
+static void SIM_ApplyStimulus(SIM_Stim_t *s);
+static void SIM_RccSync(void);
+
+/**
+ * @brief 处理当前时刻之前到期的全部事件
+ */
+static void SIM_ProcessEvents(void)
+{
+  uint32_t i;
+
+  // STOP期间内核与APB时钟停止，只有RTC与EXTI继续工作
+  if (!sim_stopped)
+  {
+    SIM_StCatchUp();
+    for (i = 0; i < SIM_TIM_NUM; i++)
+    {
+      SIM_TimCatchUp(&sim_tims[i]);
+    }
+    SIM_DmaCatchUp();
+  }
+  SIM_RtcCatchUp();
+  while (sim_stim_next < sim_stim_num && sim_stims[sim_stim_next].ns <= sim_ns)
+  {
+    SIM_ApplyStimulus(&sim_stims[sim_stim_next++]);
+  }
+}
+
+/**
+ * @brief 下一个可能唤醒CPU的事件时刻
+ */
+static uint64_t SIM_NextEvent(void)
+{
+  uint64_t t = (uint64_t)-1;
+  uint32_t i;
+
+  if (!sim_stopped && sim_st.enabled && (SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, CTRL) & SysTick_CTRL_TICKINT_Msk))
+  {
+    t = sim_st.zero;
+  }
+  for (i = 0; i < SIM_TIM_NUM && !sim_stopped; i++)
+  {
+    SIM_Tim_t *tim = &sim_tims[i];
+
+    // 更新中断与建模的更新DMA请求都需要在更新时刻唤醒
+    if (tim->running && ((SIM_TimReg(tim, offsetof(TIM_TypeDef, DIER)) & TIM_DIER_UIE) || SIM_TimUpDmaActive(tim)) &&
+        tim->next_upd < t)
+    {
+      t = tim->next_upd;
+    }
+  }
+  for (i = 0; i < SIM_DMA_STREAMS && !sim_stopped; i++)
+  {
+    if (sim_dma[i].busy && sim_dma[i].done < t)
+    {
+      t = sim_dma[i].done;
+    }
+  }
+  if (sim_rtc.wut_on)
+  {
+    uint64_t c = sim_now + (sim_rtc.wut_ns > sim_ns ? SIM_NsToCycles(sim_rtc.wut_ns - sim_ns) : 0);
+
+    if (c < t)
+    {
+      t = c;
+    }
+  }
+  if (sim_stim_next < sim_stim_num)
+  {
+    uint64_t ns = sim_stims[sim_stim_next].ns;
+    uint64_t c = sim_now + (ns > sim_ns ? SIM_NsToCycles(ns - sim_ns) : 0);
+
+    if (c < t)
+    {
+      t = c;
+    }
+  }
+  if (sim_end_ns)
+  {
+    uint64_t c = sim_now + (sim_end_ns > sim_ns ? SIM_NsToCycles(sim_end_ns - sim_ns) : 0);
+
+    if (c < t)
+    {
+      t = c;
+    }
+  }
+  return t;
+}
+
+static void SIM_AdvanceTo(uint64_t t)
+{
+  uint64_t ev;
+
+  while ((ev = SIM_NextEvent()) <= t && ev > sim_now)
+  {
+    SIM_SetNow(ev);
+    SIM_ProcessEvents();
+  }
+  if (t > sim_now)
+  {
+    SIM_SetNow(t);
+  }
+  SIM_ProcessEvents();
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               中断                                        */
+/* ------------------------------------------------------------------------ */
+
+static uint32_t SIM_ExcPrio(uint32_t exc)
+{
+  if (exc == SIM_EXC_SYSTICK)
+  {
+    return SIM_REG8(SCB_BASE + offsetof(SCB_Type, SHP) + 11) >> (8 - __NVIC_PRIO_BITS);
+  }
+  return SIM_REG8(NVIC_BASE + offsetof(NVIC_Type, IP) + exc - SIM_EXC_IRQ0) >> (8 - __NVIC_PRIO_BITS);
+}
+
+/**
+ * @brief 当前执行优先级（数值越小越高）
+ */
+static uint32_t SIM_ExecPrio(void)
+{
+  uint32_t prio = SIM_PRIO_THREAD;
+
+  if (sim_act_depth)
+  {
+    prio = SIM_ExcPrio(sim_act_stack[sim_act_depth - 1]);
+  }
+  if (sim_basepri && (sim_basepri >> (8 - __NVIC_PRIO_BITS)) < prio)
+  {
+    prio = sim_basepri >> (8 - __NVIC_PRIO_BITS);
+  }
+  return prio;
+}
+
+/**
+ * @brief 选出能抢占当前执行优先级的最高优先级挂起异常（不考虑PRIMASK）
+ * @retval 异常号，没有返回-1
+ */
+static int SIM_PickPending(void)
+{
+  uint32_t best_prio = SIM_ExecPrio();
+  int best = -1;
+  uint32_t n;
+
+  if (sim_st_pend && SIM_ExcPrio(SIM_EXC_SYSTICK) < best_prio)
+  {
+    best = SIM_EXC_SYSTICK;
+    best_prio = SIM_ExcPrio(SIM_EXC_SYSTICK);
+  }
+  for (n = 0; n < SIM_IRQ_NUM; n++)
+  {
+    uint32_t bit = 1UL << (n & 31);
+
+    if ((sim_nvic_pend[n >> 5] & sim_nvic_en[n >> 5] & bit) && SIM_ExcPrio(SIM_EXC_IRQ0 + n) < best_prio)
+    {
+      best = SIM_EXC_IRQ0 + n;
+      best_prio = SIM_ExcPrio(best);
+    }
+  }
+  return best;
+}
+
+static void SIM_PendIrq(IRQn_Type irqn)
+{
+  uint32_t n = (uint32_t)irqn;
+
+  if (!(sim_nvic_act[n >> 5] & (1UL << (n & 31))))
+  {
+    sim_nvic_pend[n >> 5] |= 1UL << (n & 31);
+  }
+}
+
+/**
+ * @brief 按外设中断标志（电平）挂起NVIC中断
+ * @note 正在服务的中断不重复挂起，返回后重新评估
+ */
+static void SIM_UpdateLevels(void)
+{
+  uint32_t pr = SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, PR) & SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, IMR);
+  uint32_t line;
+  uint32_t i;
+
+  for (line = 0; line < 16; line++)
+  {
+    if (pr & (1UL << line))
+    {
+      SIM_PendIrq(line <= 4 ? (IRQn_Type)(EXTI0_IRQn + line) : (line <= 9 ? EXTI9_5_IRQn : EXTI15_10_IRQn));
+    }
+  }
+  if (pr & SIM_EXTI_RTC_WKUP)
+  {
+    SIM_PendIrq(RTC_WKUP_IRQn);
+  }
+  for (i = 0; i < SIM_TIM_NUM; i++)
+  {
+    SIM_Tim_t *t = &sim_tims[i];
+
+    if (SIM_TimReg(t, offsetof(TIM_TypeDef, SR)) & SIM_TimReg(t, offsetof(TIM_TypeDef, DIER)) & 0x1F)
+    {
+      SIM_PendIrq(t->irqn);
+    }
+  }
+  for (i = 0; i < SIM_DMA_STREAMS; i++)
+  {
+    uint32_t sb = SIM_DmaStream(i);
+    // 中断使能位 TCIE/HTIE/TEIE/DMEIE 左移一位对应各自的标志位
+    uint32_t ie = (SIM_PERIPH_REG(sb, DMA_Stream_TypeDef, CR) & 0x1E) << 1;
+
+    if ((*SIM_DmaIsr(i) >> sim_dma_shift[i & 3]) & ie)
+    {
+      SIM_PendIrq(sim_dma_irqn[i]);
+    }
+  }
+  for (i = 0; i < SIM_UART_NUM; i++)
+  {
+    SIM_Uart_t *u = &sim_uarts[i];
+    uint32_t sr = SIM_PERIPH_REG(u->base, USART_TypeDef, SR);
+    uint32_t cr1 = SIM_PERIPH_REG(u->base, USART_TypeDef, CR1);
+
+    if ((cr1 & USART_CR1_UE) && (sr & cr1 & (USART_SR_RXNE | USART_SR_TC | USART_SR_TXE)))
+    {
+      SIM_PendIrq(u->irqn);
+    }
+  }
+}
+
+static void SIM_CheckEnd(void)
+{
+  if (sim_in_run && sim_end_ns && sim_ns >= sim_end_ns)
+  {
+    siglongjmp(sim_exit_jmp, 1 + SIM_END_TIME);
+  }
+}
+
+static void SIM_Sleep(void);
+
+/**
+ * @brief 分发全部可抢占的挂起异常（PRIMASK=0时）
+ * @retval 分发的异常数
+ */
+static uint32_t SIM_DeliverPending(void)
+{
+  uint32_t count = 0;
+  int exc;
+
+  while (!sim_primask && (exc = SIM_PickPending()) >= 0)
+  {
+    void (*handler)(void);
+    uint32_t n = (uint32_t)(exc - SIM_EXC_IRQ0);
+
+    if (exc == SIM_EXC_SYSTICK)
+    {
+      sim_st_pend = 0;
+    }
+    else
+    {
+      sim_nvic_pend[n >> 5] &= ~(1UL << (n & 31));
+      sim_nvic_act[n >> 5] |= 1UL << (n & 31);
+    }
+    handler = (void (*)(void))(uintptr_t)((const uint32_t *)(uintptr_t)SIM_PERIPH_REG(SCB_BASE, SCB_Type, VTOR))[exc];
+
+    sim_act_stack[sim_act_depth++] = (uint8_t)exc;
+    sim_exc_count[exc]++;
+    if (handler)
+    {
+      handler();
+    }
+    sim_act_depth--;
+    if (exc != SIM_EXC_SYSTICK)
+    {
+      sim_nvic_act[n >> 5] &= ~(1UL << (n & 31));
+    }
+
+    SIM_UpdateLevels();
+    SIM_CheckEnd();
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief 分发挂起异常；返回线程模式时若SLEEPONEXIT置位，不回到线程而继续睡眠
+ */
+static void SIM_Deliver(void)
+{
+  if (SIM_DeliverPending() == 0 || sim_act_depth)
+  {
+    return;
+  }
+  while (SIM_PERIPH_REG(SCB_BASE, SCB_Type, SCR) & SCB_SCR_SLEEPONEXIT_Msk)
+  {
+    SIM_Sleep();
+    SIM_CheckEnd();
+    if (sim_primask)
+    {
+      break;
+    }
+    SIM_DeliverPending();
+  }
+}
+
+uint32_t SIM_GetPrimask(void)
+{
+  return sim_primask;
+}
+
+void SIM_SetPrimask(uint32_t primask)
+{
+  sim_primask = primask;
+  if (!primask)
+  {
+    SIM_Deliver();
+  }
+}
+
+uint32_t SIM_GetBasepri(void)
+{
+  return sim_basepri;
+}
+
+void SIM_SetBasepri(uint32_t basepri)
+{
+  sim_basepri = basepri;
+  SIM_Deliver();
+}
+
+uint32_t SIM_GetMsp(void)
+{
+  return sim_msp;
+}
+
+void SIM_SetMsp(uint32_t msp)
+{
+  sim_msp = msp;
+}
+
+uint32_t SIM_GetIPSR(void)
+{
+  return sim_act_depth ? sim_act_stack[sim_act_depth - 1] : 0;
+}
+
+/**
+ * @brief 进入STOP：冻结内核时钟域
+ */
+static void SIM_StopEnter(void)
+{
+  sim_stopped = 1;
+}
+
+/**
+ * @brief 退出STOP：内核时钟域的计数按停止的时长顺延，系统时钟切回HSI，HSE与PLL关闭
+ */
+static void SIM_StopExit(uint64_t start, uint64_t start_ns)
+{
+  uint64_t dt = sim_now - start;
+  uint32_t i;
+
+  sim_stopped = 0;
+  sim_stop_ns += sim_ns - start_ns;
+  sim_st.zero += dt;
+  sim_cyc_base += dt;
+  for (i = 0; i < SIM_TIM_NUM; i++)
+  {
+    sim_tims[i].t_zero += dt;
+    sim_tims[i].next_upd += dt;
+  }
+  SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CR) =
+      (SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CR) & ~(RCC_CR_HSEON | RCC_CR_PLLON | RCC_CR_PLLI2SON)) | RCC_CR_HSION;
+  SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CFGR) &= ~RCC_CFGR_SW;
+  SIM_RccSync();
+}
+
+/**
+ * @brief 睡眠直到有可抢占的挂起异常（不分发）
+ * @note SLEEPDEEP置位且PWR_CR.PDDS为0时按STOP处理
+ */
+static void SIM_Sleep(void)
+{
+  uint64_t start = sim_now;
+  uint64_t start_ns = sim_ns;
+  uint8_t stop = (SIM_PERIPH_REG(SCB_BASE, SCB_Type, SCR) & SCB_SCR_SLEEPDEEP_Msk) &&
+                 !(SIM_PERIPH_REG(PWR_BASE, PWR_TypeDef, CR) & PWR_CR_PDDS);
+
+  if (stop && SIM_PickPending() < 0)
+  {
+    SIM_StopEnter();
+  }
+
+  // 关中断时挂起的中断同样唤醒WFI，只是不分发
+  while (SIM_PickPending() < 0)
+  {
+    uint64_t t = SIM_NextEvent();
+
+    if (t == (uint64_t)-1)
+    {
+      if (sim_in_run)
+      {
+        sim_idle_cycles += sim_now - start;
+        siglongjmp(sim_exit_jmp, 1 + SIM_END_IDLE);
+      }
+      break;
+    }
+    SIM_AdvanceTo(t);
+    SIM_UpdateLevels();
+    if (sim_end_ns && sim_ns >= sim_end_ns)
+    {
+      break;
+    }
+  }
+  if (sim_stopped)
+  {
+    SIM_StopExit(start, start_ns);
+  }
+  sim_idle_cycles += sim_now - start;
+}
+
+void SIM_WaitForInterrupt(void)
+{
+  SIM_Sleep();
+  SIM_CheckEnd();
+  SIM_Deliver();
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               外设模型                                    */
+/* ------------------------------------------------------------------------ */
+
+static void SIM_GpioRefresh(SIM_Periph_t *p)
+{
+  uint32_t moder = SIM_PERIPH_REG(p->base, GPIO_TypeDef, MODER);
+  uint32_t pupdr = SIM_PERIPH_REG(p->base, GPIO_TypeDef, PUPDR);
+  uint32_t odr = SIM_PERIPH_REG(p->base, GPIO_TypeDef, ODR);
+  uint32_t idr = 0;
+  uint32_t pin;
+
+  for (pin = 0; pin < 16; pin++)
+  {
+    uint32_t bit = 1UL << pin;
+    uint32_t level;
+
+    if (((moder >> (pin * 2)) & 3) == GPIO_Mode_OUT)
+    {
+      level = odr & bit;
+    }
+    else if (sim_pin_driven[p->unit] & bit)
+    {
+      level = sim_pin_level[p->unit] & bit;
+    }
+    else
+    {
+      // 未驱动的输入：下拉读0，其余按板上外部上拉读1
+      level = ((pupdr >> (pin * 2)) & 3) == GPIO_PuPd_DOWN ? 0 : bit;
+    }
+    idr |= level;
+  }
+  SIM_PERIPH_REG(p->base, GPIO_TypeDef, IDR) = idr;
+}
+
+static void SIM_GpioWrite(SIM_Periph_t *p, uint32_t offset)
+{
+  uint32_t odr;
+
+  if (offset == offsetof(GPIO_TypeDef, BSRRL))
+  {
+    uint32_t bsrr = SIM_REG32(p->base + offset);
+
+    // 同时置位与复位时置位优先
+    odr = SIM_PERIPH_REG(p->base, GPIO_TypeDef, ODR);
+    odr = (odr & ~(bsrr >> 16)) | (bsrr & 0xFFFF);
+    SIM_PERIPH_REG(p->base, GPIO_TypeDef, ODR) = odr;
+    SIM_REG32(p->base + offset) = 0;
+  }
+
+  odr = SIM_PERIPH_REG(p->base, GPIO_TypeDef, ODR) & 0xFFFF;
+  if (odr != sim_odr_last[p->unit])
+  {
+    sim_odr_last[p->unit] = (uint16_t)odr;
+    if (sim_trace)
+    {
+      fprintf(sim_trace, "gpio t_us=%llu.%03llu port=%c odr=0x%04x\n", (unsigned long long)(sim_ns / 1000),
+              (unsigned long long)(sim_ns % 1000), 'A' + p->unit, (unsigned)odr);
+    }
+  }
+}
+
+/**
+ * @brief 引脚输入电平变化，按SYSCFG/EXTI配置产生边沿
+ */
+static void SIM_PinChange(uint8_t port, uint8_t pin, uint8_t level)
+{
+  uint32_t gpio = GPIOA_BASE + port * 0x400;
+  uint32_t bit = 1UL << pin;
+  uint32_t idr_before;
+  uint32_t exticr;
+
+  SIM_GpioRefresh(SIM_FindPeriph(gpio));
+  idr_before = SIM_PERIPH_REG(gpio, GPIO_TypeDef, IDR) & bit;
+
+  sim_pin_driven[port] |= (uint16_t)bit;
+  if (level)
+  {
+    sim_pin_level[port] |= (uint16_t)bit;
+  }
+  else
+  {
+    sim_pin_level[port] &= (uint16_t)~bit;
+  }
+  SIM_GpioRefresh(SIM_FindPeriph(gpio));
+
+  if ((SIM_PERIPH_REG(gpio, GPIO_TypeDef, IDR) & bit) == idr_before)
+  {
+    return;
+  }
+
+  exticr = SIM_REG32(SYSCFG_BASE + offsetof(SYSCFG_TypeDef, EXTICR) + (pin >> 2) * 4);
+  if (((exticr >> ((pin & 3) * 4)) & 0xF) != port)
+  {
+    return;
+  }
+  if ((level ? SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, RTSR) : SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, FTSR)) & bit &&
+      (SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, IMR) & bit))
+  {
+    SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, PR) |= bit;
+  }
+}
+
+static void SIM_ApplyStimulus(SIM_Stim_t *s)
+{
+  if (s->uart == 0xFF)
+  {
+    SIM_PinChange(s->port, s->pin, s->level);
+  }
+  else
+  {
+    SIM_Uart_t *u = &sim_uarts[s->uart];
+    const char *c;
+
+    for (c = s->text; *c; c++)
+    {
+      if ((uint8_t)(u->rx_head + 1) != u->rx_tail)
+      {
+        u->rx[u->rx_head++] = (uint8_t)*c;
+      }
+    }
+  }
+}
+
+static void SIM_UartRefresh(SIM_Periph_t *p)
+{
+  SIM_Uart_t *u = &sim_uarts[p->unit];
+  uint32_t sr = USART_SR_TXE | USART_SR_TC;
+
+  if (u->rx_head != u->rx_tail)
+  {
+    sr |= USART_SR_RXNE;
+    SIM_PERIPH_REG(p->base, USART_TypeDef, DR) = u->rx[u->rx_tail];
+  }
+  SIM_PERIPH_REG(p->base, USART_TypeDef, SR) = sr;
+}
+
+static void SIM_UartAccess(SIM_Periph_t *p, uint32_t offset, uint8_t write)
+{
+  SIM_Uart_t *u = &sim_uarts[p->unit];
+
+  if (offset != offsetof(USART_TypeDef, DR))
+  {
+    return;
+  }
+  if (!write)
+  {
+    if (u->rx_head != u->rx_tail)
+    {
+      u->rx_tail++;
+    }
+    return;
+  }
+  if (u->tx_len + 1 >= u->tx_cap)
+  {
+    u->tx_cap = u->tx_cap ? u->tx_cap * 2 : 256;
+    u->tx = realloc(u->tx, u->tx_cap);
+  }
+  if (u->tx)
+  {
+    u->tx[u->tx_len++] = (char)(SIM_PERIPH_REG(p->base, USART_TypeDef, DR) & 0xFF);
+    u->tx[u->tx_len] = 0;
+  }
+}
+
+/**
+ * @brief RCC：就绪位跟随使能位，SWS跟随SW
+ */
+static void SIM_RccSync(void)
+{
+  volatile uint32_t *cr = &SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CR);
+  volatile uint32_t *cfgr = &SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CFGR);
+  volatile uint32_t *bdcr = &SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, BDCR);
+  volatile uint32_t *csr = &SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CSR);
+  uint32_t on = RCC_CR_HSION | RCC_CR_HSEON | RCC_CR_PLLON | RCC_CR_PLLI2SON;
+
+  *cr = (*cr & ~(on << 1)) | ((*cr & on) << 1);
+  *cfgr = (*cfgr & ~RCC_CFGR_SWS) | ((*cfgr & RCC_CFGR_SW) << 2);
+  *bdcr = (*bdcr & ~RCC_BDCR_LSERDY) | ((*bdcr & RCC_BDCR_LSEON) << 1);
+  *csr = (*csr & ~RCC_CSR_LSIRDY) | ((*csr & RCC_CSR_LSION) << 1);
+}
+
+/**
+ * @brief 两位BCD
+ */
+static uint32_t SIM_Bcd(uint32_t v)
+{
+  return ((v / 10) << 4) | (v % 10);
+}
+
+/**
+ * @brief RTC：按虚拟时间刷新TR/SSR与状态位
+ */
+static void SIM_RtcRefresh(void)
+{
+  volatile uint32_t *isr = &SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, ISR);
+  uint32_t prer = SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, PRER);
+  uint32_t s1 = (prer & RTC_PRER_PREDIV_S) + 1;
+  uint32_t flags = RTC_ISR_RSF;
+  uint64_t units;
+  uint32_t sec;
+
+  if (*isr & RTC_ISR_INIT)
+  {
+    flags |= RTC_ISR_INITF;
+  }
+  if (!(SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, CR) & RTC_CR_WUTE))
+  {
+    flags |= RTC_ISR_WUTWF;
+  }
+  *isr = (*isr & ~(RTC_ISR_INITF | RTC_ISR_WUTWF)) | flags;
+
+  if (SIM_RtcClk() == 0 || (*isr & RTC_ISR_INIT))
+  {
+    return;
+  }
+  units = SIM_RtcUnits();
+  sec = (uint32_t)((units / s1) % 86400);
+  SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, SSR) = s1 - 1 - (uint32_t)(units % s1);
+  SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, TR) =
+      (SIM_Bcd(sec / 3600) << 16) | (SIM_Bcd(sec / 60 % 60) << 8) | SIM_Bcd(sec % 60);
+}
+
+/**
+ * @brief RTC写入：ISR标志写0清零，退出初始化模式时按TR重新起算，
+ *        使能唤醒定时器时开始计时
+ */
+static void SIM_RtcWrite(uint32_t offset, uint32_t before)
+{
+  volatile uint32_t *isr = &SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, ISR);
+
+  if (offset == offsetof(RTC_TypeDef, ISR))
+  {
+    uint32_t rc_w0 = RTC_ISR_WUTF | RTC_ISR_ALRAF | RTC_ISR_ALRBF | RTC_ISR_TSF | RTC_ISR_TSOVF | RTC_ISR_RSF;
+    uint32_t v = *isr;
+
+    *isr = (before & ~rc_w0) | (before & v & rc_w0);
+    *isr = (*isr & ~RTC_ISR_INIT) | (v & RTC_ISR_INIT);
+    if ((before & RTC_ISR_INIT) && !(v & RTC_ISR_INIT))
+    {
+      uint32_t tr = SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, TR);
+      uint32_t s1 = (SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, PRER) & RTC_PRER_PREDIV_S) + 1;
+      uint32_t hour = ((tr >> 20) & 3) * 10 + ((tr >> 16) & 0xF);
+      uint32_t min = ((tr >> 12) & 7) * 10 + ((tr >> 8) & 0xF);
+      uint32_t sec = ((tr >> 4) & 7) * 10 + (tr & 0xF);
+
+      sim_rtc.base_ns = sim_ns;
+      sim_rtc.base_units = (uint64_t)(hour * 3600 + min * 60 + sec) * s1;
+    }
+    else if (!(before & RTC_ISR_INIT) && (v & RTC_ISR_INIT))
+    {
+      sim_rtc.base_units = SIM_RtcUnits();
+    }
+  }
+  else if (offset == offsetof(RTC_TypeDef, CR))
+  {
+    uint8_t on = (SIM_PERIPH_REG(RTC_BASE, RTC_TypeDef, CR) & RTC_CR_WUTE) != 0;
+
+    if (on && !sim_rtc.wut_on)
+    {
+      sim_rtc.wut_ns = sim_ns + SIM_RtcWutPeriod();
+    }
+    sim_rtc.wut_on = on;
+  }
+  SIM_RtcRefresh();
+}
+
+static void SIM_StRefresh(void)
+{
+  volatile uint32_t *ctrl = &SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, CTRL);
+
+  if (sim_st.enabled)
+  {
+    SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, VAL) = (uint32_t)((sim_st.zero - sim_now + sim_st.div - 1) / sim_st.div);
+  }
+  *ctrl = (*ctrl & ~SysTick_CTRL_COUNTFLAG_Msk) | ((uint32_t)sim_st.countflag << SysTick_CTRL_COUNTFLAG_Pos);
+}
+
+static void SIM_StAccess(uint32_t offset, uint8_t write)
+{
+  volatile uint32_t *ctrl = &SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, CTRL);
+  uint32_t load = SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, LOAD) & SysTick_LOAD_RELOAD_Msk;
+
+  if (!write)
+  {
+    if (offset == offsetof(SysTick_Type, CTRL))
+    {
+      sim_st.countflag = 0; // 读CTRL清除COUNTFLAG
+    }
+    return;
+  }
+
+  if (offset == offsetof(SysTick_Type, CTRL))
+  {
+    uint8_t en = (*ctrl & SysTick_CTRL_ENABLE_Msk) != 0;
+
+    sim_st.div = (*ctrl & SysTick_CTRL_CLKSOURCE_Msk) ? 1 : 8;
+    if (en && !sim_st.enabled)
+    {
+      uint32_t val = SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, VAL);
+
+      // 计数值为0时下一个时钟只重装，不产生计数到0事件
+      sim_st.zero = sim_now + (uint64_t)(val ? val : load + 1) * sim_st.div;
+    }
+    sim_st.enabled = en;
+  }
+  else if (offset == offsetof(SysTick_Type, LOAD))
+  {
+    SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, LOAD) = load;
+  }
+  else if (offset == offsetof(SysTick_Type, VAL))
+  {
+    // 写任意值清零计数并清除COUNTFLAG
+    SIM_PERIPH_REG(SysTick_BASE, SysTick_Type, VAL) = 0;
+    sim_st.countflag = 0;
+    if (sim_st.enabled)
+    {
+      sim_st.zero = sim_now + (uint64_t)(load + 1) * sim_st.div;
+    }
+  }
+  SIM_StRefresh();
+}
+
+static void SIM_NvicRefresh(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < 3; i++)
+  {
+    SIM_REG32(NVIC_BASE + offsetof(NVIC_Type, ISER) + i * 4) = sim_nvic_en[i];
+    SIM_REG32(NVIC_BASE + offsetof(NVIC_Type, ICER) + i * 4) = sim_nvic_en[i];
+    SIM_REG32(NVIC_BASE + offsetof(NVIC_Type, ISPR) + i * 4) = sim_nvic_pend[i];
+    SIM_REG32(NVIC_BASE + offsetof(NVIC_Type, ICPR) + i * 4) = sim_nvic_pend[i];
+    SIM_REG32(NVIC_BASE + offsetof(NVIC_Type, IABR) + i * 4) = sim_nvic_act[i];
+  }
+}
+
+static void SIM_NvicWrite(uint32_t offset)
+{
+  uint32_t v = SIM_REG32(NVIC_BASE + offset);
+  uint32_t i = (offset & 0x7F) >> 2;
+
+  if (i < 3)
+  {
+    if (offset < offsetof(NVIC_Type, ICER))
+    {
+      sim_nvic_en[i] |= v;
+    }
+    else if (offset < offsetof(NVIC_Type, ISPR))
+    {
+      sim_nvic_en[i] &= ~v;
+    }
+    else if (offset < offsetof(NVIC_Type, ICPR))
+    {
+      sim_nvic_pend[i] |= v;
+    }
+    else if (offset < offsetof(NVIC_Type, IABR))
+    {
+      sim_nvic_pend[i] &= ~v;
+    }
+  }
+  SIM_NvicRefresh();
+}
+
+static void SIM_ScbRefresh(void)
+{
+  volatile uint32_t *icsr = &SIM_PERIPH_REG(SCB_BASE, SCB_Type, ICSR);
+
+  *icsr = (sim_st_pend ? SCB_ICSR_PENDSTSET_Msk : 0) | SIM_GetIPSR();
+}
+
+static void SIM_ScbWrite(uint32_t offset)
+{
+  if (offset == offsetof(SCB_Type, ICSR))
+  {
+    uint32_t v = SIM_PERIPH_REG(SCB_BASE, SCB_Type, ICSR);
+
+    if (v & SCB_ICSR_PENDSTSET_Msk)
+    {
+      sim_st_pend = 1;
+    }
+    if (v & SCB_ICSR_PENDSTCLR_Msk)
+    {
+      sim_st_pend = 0;
+    }
+    SIM_ScbRefresh();
+  }
+}
+
+static void SIM_DwtRefresh(void)
+{
+  if (SIM_PERIPH_REG(DWT_BASE, DWT_Type, CTRL) & DWT_CTRL_CYCCNTENA_Msk)
+  {
+    SIM_PERIPH_REG(DWT_BASE, DWT_Type, CYCCNT) = (uint32_t)(sim_now - sim_cyc_base);
+  }
+}
+
+static void SIM_DwtWrite(uint32_t offset)
+{
+  // 写CYCCNT或重新使能时，以当前值为基准继续计数
+  if (offset == offsetof(DWT_Type, CYCCNT) || offset == offsetof(DWT_Type, CTRL))
+  {
+    sim_cyc_base = sim_now - SIM_PERIPH_REG(DWT_BASE, DWT_Type, CYCCNT);
+  }
+}
+
+/**
+ * @brief DMA：标志清除寄存器写1清零，数据流EN的置位/清零启动/中止传输
+ */
+static void SIM_DmaWrite(SIM_Periph_t *p, uint32_t offset, uint32_t before)
+{
+  uint32_t h;
+
+  if (offset == offsetof(DMA_TypeDef, LIFCR) || offset == offsetof(DMA_TypeDef, HIFCR))
+  {
+    SIM_REG32(p->base + offset - 8) &= ~SIM_REG32(p->base + offset);
+    SIM_REG32(p->base + offset) = 0;
+    return;
+  }
+  if (offset < 0x10 || (offset - 0x10) % 0x18 != 0)
+  {
+    return;
+  }
+  h = p->unit * 8 + (offset - 0x10) / 0x18;
+  if ((SIM_REG32(p->base + offset) & DMA_SxCR_EN) && !(before & DMA_SxCR_EN))
+  {
+    SIM_DmaStart(h);
+  }
+  else if (!(SIM_REG32(p->base + offset) & DMA_SxCR_EN))
+  {
+    sim_dma[h].busy = 0;
+  }
+}
+
+/**
+ * @brief 访问前刷新寄存器内容
+ */
+static void SIM_Refresh(SIM_Periph_t *p)
+{
+  switch (p->kind)
+  {
+  case SIM_K_GPIO:
+    SIM_GpioRefresh(p);
+    break;
+  case SIM_K_RCC:
+    SIM_RccSync();
+    break;
+  case SIM_K_TIM:
+  {
+    SIM_Tim_t *t = &sim_tims[p->unit];
+
+    if (t->running)
+    {
+      SIM_TimCatchUp(t);
+      SIM_PERIPH_REG(t->base, TIM_TypeDef, CNT) = (uint32_t)((sim_now - t->t_zero) / t->cpc);
+    }
+    break;
+  }
+  case SIM_K_USART:
+    SIM_UartRefresh(p);
+    break;
+  case SIM_K_SYSTICK:
+    SIM_StRefresh();
+    break;
+  case SIM_K_NVIC:
+    SIM_NvicRefresh();
+    break;
+  case SIM_K_SCB:
+    SIM_ScbRefresh();
+    break;
+  case SIM_K_DWT:
+    SIM_DwtRefresh();
+    break;
+  case SIM_K_RTC:
+    SIM_RtcRefresh();
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief 访问后执行副作用
+ * @param before 访问前的寄存器值（用于写1清零/写0清零的寄存器）
+ */
+static void SIM_Effect(SIM_Periph_t *p, uint32_t addr, uint8_t write, uint32_t before)
+{
+  uint32_t offset = addr - p->base;
+
+  switch (p->kind)
+  {
+  case SIM_K_GPIO:
+    if (write)
+    {
+      SIM_GpioWrite(p, offset);
+    }
+    break;
+  case SIM_K_RCC:
+    SIM_RccSync();
+    break;
+  case SIM_K_EXTI:
+    if (write && offset == offsetof(EXTI_TypeDef, PR))
+    {
+      SIM_REG32(addr) = before & ~SIM_REG32(addr); // 写1清零
+    }
+    else if (write && offset == offsetof(EXTI_TypeDef, SWIER))
+    {
+      SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, PR) |= SIM_REG32(addr) & SIM_PERIPH_REG(EXTI_BASE, EXTI_TypeDef, IMR);
+      SIM_REG32(addr) = 0;
+    }
+    break;
+  case SIM_K_TIM:
+    if (write)
+    {
+      SIM_Tim_t *t = &sim_tims[p->unit];
+
+      if (offset == offsetof(TIM_TypeDef, SR))
+      {
+        SIM_REG32(addr) = before & SIM_REG32(addr); // 写0清零
+      }
+      else if (offset == offsetof(TIM_TypeDef, EGR))
+      {
+        if (SIM_REG32(addr) & TIM_EGR_UG)
+        {
+          SIM_PERIPH_REG(t->base, TIM_TypeDef, CNT) = 0;
+          if (!(SIM_PERIPH_REG(t->base, TIM_TypeDef, CR1) & TIM_CR1_URS))
+          {
+            SIM_PERIPH_REG(t->base, TIM_TypeDef, SR) |= TIM_SR_UIF;
+          }
+          SIM_TimUpdateDma(t, 1);
+        }
+        SIM_REG32(addr) = 0;
+      }
+      SIM_TimResync(t);
+    }
+    break;
+  case SIM_K_USART:
+    SIM_UartAccess(p, offset, write);
+    SIM_UartRefresh(p);
+    break;
+  case SIM_K_SYSTICK:
+    SIM_StAccess(offset, write);
+    break;
+  case SIM_K_NVIC:
+    if (write)
+    {
+      SIM_NvicWrite(offset);
+    }
+    break;
+  case SIM_K_SCB:
+    if (write)
+    {
+      SIM_ScbWrite(offset);
+    }
+    break;
+  case SIM_K_DWT:
+    if (write)
+    {
+      SIM_DwtWrite(offset);
+    }
+    break;
+  case SIM_K_RTC:
+    if (write)
+    {
+      SIM_RtcWrite(offset, before);
+    }
+    break;
+  case SIM_K_DMA:
+    if (write)
+    {
+      SIM_DmaWrite(p, offset, before);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               访问陷入                                    */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief 记账并推进虚拟时钟
+ */
+static void SIM_Account(SIM_Periph_t *p, uint32_t addr, uint8_t write, uintptr_t pc)
+{
+  uint64_t skip = 0;
+  uint64_t target;
+
+  if (write)
+  {
+    p->writes++;
+  }
+  else
+  {
+    p->reads++;
+  }
+  p->cycles += p->cost;
+  sim_accesses++;
+
+  // 同一指令连续轮询同一寄存器：按已轮询时间的1/8加速推进
+  if (!write && pc == sim_poll_pc && addr == sim_poll_addr)
+  {
+    skip = (sim_now - sim_poll_start) / 8;
+  }
+  else
+  {
+    sim_poll_pc = write ? 0 : pc;
+    sim_poll_addr = addr;
+    sim_poll_start = sim_now;
+  }
+
+  target = sim_now + p->cost;
+  if (skip)
+  {
+    uint64_t ev = SIM_NextEvent();
+
+    target += skip;
+    if (target > ev)
+    {
+      target = ev > sim_now + p->cost ? ev : sim_now + p->cost;
+    }
+    sim_poll_cycles += target - sim_now - p->cost;
+  }
+  SIM_AdvanceTo(target);
+}
+
+static void SIM_OnSegv(int sig, siginfo_t *si, void *ctx)
+{
+  ucontext_t *uc = (ucontext_t *)ctx;
+  uintptr_t fault = (uintptr_t)si->si_addr;
+  SIM_Region_t *r = SIM_FindRegion(fault);
+  SIM_Step_t *step;
+  SIM_Periph_t *p;
+  uint32_t addr = (uint32_t)fault;
+
+  (void)sig;
+  if (r == 0 || sim_step_num >= SIM_STEP_MAX)
+  {
+    // 非外设地址：恢复默认处理，返回后重新执行该指令产生真正的段错误
+    signal(SIGSEGV, SIG_DFL);
+    return;
+  }
+
+  step = &sim_steps[sim_step_num++];
+  step->page = fault & ~(SIM_PAGE - 1);
+  step->write = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+  step->bb = 0;
+
+  if (r->base == PERIPH_BB_BASE)
+  {
+    // 位带别名：换算为目标字与位，按目标外设记账
+    uint32_t target = PERIPH_BASE + ((addr - PERIPH_BB_BASE) >> 5);
+
+    step->bb = addr & ~3U;
+    step->bit = (uint8_t)((target & 3) * 8 + ((addr >> 2) & 7));
+    addr = target;
+  }
+  step->addr = addr & ~3U;
+
+  p = SIM_FindPeriph(step->addr);
+  SIM_Account(p, step->addr, step->write, (uintptr_t)uc->uc_mcontext.gregs[REG_RIP]);
+  SIM_Refresh(p);
+  step->before = SIM_REG32(step->addr);
+  if (step->bb)
+  {
+    SIM_REG32(step->bb) = (step->before >> step->bit) & 1;
+  }
+
+  mprotect((void *)step->page, SIM_PAGE, PROT_READ | PROT_WRITE);
+  uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+}
+
+static void SIM_OnTrap(int sig, siginfo_t *si, void *ctx)
+{
+  ucontext_t *uc = (ucontext_t *)ctx;
+  SIM_Step_t steps[SIM_STEP_MAX];
+  int n = sim_step_num;
+  int i;
+
+  (void)sig;
+  (void)si;
+  uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+  if (n == 0)
+  {
+    return;
+  }
+
+  // 先恢复保护并释放单步记录，副作用与中断分发中的新访问可以再次陷入
+  memcpy(steps, sim_steps, sizeof(steps[0]) * n);
+  sim_step_num = 0;
+  for (i = 0; i < n; i++)
+  {
+    mprotect((void *)steps[i].page, SIM_PAGE, PROT_NONE);
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    SIM_Step_t *s = &steps[i];
+
+    if (s->bb && s->write)
+    {
+      uint32_t v = SIM_REG32(s->addr);
+
+      v = (SIM_REG32(s->bb) & 1) ? v | (1UL << s->bit) : v & ~(1UL << s->bit);
+      SIM_REG32(s->addr) = v;
+    }
+    SIM_Effect(SIM_FindPeriph(s->addr), s->addr, s->write, s->before);
+  }
+
+  SIM_UpdateLevels();
+  SIM_CheckEnd();
+  SIM_Deliver();
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               接口                                        */
+/* ------------------------------------------------------------------------ */
+
+int SIM_Init(void)
+{
+  struct sigaction sa;
+  uint32_t i;
+
+  for (i = 0; i < SIM_REGION_NUM; i++)
+  {
+    SIM_Region_t *r = &sim_regions[i];
+    int fd = memfd_create("sim-periph", 0);
+    void *fixed;
+
+    if (fd < 0 || ftruncate(fd, r->size) != 0)
+    {
+      perror("sim: memfd");
+      return -1;
+    }
+    fixed = mmap((void *)(uintptr_t)r->base, r->size, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    r->alias = mmap(0, r->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (fixed != (void *)(uintptr_t)r->base || r->alias == MAP_FAILED)
+    {
+      fprintf(stderr, "sim: cannot map peripheral region 0x%08x (link with -no-pie)\n", (unsigned)r->base);
+      return -1;
+    }
+  }
+
+  // 复位值
+  SIM_PERIPH_REG(RCC_BASE, RCC_TypeDef, CR) = RCC_CR_HSION | RCC_CR_HSIRDY;
+  SIM_PERIPH_REG(SCB_BASE, SCB_Type, CPUID) = 0x410FC241;
+  for (i = 0; i < SIM_IRQ_NUM; i++)
+  {
+    __Vectors[SIM_EXC_IRQ0 + i] = (uint32_t)(uintptr_t)sim_vectors[i];
+  }
+  __Vectors[SIM_EXC_SYSTICK] = (uint32_t)(uintptr_t)SysTick_Handler;
+  SIM_PERIPH_REG(SCB_BASE, SCB_Type, VTOR) = (uint32_t)(uintptr_t)__Vectors;
+  for (i = 0; i < SIM_STACK_SIZE / 4; i++)
+  {
+    __stack_base[i] = STACK_PAINT;
+  }
+  for (i = 0; i < SIM_HEAP_SIZE / 4; i++)
+  {
+    __heap_base[i] = STACK_PAINT;
+  }
+  sim_st.div = 8;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_sigaction = SIM_OnSegv;
+  sigaction(SIGSEGV, &sa, 0);
+  sa.sa_sigaction = SIM_OnTrap;
+  sigaction(SIGTRAP, &sa, 0);
+  return 0;
+}
+
+void SIM_SetEndTime(uint64_t us)
+{
+  sim_end_ns = us * 1000;
+}
+
+static int SIM_StimCompare(const void *a, const void *b)
+{
+  const SIM_Stim_t *x = (const SIM_Stim_t *)a;
+  const SIM_Stim_t *y = (const SIM_Stim_t *)b;
+
+  return x->ns < y->ns ? -1 : (x->ns > y->ns ? 1 : 0);
+}
+
+/**
+ * @brief 按时间插入激励；同一时刻按加入顺序生效，早于当前时刻的在下一次处理事件时生效
+ */
+static void SIM_InsertStim(const SIM_Stim_t *s)
+{
+  size_t j;
+
+  sim_stims = realloc(sim_stims, (sim_stim_num + 1) * sizeof(*sim_stims));
+  for (j = sim_stim_num; j > sim_stim_next && SIM_StimCompare(&sim_stims[j - 1], s) > 0; j--)
+  {
+    sim_stims[j] = sim_stims[j - 1];
+  }
+  sim_stims[j] = *s;
+  sim_stim_num++;
+}
+
+int SIM_LoadStimuli(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  char line[512];
+  unsigned lineno = 0;
+
+  if (f == 0)
+  {
+    perror(path);
+    return -1;
+  }
+
+  while (fgets(line, sizeof(line), f))
+  {
+    unsigned long long us;
+    char what[16];
+    int used = 0;
+    SIM_Stim_t s;
+    uint32_t i;
+
+    lineno++;
+    if (line[0] == '#' || sscanf(line, "%llu %15s %n", &us, what, &used) < 2)
+    {
+      continue;
+    }
+
+    memset(&s, 0, sizeof(s));
+    s.ns = us * 1000;
+    s.uart = 0xFF;
+    for (i = 0; i < SIM_UART_NUM; i++)
+    {
+      if (strcmp(what, sim_uarts[i].name) == 0)
+      {
+        char *src = line + used;
+        char *dst;
+
+        s.uart = (uint8_t)i;
+        s.text = strdup(src);
+        for (dst = s.text; *src && *src != '\n'; src++)
+        {
+          if (src[0] == '\\' && src[1] == 'n')
+          {
+            *dst++ = '\n';
+            src++;
+          }
+          else
+          {
+            *dst++ = *src;
+          }
+        }
+        *dst = 0;
+      }
+    }
+    if (s.uart == 0xFF)
+    {
+      unsigned pin;
+      unsigned level;
+
+      if (what[0] != 'P' || what[1] < 'A' || what[1] >= 'A' + SIM_GPIO_NUM || sscanf(what + 2, "%u", &pin) != 1 ||
+          pin > 15 || sscanf(line + used, "%u", &level) != 1)
+      {
+        fprintf(stderr, "%s:%u: bad stimulus\n", path, lineno);
+        fclose(f);
+        return -1;
+      }
+      s.port = (uint8_t)(what[1] - 'A');
+      s.pin = (uint8_t)pin;
+      s.level = level != 0;
+    }
+
+    SIM_InsertStim(&s);
+  }
+  fclose(f);
+  return 0;
+}
+
+void SIM_AddStimulus(uint64_t us, uint8_t port, uint8_t pin, uint8_t level)
+{
+  SIM_Stim_t s;
+
+  memset(&s, 0, sizeof(s));
+  s.ns = us * 1000;
+  s.uart = 0xFF;
+  s.port = port;
+  s.pin = pin;
+  s.level = level != 0;
+  SIM_InsertStim(&s);
+}
+
+void SIM_SetTrace(FILE *f)
+{
+  sim_trace = f;
+}
+
+SIM_End SIM_Run(void (*entry)(void))
+{
+  int r = sigsetjmp(sim_exit_jmp, 1);
+
+  if (r == 0)
+  {
+    sim_in_run = 1;
+    entry();
+    sim_in_run = 0;
+    return SIM_END_RETURN;
+  }
+
+  // 从中断或陷入处理中跳出：清除活动异常
+  sim_in_run = 0;
+  sim_act_depth = 0;
+  memset(sim_nvic_act, 0, sizeof(sim_nvic_act));
+  return (SIM_End)(r - 1);
+}
+
+uint64_t SIM_GetCycles(void)
+{
+  return sim_now;
+}
+
+void SIM_SetDmaHook(SIM_DmaHook hook)
+{
+  sim_dma_hook = hook;
+}
+
+uint32_t SIM_GetDmaStaleStarts(void)
+{
+  return sim_dma_stale;
+}
+
+uint64_t SIM_GetTimeNs(void)
+{
+  return sim_ns;
+}
+
+void SIM_MeterBegin(SIM_Meter_t *m)
+{
+  m->cycles = sim_now;
+  m->accesses = sim_accesses;
+}
+
+void SIM_MeterEnd(SIM_Meter_t *m)
+{
+  m->cycles = sim_now - m->cycles;
+  m->accesses = sim_accesses - m->accesses;
+}
+
+void SIM_Report(FILE *f)
+{
+  uint32_t i;
+
+  fprintf(f, "sim.cycles=%llu\n", (unsigned long long)sim_now);
+  fprintf(f, "sim.time_us=%llu\n", (unsigned long long)(sim_ns / 1000));
+  fprintf(f, "sim.hclk_hz=%u\n", (unsigned)SIM_Hclk());
+  fprintf(f, "sim.accesses=%llu\n", (unsigned long long)sim_accesses);
+  fprintf(f, "sim.idle_cycles=%llu\n", (unsigned long long)sim_idle_cycles);
+  fprintf(f, "sim.stop_us=%llu\n", (unsigned long long)(sim_stop_ns / 1000));
+  fprintf(f, "sim.poll_cycles=%llu\n", (unsigned long long)sim_poll_cycles);
+  fprintf(f, "sim.dma_bytes=%llu\n", (unsigned long long)sim_dma_bytes);
+  fprintf(f, "sim.dma_stale_starts=%u\n", (unsigned)sim_dma_stale);
+
+  for (i = 0; i < SIM_PERIPH_NUM; i++)
+  {
+    SIM_Periph_t *p = &sim_periphs[i];
+
+    if (p->reads || p->writes)
+    {
+      fprintf(f, "access.%s.reads=%llu\n", p->name, (unsigned long long)p->reads);
+      fprintf(f, "access.%s.writes=%llu\n", p->name, (unsigned long long)p->writes);
+      fprintf(f, "access.%s.cycles=%llu\n", p->name, (unsigned long long)p->cycles);
+    }
+  }
+
+  if (sim_exc_count[SIM_EXC_SYSTICK])
+  {
+    fprintf(f, "irq.SysTick.count=%llu\n", (unsigned long long)sim_exc_count[SIM_EXC_SYSTICK]);
+  }
+  for (i = 0; i < SIM_IRQ_NUM; i++)
+  {
+    if (sim_exc_count[SIM_EXC_IRQ0 + i])
+    {
+      fprintf(f, "irq.%s.count=%llu\n", sim_irq_names[i], (unsigned long long)sim_exc_count[SIM_EXC_IRQ0 + i]);
+    }
+  }
+
+  for (i = 0; i < SIM_UART_NUM; i++)
+  {
+    SIM_Uart_t *u = &sim_uarts[i];
+    size_t k;
+
+    if (u->tx_len == 0)
+    {
+      continue;
+    }
+    fprintf(f, "uart.%s.tx=", u->name);
+    for (k = 0; k < u->tx_len; k++)
+    {
+      unsigned char c = (unsigned char)u->tx[k];
+
+      if (c == '\n')
+      {
+        fputs("\\n", f);
+      }
+      else if (c == '\\')
+      {
+        fputs("\\\\", f);
+      }
+      else if (c < 0x20 || c >= 0x7F)
+      {
+        fprintf(f, "\\x%02x", c);
+      }
+      else
+      {
+        fputc(c, f);
+      }
+    }
+    fputc('\n', f);
+  }
+}
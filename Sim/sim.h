@@ -0,0 +1,161 @@
+/**
+ * @file sim.h
+ * @brief 主机端外设寄存器仿真器
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 把固件（User/ 与标准外设库）原样编译为 x86-64 Linux 程序运行：
+ * 外设地址空间（0x40000000 APB/AHB1、0x42000000 位带、0x50000000 AHB2、
+ * 0xE0000000 内核外设）按原地址映射，布局与 stm32f4xx.h 中的
+ * *_TypeDef 完全一致。映射页设为不可访问，每次寄存器访问触发
+ * SIGSEGV，仿真器记账、刷新寄存器值后单步执行该指令（SIGTRAP），
+ * 再执行写入的副作用。仿真器自身经由同一内存的另一可读写映射访问
+ * 寄存器，不会触发陷入。
+ *
+ * 已建模：GPIO(ODR/BSRR/IDR)、RCC(就绪位/时钟切换)、EXTI、SYSCFG、
+ * SysTick、NVIC/SCB(ICSR/SLEEPONEXIT)、DWT(CYCCNT)、通用/基本/高级定时器的
+ * 计数与更新事件、USART收发、RTC(日历秒/亚秒与唤醒定时器，经EXTI线22)；
+ * SLEEPDEEP置位时WFI按STOP处理：内核时钟域（SysTick/定时器/DWT）停止，
+ * 唤醒后系统时钟为HSI，HSE与PLL关闭；其余外设寄存器按普通内存处理，
+ * 基本定时器(TIM6/TIM7)的更新DMA请求逐项搬运，过半/完成时置HTIF/TCIF，
+ * 其余DMA外设请求只保存寄存器，不搬运数据；DMA2存储器到存储器传输按
+ * 数据项与突发数计时（每项2周期，每次突发另加2周期），到期时一次搬运
+ * 并置TCIF/HTIF，按中断使能位挂起数据流中断。
+ *
+ * 虚拟时钟以CPU周期计：每次寄存器访问按所在总线计入固定周期数，
+ * WFI推进到下一个事件，纯计算代码不计时。同一指令反复轮询同一寄存器
+ * 时按已轮询时间的1/8加速推进，忙等延时不会逐周期陷入。
+ */
+
+#ifndef _SIM_H_
+#define _SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @defgroup SIM_Cost 每次寄存器访问计入的周期数
+ * @{
+ */
+#define SIM_COST_CORE 1 ///< 内核外设（SCS/DWT）
+#define SIM_COST_AHB 2  ///< AHB1/AHB2外设（GPIO/RCC/DMA）
+#define SIM_COST_APB2 3 ///< APB2外设
+#define SIM_COST_APB1 5 ///< APB1外设
+/** @} */
+
+/**
+ * @brief 运行结束原因
+ */
+typedef enum
+{
+  SIM_END_TIME = 0, ///< 到达结束时间
+  SIM_END_RETURN,   ///< 入口函数返回
+  SIM_END_IDLE      ///< WFI时没有任何未来事件
+} SIM_End;
+
+/**
+ * @brief 开销计量
+ */
+typedef struct
+{
+  uint64_t cycles;   ///< 虚拟周期
+  uint64_t accesses; ///< 寄存器访问次数
+} SIM_Meter_t;
+
+/**
+ * @brief 初始化仿真器：映射外设地址空间并安装陷入处理
+ * @retval 0: 成功，-1: 失败（错误信息已输出到stderr）
+ */
+int SIM_Init(void);
+
+/**
+ * @brief 设置结束时间
+ * @param us 虚拟时间（微秒），0表示不限
+ */
+void SIM_SetEndTime(uint64_t us);
+
+/**
+ * @brief 加载引脚/串口激励脚本
+ * @param path 脚本路径
+ * @retval 0: 成功，-1: 失败
+ * @note 每行一条：`<时间us> P<端口><引脚> <0|1>` 或 `<时间us> USART<n> <文本>`，
+ *       文本中 \n 转义为换行；# 开头为注释
+ */
+int SIM_LoadStimuli(const char *path);
+
+/**
+ * @brief 加入一条引脚激励
+ * @param us 生效时刻（虚拟时间，微秒）
+ * @param port 端口编号（0为GPIOA）
+ * @param pin 引脚号
+ * @param level 输入电平
+ * @note 供测试用例在运行中按脚本产生抖动波形
+ */
+void SIM_AddStimulus(uint64_t us, uint8_t port, uint8_t pin, uint8_t level);
+
+/**
+ * @brief 设置输出跟踪文件，GPIO输出变化按 `gpio t_us=.. port=.. odr=..` 逐行写入
+ * @param f 文件，NULL关闭跟踪
+ */
+void SIM_SetTrace(FILE *f);
+
+/**
+ * @brief 运行入口函数直至其返回或满足结束条件
+ * @param entry 入口函数（通常为固件的main）
+ * @retval 结束原因
+ */
+SIM_End SIM_Run(void (*entry)(void));
+
+/**
+ * @brief 获取当前虚拟周期数
+ */
+uint64_t SIM_GetCycles(void);
+
+/**
+ * @brief 获取当前虚拟时间（纳秒）
+ */
+uint64_t SIM_GetTimeNs(void);
+
+/**
+ * @brief DMA写入外设寄存器的回调
+ * @param addr 外设寄存器地址
+ * @param value 写入值
+ * @param us 虚拟时间（微秒）
+ */
+typedef void (*SIM_DmaHook)(uint32_t addr, uint32_t value, uint64_t us);
+
+/**
+ * @brief 登记DMA写入外设寄存器的回调，NULL取消
+ * @note 在仿真器内部调用，回调中不能访问外设寄存器
+ */
+void SIM_SetDmaHook(SIM_DmaHook hook);
+
+/**
+ * @brief 设置 __get_MSP() 的返回值
+ * @param msp 固件栈区(__stack_base ~ __initial_sp)内的地址，0恢复为不在栈区
+ * @note 固件实际运行在主机栈上，只用于驱动 myStack 的探针
+ */
+void SIM_SetMsp(uint32_t msp);
+
+/**
+ * @brief 获取DMA数据流在事件标志未清除时被使能的次数
+ */
+uint32_t SIM_GetDmaStaleStarts(void);
+
+/**
+ * @brief 开始计量
+ */
+void SIM_MeterBegin(SIM_Meter_t *m);
+
+/**
+ * @brief 结束计量，m 中保存开始以来的增量
+ */
+void SIM_MeterEnd(SIM_Meter_t *m);
+
+/**
+ * @brief 输出统计报告（每行一个 key=value）
+ */
+void SIM_Report(FILE *f);
+
+#endif
@@ -0,0 +1,452 @@
+/**
+ * @file sim_main.c
+ * @brief 主机仿真入口：运行固件main或驱动调用基准
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 用法：sim [-t 毫秒] [-s 激励脚本] [-o 跟踪文件] [-b] [-T 用例]
+ *   -t  虚拟运行时间，默认1000ms
+ *   -s  引脚/串口激励脚本，格式见 SIM_LoadStimuli()
+ *   -o  GPIO输出变化跟踪文件
+ *   -b  不运行main，改为测量板级驱动调用的寄存器访问次数与周期数
+ *   -T  不运行main，改为运行测试用例（见 sim_test.c），有检查失败时返回1
+ * 结果以 key=value 逐行输出到标准输出。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "stm32f4xx.h"
+#include "sim.h"
+#include "sim_test.h"
+#include "myInit/myInit.h"
+#include "myTime/myTime.h"
+#include "myKey/myKey.h"
+#include "mySched/mySched.h"
+#include "myBoot/myBoot.h"
+#include "myClock/myClock.h"
+#include "stm32f4xx_pll_conf.h"
+#include "myIdle/myIdle.h"
+#include "myDma/myDma.h"
+#include "myCopy/myCopy.h"
+#include "myVec/myVec.h"
+
+extern int fw_main(void); ///< 固件main，编译User/main.c时重命名
+
+static void SIM_FirmwareMain(void)
+{
+  fw_main();
+}
+
+/**
+ * @brief 报告调度器统计：主循环延迟与任务运行时间
+ */
+static void SIM_ReportSched(FILE *f)
+{
+  const SCHED_Stats_t *st;
+  uint8_t id;
+
+  for (id = 0; (st = SCHED_GetStats(id)) != 0; id++)
+  {
+    fprintf(f, "sched.%u.runs=%u\n", id, (unsigned)st->runs);
+    fprintf(f, "sched.%u.run_max_cycles=%u\n", id, (unsigned)st->run_max);
+    fprintf(f, "sched.%u.latency_max_cycles=%u\n", id, (unsigned)st->latency_max);
+    if (st->runs)
+    {
+      fprintf(f, "sched.%u.latency_avg_cycles=%llu\n", id, (unsigned long long)(st->latency_total / st->runs));
+    }
+  }
+  fprintf(f, "sched.idle_cycles=%llu\n", (unsigned long long)SCHED_GetIdleCycles());
+}
+
+/**
+ * @brief 报告启动阶段耗时
+ */
+static void SIM_ReportBoot(FILE *f)
+{
+  BOOT_Report_t rep;
+
+  BOOT_GetReport(&rep);
+  fprintf(f, "boot.sysinit_us=%u\n", (unsigned)rep.sysinit_us);
+  fprintf(f, "boot.cinit_us=%u\n", (unsigned)rep.cinit_us);
+  fprintf(f, "boot.app_us=%u\n", (unsigned)rep.app_us);
+  fprintf(f, "boot.total_us=%u\n", (unsigned)rep.total_us);
+}
+
+/**
+ * @brief 报告编译期求解的PLL参数与频率误差
+ */
+static void SIM_ReportClock(FILE *f)
+{
+  fprintf(f, "clock.pll.m=%u\n", (unsigned)CLOCK_PLL_M);
+  fprintf(f, "clock.pll.n=%u\n", (unsigned)CLOCK_PLL_N);
+  fprintf(f, "clock.pll.p=%u\n", (unsigned)CLOCK_PLL_P);
+  fprintf(f, "clock.pll.q=%u\n", (unsigned)CLOCK_PLL_Q);
+  fprintf(f, "clock.sysclk_err_hz=%d\n", (int)CLOCK_SYSCLK_ERR_HZ);
+  fprintf(f, "clock.usb_err_hz=%d\n", (int)CLOCK_USB_ERR_HZ);
+  fprintf(f, "clock.plli2s.n=%u\n", (unsigned)CLOCK_PLLI2S_N);
+  fprintf(f, "clock.plli2s.r=%u\n", (unsigned)CLOCK_PLLI2S_R);
+  fprintf(f, "clock.i2s_err_hz=%d\n", (int)CLOCK_I2S_ERR_HZ);
+}
+
+/**
+ * @brief 报告空闲管理统计：各睡眠方式次数与STOP时间
+ */
+static void SIM_ReportIdle(FILE *f)
+{
+  static const char *const mode_names[IDLE_MODE_NUM] = {"wfi", "sleep_on_exit", "stop"};
+  const IDLE_Stats_t *st = IDLE_GetStats();
+  uint8_t m;
+
+  for (m = 0; m < IDLE_MODE_NUM; m++)
+  {
+    fprintf(f, "idle.%s.count=%u\n", mode_names[m], (unsigned)st->count[m]);
+  }
+  fprintf(f, "idle.stop_ms=%llu\n", (unsigned long long)st->stop_ms);
+  fprintf(f, "idle.early_wakes=%u\n", (unsigned)st->early_wakes);
+  fprintf(f, "idle.resume_max_us=%u\n", (unsigned)st->resume_max_us);
+  fprintf(f, "idle.tick_ms=%llu\n", (unsigned long long)TIME_GetTick());
+  fprintf(f, "idle.latency_us=%u\n", (unsigned)IDLE_GetLatency());
+}
+
+/**
+ * @brief 报告DMA数据流分配：各数据流的使用者与冲突次数
+ */
+static void SIM_ReportDma(FILE *f)
+{
+  const char *owner;
+  uint8_t h;
+
+  for (h = 0; h < DMAM_STREAM_NUM; h++)
+  {
+    if ((owner = DMAM_GetOwner(h)) != 0)
+    {
+      fprintf(f, "dma.DMA%u_Stream%u.owner=%s\n", h / 8 + 1, h % 8, owner);
+    }
+  }
+  fprintf(f, "dma.conflicts=%u\n", (unsigned)DMAM_GetConflictCount());
+}
+
+static void SIM_BenchOne(const char *name, void (*fn)(void), uint32_t repeat)
+{
+  SIM_Meter_t m;
+  uint32_t i;
+
+  SIM_MeterBegin(&m);
+  for (i = 0; i < repeat; i++)
+  {
+    fn();
+  }
+  SIM_MeterEnd(&m);
+  printf("bench.%s.cycles_per_call=%llu\n", name, (unsigned long long)(m.cycles / repeat));
+  printf("bench.%s.accesses_per_call=%llu\n", name, (unsigned long long)(m.accesses / repeat));
+}
+
+static void Bench_BoardInit(void)
+{
+  BOARD_Init();
+}
+
+static void Bench_BankWrite(void)
+{
+  PIN_BankWrite(BOARD_LED_MASK, BOARD_LED_MASK);
+}
+
+static void Bench_PinWrite(void)
+{
+  PIN_Write(BOARD_LED0, 1);
+}
+
+static void Bench_PinRead(void)
+{
+  (void)PIN_Read(BOARD_KEY0);
+}
+
+static void Bench_GetUs(void)
+{
+  (void)TIME_GetUs();
+}
+
+static void Bench_KeyTick(void)
+{
+  KEY_Tick();
+}
+
+static void Bench_GetClocks(void)
+{
+  RCC_ClocksTypeDef clocks;
+
+  RCC_GetClocksFreq(&clocks);
+}
+
+static void Bench_GetClocksCold(void)
+{
+  RCC_ClocksCacheInvalidate();
+  Bench_GetClocks();
+}
+
+static void Bench_UsartInit(void)
+{
+  USART_InitTypeDef USART_InitStructure;
+
+  USART_StructInit(&USART_InitStructure);
+  USART_Init(USART1, &USART_InitStructure);
+}
+
+static void Bench_UsartInitCold(void)
+{
+  RCC_ClocksCacheInvalidate();
+  Bench_UsartInit();
+}
+
+static void Bench_GetTree(void)
+{
+  (void)CLOCK_GetTree();
+}
+
+static uint8_t bench_src[4096 + 3];
+static uint8_t bench_dst[4096 + 3];
+
+/**
+ * @brief 4KB拷贝：源与目的字对齐
+ */
+static void Bench_CopyWord(void)
+{
+  COPY_Wait(COPY_Memcpy(bench_dst, bench_src, 4096, 0, 0));
+}
+
+/**
+ * @brief 4KB拷贝：源与目的相差1字节，只能按字节传输
+ */
+static void Bench_CopyByte(void)
+{
+  COPY_Wait(COPY_Memcpy(bench_dst + 1, bench_src + 2, 4096, 0, 0));
+}
+
+static void Bench_Fill(void)
+{
+  COPY_Wait(COPY_Memset(bench_dst + 3, 0x5A, 4096, 0, 0));
+}
+
+/**
+ * @brief 检查拷贝与填充结果
+ */
+static int SIM_CopyCheck(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < sizeof(bench_src); i++)
+  {
+    bench_src[i] = (uint8_t)(i * 7 + 1);
+  }
+  memset(bench_dst, 0, sizeof(bench_dst));
+  Bench_CopyByte();
+  if (memcmp(bench_dst + 1, bench_src + 2, 4096) != 0 || bench_dst[0] != 0 || bench_dst[4097] != 0)
+  {
+    return 0;
+  }
+  Bench_Fill();
+  for (i = 3; i < 4096 + 3; i++)
+  {
+    if (bench_dst[i] != 0x5A)
+    {
+      return 0;
+    }
+  }
+  return bench_dst[2] == bench_src[3];
+}
+
+/**
+ * @brief 输出一种传输的自动配置结果
+ * @param offset 存储器地址相对16字节对齐的偏移
+ */
+static void SIM_TuneOne(const char *name, uint32_t dir, uint32_t par, uint32_t psize, uint32_t offset, uint32_t items)
+{
+  static const unsigned beats[4] = {1, 4, 8, 16};
+  DMA_InitTypeDef init;
+  DMAM_TuneReport_t r;
+  ErrorStatus ok;
+
+  DMA_StructInit(&init);
+  init.DMA_DIR = dir;
+  init.DMA_PeripheralBaseAddr = par;
+  init.DMA_PeripheralDataSize = psize;
+  init.DMA_Memory0BaseAddr = (((uint32_t)bench_dst + 15) & ~15UL) + offset;
+  init.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  init.DMA_BufferSize = items;
+  ok = DMAM_Tune(&init, &r);
+  printf("bench.DMAM_Tune.%s=valid=%d msize=%u mburst=%u fifo=%d beats=%u->%u bursts=%u saved=%u\n", name,
+         ok == SUCCESS, 1u << (init.DMA_MemoryDataSize >> 13), beats[init.DMA_MemoryBurst >> 23],
+         init.DMA_FIFOMode == DMA_FIFOMode_Enable, (unsigned)r.base_beats, (unsigned)r.beats, (unsigned)r.bursts,
+         (unsigned)r.beats_saved);
+}
+
+/**
+ * @brief 检查 DMAM_Validate() 拒绝表48中的非法组合
+ */
+static int SIM_ValidateCheck(void)
+{
+  DMA_InitTypeDef init;
+  uint32_t buf = ((uint32_t)bench_dst + 15) & ~15UL;
+  int ok = 1;
+
+  DMA_StructInit(&init);
+  init.DMA_DIR = DMA_DIR_PeripheralToMemory;
+  init.DMA_Memory0BaseAddr = buf;
+  init.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  init.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+  init.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+  init.DMA_BufferSize = 256;
+  ok &= DMAM_Validate(&init) == SUCCESS;
+  // 直接模式不能突发
+  init.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
+  ok &= DMAM_Validate(&init) == ERROR;
+  // 字INC4（16字节）只能用满门限
+  init.DMA_FIFOMode = DMA_FIFOMode_Enable;
+  init.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+  ok &= DMAM_Validate(&init) == ERROR;
+  init.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+  ok &= DMAM_Validate(&init) == SUCCESS;
+  // 突发不对齐
+  init.DMA_Memory0BaseAddr = buf + 4;
+  ok &= DMAM_Validate(&init) == ERROR;
+  // 长度不是突发的整数倍
+  init.DMA_Memory0BaseAddr = buf;
+  init.DMA_BufferSize = 255;
+  ok &= DMAM_Validate(&init) == ERROR;
+  // 半字INC8（16字节）超过3/4门限
+  init.DMA_BufferSize = 256;
+  init.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+  init.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+  init.DMA_MemoryBurst = DMA_MemoryBurst_INC8;
+  init.DMA_FIFOThreshold = DMA_FIFOThreshold_3QuartersFull;
+  ok &= DMAM_Validate(&init) == ERROR;
+  // 存储器到存储器不能用直接模式
+  init.DMA_DIR = DMA_DIR_MemoryToMemory;
+  init.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+  init.DMA_FIFOMode = DMA_FIFOMode_Disable;
+  ok &= DMAM_Validate(&init) == ERROR;
+  return ok;
+}
+
+/**
+ * @brief 驱动调用基准，关中断运行，结果不含中断开销
+ */
+static void SIM_Bench(void)
+{
+  TIME_Init();
+  BOARD_Init();
+  KEY_EngineInit();
+
+  __disable_irq();
+  SIM_BenchOne("BOARD_Init", Bench_BoardInit, 16);
+  SIM_BenchOne("PIN_BankWrite", Bench_BankWrite, 256);
+  SIM_BenchOne("PIN_Write", Bench_PinWrite, 256);
+  SIM_BenchOne("PIN_Read", Bench_PinRead, 256);
+  SIM_BenchOne("TIME_GetUs", Bench_GetUs, 256);
+  SIM_BenchOne("KEY_Tick", Bench_KeyTick, 256);
+  // *_Cold 在每次调用前使时钟缓存失效，即缓存前的开销
+  SIM_BenchOne("RCC_GetClocksFreq", Bench_GetClocks, 256);
+  SIM_BenchOne("RCC_GetClocksFreq_Cold", Bench_GetClocksCold, 256);
+  SIM_BenchOne("USART_Init", Bench_UsartInit, 256);
+  SIM_BenchOne("USART_Init_Cold", Bench_UsartInitCold, 256);
+  SIM_BenchOne("CLOCK_GetTree", Bench_GetTree, 256);
+  __enable_irq();
+
+  // DMA拷贝依赖完成中断，开中断运行
+  VEC_Init();
+  COPY_Init();
+  printf("bench.COPY.ok=%d\n", SIM_CopyCheck());
+  SIM_BenchOne("COPY_Memcpy_4K", Bench_CopyWord, 16);
+  SIM_BenchOne("COPY_Memcpy_4K_Unaligned", Bench_CopyByte, 16);
+  SIM_BenchOne("COPY_Memset_4K", Bench_Fill, 16);
+
+  // DMA突发/FIFO自动配置：存储器端AHB拍数与突发数
+  printf("bench.DMAM_Validate.ok=%d\n", SIM_ValidateCheck());
+  SIM_TuneOne("USART_Rx_2K", DMA_DIR_PeripheralToMemory, (uint32_t)&USART1->DR, DMA_PeripheralDataSize_Byte, 0, 2048);
+  SIM_TuneOne("ADC_Halfword_1000", DMA_DIR_PeripheralToMemory, (uint32_t)&ADC1->DR, DMA_PeripheralDataSize_HalfWord,
+              0, 1000);
+  SIM_TuneOne("USART_Tx_Odd", DMA_DIR_MemoryToPeripheral, (uint32_t)&USART1->DR, DMA_PeripheralDataSize_Byte, 1, 2047);
+}
+
+int main(int argc, char **argv)
+{
+  static const char *const end_names[] = {"time", "return", "idle"};
+  uint64_t run_ms = 1000;
+  int bench = 0;
+  const char *test = 0;
+  void (*test_fn)(void) = 0;
+  int opt;
+  SIM_End end;
+
+  while ((opt = getopt(argc, argv, "t:s:o:bT:")) != -1)
+  {
+    switch (opt)
+    {
+    case 't':
+      run_ms = strtoull(optarg, 0, 0);
+      break;
+    case 's':
+      if (SIM_LoadStimuli(optarg) != 0)
+      {
+        return 1;
+      }
+      break;
+    case 'o':
+      SIM_SetTrace(fopen(optarg, "w"));
+      break;
+    case 'b':
+      bench = 1;
+      break;
+    case 'T':
+      test = optarg;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-t ms] [-s stimuli] [-o trace] [-b] [-T test]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (test && (test_fn = SIM_TestFind(test)) == 0)
+  {
+    fprintf(stderr, "unknown test '%s', available:\n", test);
+    SIM_TestList();
+    return 1;
+  }
+
+  if (SIM_Init() != 0)
+  {
+    return 1;
+  }
+  SIM_SetEndTime(run_ms * 1000);
+
+  // 同启动文件 Reset_Handler：从复位开始DWT计数，再执行 SystemInit()
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  SystemInit();
+  BOOT_Stamps[BOOT_STAMP_SYSINIT] = DWT->CYCCNT;
+
+  if (test_fn)
+  {
+    // 用例自行决定运行时长，-t 只作为防止挂起的上限
+    end = SIM_Run(test_fn);
+    printf("sim.end=%s\n", end_names[end]);
+    printf("test.%s.ok=%d\n", test, end == SIM_END_RETURN && SIM_TestFailures() == 0);
+    return end != SIM_END_RETURN || SIM_TestFailures() != 0;
+  }
+
+  end = SIM_Run(bench ? SIM_Bench : SIM_FirmwareMain);
+  printf("sim.end=%s\n", end_names[end]);
+  SIM_Report(stdout);
+  if (!bench)
+  {
+    SIM_ReportBoot(stdout);
+    SIM_ReportClock(stdout);
+    SIM_ReportSched(stdout);
+    SIM_ReportIdle(stdout);
+    SIM_ReportDma(stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,848 @@
+/**
+ * @file sim_test.c
+ * @brief 主机仿真测试用例实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include <string.h>
+
+#include "stm32f4xx.h"
+#include "sim.h"
+#include "sim_test.h"
+#include "myInit/myInit.h"
+#include "myTime/myTime.h"
+#include "myKey/myKey.h"
+#include "myVec/myVec.h"
+#include "myPool/myPool.h"
+#include "myCopy/myCopy.h"
+#include "myChain/myChain.h"
+#include "myStream/myStream.h"
+#include "myBeep/myBeep.h"
+#include "myStack/myStack.h"
+
+static unsigned sim_test_fail;
+
+/**
+ * @brief 检查条件，失败时输出所在行
+ */
+#define SIM_CHECK(cond) SIM_Check((cond) != 0, #cond, __LINE__)
+
+/**
+ * @brief 检查数值在[lo, hi]范围内，失败时输出实际值
+ */
+#define SIM_CHECK_RANGE(v, lo, hi) SIM_CheckRange((long)(v), (long)(lo), (long)(hi), #v, __LINE__)
+
+static void SIM_Check(int ok, const char *expr, int line)
+{
+  if (!ok)
+  {
+    sim_test_fail++;
+    fprintf(stderr, "sim_test.c:%d: check failed: %s\n", line, expr);
+  }
+}
+
+static void SIM_CheckRange(long v, long lo, long hi, const char *expr, int line)
+{
+  if (v < lo || v > hi)
+  {
+    sim_test_fail++;
+    fprintf(stderr, "sim_test.c:%d: %s=%ld not in [%ld, %ld]\n", line, expr, v, lo, hi);
+  }
+}
+
+/**
+ * @brief 当前虚拟时间（微秒）
+ */
+static uint64_t SIM_TestNowUs(void)
+{
+  return SIM_GetTimeNs() / 1000;
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               按键消抖                                    */
+/* ------------------------------------------------------------------------ */
+
+#define TEST_KEY_EVT_MAX 64
+
+static KEY_Event_t test_key_evts[TEST_KEY_EVT_MAX];
+static uint32_t test_key_num;
+
+/**
+ * @brief 产生一次带抖动的电平变化：先跳变，再两次反弹，2ms后稳定
+ * @param t0 测试起点（微秒）
+ * @param ms 首次跳变相对起点的时刻
+ * @param id 按键编号
+ * @param pressed 1: 按下（低电平），0: 释放
+ */
+static void Test_KeyBounce(uint64_t t0, uint32_t ms, uint8_t id, uint8_t pressed)
+{
+  static const uint32_t edges_us[5] = {0, 400, 1100, 1600, 2000};
+  const BOARD_Pin_t *pin = &BOARD_Pins[BOARD_KEY0 + id];
+  uint8_t port = (uint8_t)(((uint32_t)pin->port - GPIOA_BASE) >> 10);
+  uint8_t pos = (uint8_t)__CLZ(__RBIT(pin->mask));
+  uint8_t level = !pressed;
+  uint8_t i;
+
+  for (i = 0; i < 5; i++)
+  {
+    SIM_AddStimulus(t0 + ms * 1000ULL + edges_us[i], port, pos, (i & 1) ? !level : level);
+  }
+}
+
+/**
+ * @brief 运行到相对起点 ms 毫秒，期间取出全部按键事件
+ */
+static void Test_KeyRun(uint32_t tick0, uint32_t ms)
+{
+  KEY_Event_t evt;
+
+  while (TIME_GetTick32() - tick0 < ms)
+  {
+    __WFI();
+    while (KEY_GetEvent(&evt))
+    {
+      if (test_key_num < TEST_KEY_EVT_MAX)
+      {
+        test_key_evts[test_key_num] = evt;
+      }
+      test_key_num++;
+    }
+  }
+}
+
+/**
+ * @brief 按顺序取出某个按键的第n个事件
+ * @retval 事件，不存在时返回NULL
+ */
+static const KEY_Event_t *Test_KeyNth(uint8_t key, uint32_t n)
+{
+  uint32_t i;
+
+  for (i = 0; i < test_key_num && i < TEST_KEY_EVT_MAX; i++)
+  {
+    if (test_key_evts[i].key == key && n-- == 0)
+    {
+      return &test_key_evts[i];
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 检查某个按键的事件类型序列，返回各事件相对起点的时刻
+ */
+static void Test_KeyExpect(uint8_t key, const uint8_t *types, uint32_t n, uint32_t tick0, int32_t *at)
+{
+  const KEY_Event_t *e;
+  uint32_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    e = Test_KeyNth(key, i);
+    SIM_CHECK(e != 0);
+    if (e == 0)
+    {
+      at[i] = -100000;
+      continue;
+    }
+    SIM_CHECK(e->type == types[i]);
+    SIM_CHECK(e->mask == (1U << key));
+    at[i] = (int32_t)(e->tick - tick0);
+  }
+  SIM_CHECK(Test_KeyNth(key, n) == 0);
+}
+
+/**
+ * @brief 按键引擎：抖动波形下的按下/释放/长按/连发/双击时刻
+ * @note 消抖为4次采样（KEY_SCAN_MS间隔），确认时刻应在最后一次跳变后
+ *       12~16ms；节拍与激励时刻的相位差允许1ms误差
+ */
+static void Test_Key(void)
+{
+  static const uint8_t click[] = {KEY_EVT_PRESS, KEY_EVT_RELEASE};
+  static const uint8_t hold[] = {KEY_EVT_PRESS, KEY_EVT_LONG, KEY_EVT_REPEAT, KEY_EVT_REPEAT, KEY_EVT_RELEASE};
+  // KEY2：双击，随后的三连按只有第二次按下构成双击
+  static const uint8_t dbl[] = {KEY_EVT_PRESS,   KEY_EVT_RELEASE, KEY_EVT_PRESS,   KEY_EVT_DOUBLE,
+                                KEY_EVT_RELEASE, KEY_EVT_PRESS,   KEY_EVT_RELEASE, KEY_EVT_PRESS,
+                                KEY_EVT_DOUBLE,  KEY_EVT_RELEASE, KEY_EVT_PRESS,   KEY_EVT_RELEASE};
+  static const uint8_t two[] = {KEY_EVT_PRESS, KEY_EVT_RELEASE, KEY_EVT_PRESS, KEY_EVT_RELEASE};
+  const int32_t settle = 2; // 首次跳变到稳定的时间（ms，向上取整）
+  int32_t at[12];
+  uint64_t t0;
+  uint32_t tick0;
+
+  VEC_Init();
+  TIME_Init();
+  BOARD_Init();
+  KEY_EngineInit();
+  __enable_irq();
+
+  t0 = SIM_TestNowUs();
+  tick0 = TIME_GetTick32();
+
+  // KEY0：短按
+  Test_KeyBounce(t0, 10, 0, 1);
+  Test_KeyBounce(t0, 200, 0, 0);
+  // KEY1：按住 800ms 长按后再连发两次
+  Test_KeyBounce(t0, 300, 1, 1);
+  Test_KeyBounce(t0, 300 + KEY_LONG_MS + 2 * KEY_REPEAT_MS + 75, 1, 0);
+  // KEY2：释放后 KEY_DOUBLE_MS 内再次按下，构成双击
+  Test_KeyBounce(t0, 1600, 2, 1);
+  Test_KeyBounce(t0, 1680, 2, 0);
+  Test_KeyBounce(t0, 1800, 2, 1);
+  Test_KeyBounce(t0, 1880, 2, 0);
+  // KEY3：两次短按间隔超过 KEY_DOUBLE_MS，不构成双击
+  Test_KeyBounce(t0, 2000, 3, 1);
+  Test_KeyBounce(t0, 2080, 3, 0);
+  Test_KeyBounce(t0, 2500, 3, 1);
+  Test_KeyBounce(t0, 2580, 3, 0);
+  // KEY2：三次按下的间隔都在 KEY_DOUBLE_MS 内
+  Test_KeyBounce(t0, 2900, 2, 1);
+  Test_KeyBounce(t0, 2980, 2, 0);
+  Test_KeyBounce(t0, 3100, 2, 1);
+  Test_KeyBounce(t0, 3180, 2, 0);
+  Test_KeyBounce(t0, 3300, 2, 1);
+  Test_KeyBounce(t0, 3380, 2, 0);
+
+  Test_KeyRun(tick0, 3600);
+  printf("test.key.events=%u\n", (unsigned)test_key_num);
+  SIM_CHECK(test_key_num <= TEST_KEY_EVT_MAX);
+  SIM_CHECK(KEY_GetDropCount() == 0);
+  SIM_CHECK(KEY_GetDown() == 0);
+
+  // 抖动期间的采样不能提前确认，也不能产生重复事件
+  Test_KeyExpect(0, click, 2, tick0, at);
+  SIM_CHECK_RANGE(at[0], 10 + settle + 12 - 1, 10 + settle + 16 + 1);
+  SIM_CHECK_RANGE(at[1], 200 + 12 - 1, 200 + settle + 16 + 1);
+
+  Test_KeyExpect(1, hold, 5, tick0, at);
+  SIM_CHECK_RANGE(at[0], 300 + settle + 12 - 1, 300 + settle + 16 + 1);
+  SIM_CHECK(at[1] - at[0] == KEY_LONG_MS);
+  SIM_CHECK_RANGE(at[2] - at[1], KEY_REPEAT_MS, KEY_REPEAT_MS + KEY_SCAN_MS - 1);
+  SIM_CHECK_RANGE(at[3] - at[1], 2 * KEY_REPEAT_MS, 2 * KEY_REPEAT_MS + KEY_SCAN_MS - 1);
+  SIM_CHECK_RANGE(at[4], 300 + KEY_LONG_MS + 2 * KEY_REPEAT_MS + 75 + 12 - 1,
+                  300 + KEY_LONG_MS + 2 * KEY_REPEAT_MS + 75 + settle + 16 + 1);
+
+  Test_KeyExpect(2, dbl, 12, tick0, at);
+  SIM_CHECK_RANGE(at[2], 1800 + settle + 12 - 1, 1800 + settle + 16 + 1);
+  SIM_CHECK(at[3] == at[2]);
+  SIM_CHECK(at[2] - at[1] <= KEY_DOUBLE_MS);
+  SIM_CHECK(at[5] - at[4] > KEY_DOUBLE_MS);
+  SIM_CHECK_RANGE(at[7], 3100 + settle + 12 - 1, 3100 + settle + 16 + 1);
+  SIM_CHECK(at[8] == at[7]);
+  SIM_CHECK(at[10] - at[9] <= KEY_DOUBLE_MS);
+
+  Test_KeyExpect(3, two, 4, tick0, at);
+  SIM_CHECK(at[2] - at[1] > KEY_DOUBLE_MS);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               内存池                                      */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief 内存池：非法释放被拒绝，不破坏空闲链表与统计
+ */
+static void Test_Pool(void)
+{
+  const POOL_Stats_t *st = POOL_GetStats(0);
+  uint8_t *a;
+  uint8_t *b;
+  uint8_t *c;
+
+  a = (uint8_t *)POOL_Alloc(st->size);
+  b = (uint8_t *)POOL_Alloc(st->size);
+  SIM_CHECK(a != 0 && b == a + st->size);
+  SIM_CHECK(st->used == 2);
+
+  // 未对齐、从未分配过（高于水位线）的块
+  POOL_Free(a + 4);
+  POOL_Free(b + st->size);
+  SIM_CHECK(POOL_GetBadFreeCount() == 2);
+  SIM_CHECK(st->used == 2);
+
+  // 重复释放：与链表头相同、等级内已无分配块
+  POOL_Free(b);
+  POOL_Free(b);
+  POOL_Free(a);
+  POOL_Free(a);
+  SIM_CHECK(POOL_GetBadFreeCount() == 4);
+  SIM_CHECK(st->used == 0);
+
+  // 链表仍然完好：依次取回a、b，再从水位线继续
+  SIM_CHECK(POOL_Alloc(st->size) == a);
+  SIM_CHECK(POOL_Alloc(st->size) == b);
+  c = (uint8_t *)POOL_Alloc(st->size);
+  SIM_CHECK(c == b + st->size);
+  SIM_CHECK(st->used == 3 && POOL_GetBadFreeCount() == 4);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               DMA拷贝                                     */
+/* ------------------------------------------------------------------------ */
+
+#define TEST_COPY_LEN 150000 ///< 字节宽度时超过两段 65520 项
+
+static uint8_t test_copy_src[TEST_COPY_LEN + 16];
+static uint8_t test_copy_dst[TEST_COPY_LEN + 16];
+static uint32_t test_copy_cbs;
+static ErrorStatus test_copy_status;
+
+static void Test_CopyDone(void *arg, ErrorStatus status)
+{
+  (void)arg;
+  test_copy_cbs++;
+  test_copy_status = status;
+}
+
+/**
+ * @brief 拷贝队列：没有DMA时的长请求、多段DMA传输的标志清除与回调次数
+ */
+static void Test_Copy(void)
+{
+  const COPY_Stats_t *st = COPY_GetStats();
+  COPY_Ticket t;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(test_copy_src); i++)
+  {
+    test_copy_src[i] = (uint8_t)(i * 7 + (i >> 8));
+  }
+
+  // COPY_Init() 之前没有DMA：任意长度由CPU在调用者中完成
+  t = COPY_Memset(test_copy_dst, 0xA5, TEST_COPY_LEN, Test_CopyDone, 0);
+  SIM_CHECK(t != 0 && COPY_IsDone(t));
+  SIM_CHECK(test_copy_cbs == 1 && test_copy_status == SUCCESS);
+  SIM_CHECK(st->cpu_jobs == 1 && st->chunks == 0);
+  SIM_CHECK(test_copy_dst[0] == 0xA5 && test_copy_dst[TEST_COPY_LEN - 1] == 0xA5);
+
+  VEC_Init();
+  SIM_CHECK(COPY_Init() == SUCCESS);
+  __enable_irq();
+
+  // 源地址为奇数时按字节传输，主体拆成三段，后续段同样须先清除标志
+  test_copy_cbs = 0;
+  t = COPY_Memcpy(test_copy_dst + 16, test_copy_src + 1, TEST_COPY_LEN, Test_CopyDone, 0);
+  SIM_CHECK(t != 0);
+  COPY_Wait(t);
+  SIM_CHECK(test_copy_cbs == 1 && test_copy_status == SUCCESS);
+  SIM_CHECK(st->dma_jobs == 1 && st->chunks == 3 && st->errors == 0);
+  SIM_CHECK(memcmp(test_copy_dst + 16, test_copy_src + 1, TEST_COPY_LEN) == 0);
+  SIM_CHECK(SIM_GetDmaStaleStarts() == 0);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               分散/聚集DMA                                */
+/* ------------------------------------------------------------------------ */
+
+static uint32_t test_chain_cbs;
+static ErrorStatus test_chain_status;
+
+static void Test_ChainDone(void *arg, ErrorStatus status)
+{
+  (void)arg;
+  test_chain_cbs++;
+  test_chain_status = status;
+}
+
+/**
+ * @brief 模拟外设请求的传输完成：硬件清除EN、置TCIF7与HTIF7
+ * @note 仿真器不搬运外设请求的DMA，由测试注入完成事件
+ */
+static void Test_ChainTc(DMA_Stream_TypeDef *stream)
+{
+  stream->NDTR = 0;
+  stream->CR &= ~DMA_SxCR_EN;
+  DMA2->HISR |= DMA_HISR_TCIF7 | DMA_HISR_HTIF7;
+  NVIC_SetPendingIRQ(DMA2_Stream7_IRQn);
+  (void)DMA2->HISR;
+}
+
+/**
+ * @brief 分散/聚集：逐段推进、跳过空段、只回调一次，以及中止
+ */
+static void Test_Chain(void)
+{
+  static uint8_t hdr[4];
+  static uint8_t pay[100];
+  static uint8_t crc[2];
+  static const CHAIN_Seg_t segs[4] = {{hdr, 4}, {0, 0}, {pay, 100}, {crc, 2}};
+  static CHAIN_t ch;
+  DMA_InitTypeDef init;
+  DMA_Stream_TypeDef *stream;
+
+  VEC_Init();
+  __enable_irq();
+  DMA_StructInit(&init);
+  init.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&USART1->DR;
+  init.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+  SIM_CHECK(CHAIN_Init(&ch, "uart1", DMAM_REQ_USART1_TX, &init) == SUCCESS);
+  stream = DMAM_GetStream(ch.dma);
+  SIM_CHECK(stream == DMA2_Stream7);
+
+  SIM_CHECK(CHAIN_Start(&ch, segs, 4, Test_ChainDone, 0) == SUCCESS);
+  SIM_CHECK(CHAIN_IsBusy(&ch));
+  SIM_CHECK(CHAIN_Start(&ch, segs, 4, Test_ChainDone, 0) == ERROR);
+  SIM_CHECK(stream->M0AR == (uint32_t)(uintptr_t)hdr && stream->NDTR == 4 && (stream->CR & DMA_SxCR_EN));
+
+  // 第二段长度为0，被跳过
+  Test_ChainTc(stream);
+  SIM_CHECK(stream->M0AR == (uint32_t)(uintptr_t)pay && stream->NDTR == 100 && (stream->CR & DMA_SxCR_EN));
+  SIM_CHECK(test_chain_cbs == 0);
+  Test_ChainTc(stream);
+  SIM_CHECK(stream->M0AR == (uint32_t)(uintptr_t)crc && stream->NDTR == 2 && (stream->CR & DMA_SxCR_EN));
+  SIM_CHECK(test_chain_cbs == 0);
+  Test_ChainTc(stream);
+  SIM_CHECK(!CHAIN_IsBusy(&ch) && !(stream->CR & DMA_SxCR_EN));
+  SIM_CHECK(test_chain_cbs == 1 && test_chain_status == SUCCESS);
+  SIM_CHECK(ch.chains == 1 && ch.segments == 3 && ch.errors == 0);
+
+  // 中止：回调以ERROR调用一次，重复中止无效果，之后可以重新开始
+  SIM_CHECK(CHAIN_Start(&ch, segs, 4, Test_ChainDone, 0) == SUCCESS);
+  Test_ChainTc(stream);
+  CHAIN_Abort(&ch);
+  CHAIN_Abort(&ch);
+  SIM_CHECK(!CHAIN_IsBusy(&ch) && !(stream->CR & DMA_SxCR_EN));
+  SIM_CHECK(test_chain_cbs == 2 && test_chain_status == ERROR && ch.errors == 1);
+  SIM_CHECK(CHAIN_Start(&ch, segs, 4, Test_ChainDone, 0) == SUCCESS);
+  SIM_CHECK(stream->M0AR == (uint32_t)(uintptr_t)hdr && stream->NDTR == 4);
+
+  // 每次使能前事件标志都已清除
+  SIM_CHECK(SIM_GetDmaStaleStarts() == 0);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               N缓冲流                                     */
+/* ------------------------------------------------------------------------ */
+
+static uint16_t test_stream_mem[4][64];
+static void *const test_stream_bufs[4] = {test_stream_mem[0], test_stream_mem[1], test_stream_mem[2],
+                                          test_stream_mem[3]};
+static uint32_t test_stream_notes;
+
+static void Test_StreamNotify(void *arg)
+{
+  (void)arg;
+  test_stream_notes++;
+}
+
+/**
+ * @brief 模拟双缓冲模式的DMA事件：传输完成时硬件切换CT
+ * @note 仿真器不搬运外设请求的DMA，由测试注入事件标志
+ */
+static void Test_StreamEvent(STREAM_t *s, uint32_t evt)
+{
+  static const uint8_t shift[4] = {0, 6, 16, 22};
+  DMA_TypeDef *dma = s->dma < 8 ? DMA1 : DMA2;
+  volatile uint32_t *isr = (s->dma & 7) < 4 ? &dma->LISR : &dma->HISR;
+
+  if (evt & DMAM_EVT_TC)
+  {
+    DMAM_GetStream(s->dma)->CR ^= DMA_SxCR_CT;
+  }
+  *isr |= evt << shift[s->dma & 3];
+  NVIC_SetPendingIRQ(DMAM_GetIRQn(s->dma));
+  (void)*isr;
+}
+
+/**
+ * @brief 双缓冲寄存器中的缓冲序号，不是流缓冲时返回-1
+ */
+static int Test_StreamReg(STREAM_t *s, uint8_t m1)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(s->dma);
+  uint32_t addr = m1 ? stream->M1AR : stream->M0AR;
+  int i;
+
+  for (i = 0; i < 4; i++)
+  {
+    if (addr == (uint32_t)(uintptr_t)test_stream_bufs[i])
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static int Test_StreamGet(STREAM_t *s)
+{
+  void *p = STREAM_Get(s);
+  int i;
+
+  for (i = 0; i < 4; i++)
+  {
+    if (p == test_stream_bufs[i])
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void Test_StreamInit(STREAM_t *s, DMAM_Request req, uint32_t dir, uint8_t num)
+{
+  DMA_InitTypeDef init;
+
+  memset(s, 0, sizeof(*s));
+  DMA_StructInit(&init);
+  init.DMA_PeripheralBaseAddr = req == DMAM_REQ_ADC1 ? (uint32_t)(uintptr_t)&ADC1->DR
+                                                     : (uint32_t)(uintptr_t)&DAC->DHR12R1;
+  init.DMA_DIR = dir;
+  init.DMA_BufferSize = 64;
+  init.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+  init.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+  SIM_CHECK(STREAM_Init(s, "stream", req, &init, test_stream_bufs, num) == SUCCESS);
+  STREAM_SetNotify(s, Test_StreamNotify, 0);
+  test_stream_notes = 0;
+  STREAM_Start(s);
+  SIM_CHECK(Test_StreamReg(s, 0) == 0 && Test_StreamReg(s, 1) == 1);
+}
+
+static void Test_StreamDone(STREAM_t *s)
+{
+  STREAM_Stop(s);
+  DMAM_Free(s->dma);
+}
+
+/**
+ * @brief N缓冲流：采集（N=2、N=3）与播放的缓冲轮转、懒补装、半传输补装与溢出
+ */
+static void Test_Stream(void)
+{
+  static STREAM_t s;
+
+  VEC_Init();
+  __enable_irq();
+
+  // 采集，N=3：第三个缓冲在排队，完成的缓冲所在寄存器立即换装
+  Test_StreamInit(&s, DMAM_REQ_ADC1, DMA_DIR_PeripheralToMemory, 3);
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(Test_StreamReg(&s, 0) == 2 && Test_StreamReg(&s, 1) == 1);
+  SIM_CHECK(test_stream_notes == 1);
+  SIM_CHECK(Test_StreamGet(&s) == 0);
+  // 没有排队的缓冲：寄存器保持原值（懒补装）
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(Test_StreamReg(&s, 0) == 2 && Test_StreamReg(&s, 1) == 1);
+  // 归还后由半传输中断装入空闲寄存器
+  STREAM_Release(&s, test_stream_bufs[0]);
+  Test_StreamEvent(&s, DMAM_EVT_HT);
+  SIM_CHECK(Test_StreamReg(&s, 0) == 2 && Test_StreamReg(&s, 1) == 0);
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(s.overruns == 0 && s.user_count == 2);
+  // 使用者不取缓冲：DMA切换到仍在使用者队列中的缓冲，计为溢出并从队列删除
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(s.overruns == 1 && s.buffers == 4 && test_stream_notes == 4);
+  SIM_CHECK(Test_StreamGet(&s) == 1);
+  SIM_CHECK(Test_StreamGet(&s) == 0);
+  SIM_CHECK(Test_StreamGet(&s) == -1);
+  // 传输错误只计数
+  Test_StreamEvent(&s, DMAM_EVT_TE);
+  SIM_CHECK(s.errors == 1 && s.buffers == 4);
+  Test_StreamDone(&s);
+
+  // 采集，N=2：普通乒乓，归还的缓冲原地复用
+  Test_StreamInit(&s, DMAM_REQ_ADC1, DMA_DIR_PeripheralToMemory, 2);
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(Test_StreamGet(&s) == 0);
+  STREAM_Release(&s, test_stream_bufs[0]);
+  SIM_CHECK(s.dma_count == 0);
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(s.overruns == 0);
+  SIM_CHECK(Test_StreamGet(&s) == 1);
+  // 持有的缓冲被DMA切换到：溢出但不删除
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(s.overruns == 1 && s.user_count == 1);
+  STREAM_Release(&s, test_stream_bufs[1]);
+  STREAM_Release(&s, test_stream_bufs[1]);
+  SIM_CHECK(s.dma_count == 0);
+  // 就绪但未取走的缓冲被切换到：溢出并删除
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(s.overruns == 2 && s.user_count == 1);
+  SIM_CHECK(Test_StreamGet(&s) == 1);
+  SIM_CHECK(Test_StreamReg(&s, 0) == 0 && Test_StreamReg(&s, 1) == 1);
+  Test_StreamDone(&s);
+
+  // 播放，N=3：第三个缓冲先交给生产者填充
+  Test_StreamInit(&s, DMAM_REQ_DAC1, DMA_DIR_MemoryToPeripheral, 3);
+  SIM_CHECK(Test_StreamGet(&s) == 2);
+  SIM_CHECK(Test_StreamGet(&s) == -1);
+  STREAM_Release(&s, test_stream_bufs[2]);
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(Test_StreamReg(&s, 0) == 2 && Test_StreamReg(&s, 1) == 1);
+  SIM_CHECK(Test_StreamGet(&s) == 0);
+  // 生产者跟不上：寄存器保持，重播的缓冲计为溢出
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(Test_StreamReg(&s, 0) == 2 && Test_StreamReg(&s, 1) == 1);
+  Test_StreamEvent(&s, DMAM_EVT_TC);
+  SIM_CHECK(s.overruns == 1 && s.buffers == 3);
+  SIM_CHECK(Test_StreamGet(&s) == 2);
+  SIM_CHECK(Test_StreamGet(&s) == -1);
+  Test_StreamDone(&s);
+
+  SIM_CHECK(SIM_GetDmaStaleStarts() == 0);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               蜂鸣器旋律                                  */
+/* ------------------------------------------------------------------------ */
+
+#define TEST_BEEP_MAX 64
+#define TEST_BEEP_HALF (BEEP_BUF_SLOTS / 2) ///< 一次补充的时隙数
+
+static uint16_t test_beep_arr[TEST_BEEP_MAX];
+static uint64_t test_beep_us[TEST_BEEP_MAX];
+static volatile uint32_t test_beep_num;
+
+/**
+ * @brief 记录TIM6更新DMA写入TIM13->ARR的值与时刻
+ */
+static void Test_BeepHook(uint32_t addr, uint32_t value, uint64_t us)
+{
+  if (addr != (uint32_t)&TIM13->ARR || test_beep_num >= TEST_BEEP_MAX)
+  {
+    return;
+  }
+  test_beep_arr[test_beep_num] = (uint16_t)value;
+  test_beep_us[test_beep_num] = us;
+  test_beep_num++;
+}
+
+/**
+ * @brief 把音符表展开成每个时隙的ARR
+ */
+static uint32_t Test_BeepSlots(const BEEP_Note_t *notes, uint32_t len, uint16_t *out)
+{
+  uint32_t n = 0;
+  uint32_t i;
+  uint32_t k;
+
+  for (i = 0; i < len; i++)
+  {
+    k = (notes[i].ms + BEEP_SLOT_MS / 2) / BEEP_SLOT_MS;
+    while (k--)
+    {
+      out[n++] = BEEP_FreqToArr(notes[i].freq);
+    }
+  }
+  return n;
+}
+
+/**
+ * @brief 旋律播放中插入高优先级提示音：DMA写入的ARR序列、音高与时隙间隔
+ */
+static void Test_Beep(void)
+{
+  static const BEEP_Note_t melody_notes[] = {{1000, 30}, {0, 20}, {1500, 50}, {2000, 40}};
+  static const BEEP_Melody_t melody = {melody_notes, 4, 1};
+  static const BEEP_Note_t alert_notes[] = {{3000, 20}};
+  static const uint16_t freqs[] = {1000, 1500, 2000, 3000};
+  uint16_t mel[TEST_BEEP_MAX];
+  uint16_t alert[TEST_BEEP_MAX];
+  uint32_t nm = Test_BeepSlots(melody_notes, 4, mel);
+  uint32_t na = Test_BeepSlots(alert_notes, 1, alert);
+  uint32_t at;
+  uint32_t i;
+  uint32_t j;
+  uint32_t twice;
+
+  VEC_Init();
+  BOARD_Init();
+  BEEP_EngineInit();
+  __enable_irq();
+  SIM_SetDmaHook(Test_BeepHook);
+
+  // 音高：f = BEEP_CNT_HZ / (2 * (ARR + 1))，ARR+1与理想值相差不超过半个计数
+  for (i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++)
+  {
+    twice = 2UL * freqs[i] * (BEEP_FreqToArr(freqs[i]) + 1);
+    SIM_CHECK_RANGE(twice, BEEP_CNT_HZ - freqs[i], BEEP_CNT_HZ + freqs[i]);
+  }
+  SIM_CHECK(BEEP_FreqToArr(0) == BEEP_CCR - 1);
+
+  // TIM6更新只产生DMA请求，CPU在第一次半传输中断时醒来，此时已补充到第12个时隙；
+  // 已装入缓冲的时隙照常播放，提示音从下一次补充开始，结束后旋律从被打断处继续
+  BEEP_Play(&melody, 2);
+  while (test_beep_num < 2)
+  {
+    __WFI();
+  }
+  SIM_CHECK(test_beep_num == TEST_BEEP_HALF);
+  BEEP_Tone(alert_notes[0].freq, alert_notes[0].ms, 0);
+  while (BEEP_IsPlaying())
+  {
+    __WFI();
+  }
+  SIM_SetDmaHook(0);
+
+  at = BEEP_BUF_SLOTS + TEST_BEEP_HALF;
+  SIM_CHECK_RANGE(test_beep_num, nm + na, TEST_BEEP_MAX - 1);
+  for (i = 0; i < test_beep_num; i++)
+  {
+    if (i < at)
+    {
+      SIM_CHECK(test_beep_arr[i] == mel[i]);
+    }
+    else if (i < at + na)
+    {
+      SIM_CHECK(test_beep_arr[i] == alert[i - at]);
+    }
+    else if (i < nm + na)
+    {
+      SIM_CHECK(test_beep_arr[i] == mel[i - na]);
+    }
+    else
+    {
+      SIM_CHECK(test_beep_arr[i] == BEEP_CCR - 1);
+    }
+  }
+
+  // 每个时隙一次DMA请求，间隔为TIM6更新周期
+  for (j = 1; j < test_beep_num; j++)
+  {
+    SIM_CHECK_RANGE(test_beep_us[j] - test_beep_us[j - 1], BEEP_SLOT_MS * 1000 - 1, BEEP_SLOT_MS * 1000 + 1);
+  }
+  // 连续两个半缓冲只剩休止后停止：TIM6关闭，TIM13输出强制为无效电平
+  SIM_CHECK(!(TIM6->CR1 & TIM_CR1_CEN));
+  SIM_CHECK((TIM13->CCMR1 & TIM_CCMR1_OC1M) == TIM_ForcedAction_InActive);
+  SIM_CHECK(SIM_GetDmaStaleStarts() == 0);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               栈探针                                      */
+/* ------------------------------------------------------------------------ */
+
+extern uint32_t __stack_base[];
+extern uint32_t __initial_sp[];
+
+/**
+ * @brief 把[lo, hi)写成非填充值，模拟被使用过的栈
+ */
+static void Test_StackDirty(uint32_t *lo, uint32_t *hi)
+{
+  while (lo < hi)
+  {
+    *lo = (uint32_t)(uintptr_t)lo;
+    lo++;
+  }
+}
+
+/**
+ * @brief 在run_sp处模拟一次中断：硬件压栈帧、处理函数序言{r4, lr}、函数体用量
+ * @param fp 1: 含浮点寄存器的压栈帧，并带对齐字
+ * @param body 函数体使用的字数
+ * @retval STACK_IsrEnter() 返回的入口SP
+ */
+static uint32_t Test_StackIsr(STACK_Ctx_t *ctx, uint32_t *run_sp, uint8_t fp, uint32_t body)
+{
+  uint32_t *frame = run_sp - (fp ? 27 : 8);
+  uint32_t *sp = frame - 2;
+  uint32_t entry;
+
+  Test_StackDirty(sp, run_sp);
+  frame[7] = fp ? 0x01000200UL : 0x01000000UL; // xPSR，位9为对齐字
+  sp[1] = fp ? 0xFFFFFFE9UL : 0xFFFFFFF9UL;    // 序言保存的EXC_RETURN
+  SIM_SetMsp((uint32_t)(uintptr_t)sp);
+  entry = STACK_IsrEnter();
+  Test_StackDirty(sp - body, sp);
+  STACK_IsrExit(ctx, entry);
+  return entry;
+}
+
+/**
+ * @brief 栈探针：较深的任务返回后，在较浅的调度循环处进入中断，
+ *        中断的用量不能包含任务留下的栈帧
+ */
+static void Test_Stack(void)
+{
+  static STACK_Ctx_t isr = {"isr", 0, 0};
+  static STACK_Ctx_t isr_fp = {"isr_fp", 0, 0};
+  uint32_t *run_sp = __initial_sp - 16; // SCHED_Run() 所在深度
+  uint32_t sp;
+  uint32_t task;
+
+  // 调度循环之前留下的160字节：中断入口的重新填充不计入，也不丢失MSP高水位
+  Test_StackDirty(run_sp - 40, run_sp);
+  Test_StackIsr(&isr, run_sp, 0, 12);
+  SIM_CHECK(isr.max == (8 + 2 + 12) * 4);
+  SIM_CHECK(STACK_GetMspHighWater() == (16 + 40) * 4);
+
+  // 任务：探针重新填充后使用600字节
+  SIM_SetMsp((uint32_t)(uintptr_t)run_sp);
+  sp = STACK_ProbeBegin();
+  SIM_CHECK(sp == (uint32_t)(uintptr_t)run_sp);
+  Test_StackDirty(run_sp - 150, run_sp);
+  task = STACK_ProbeEnd(sp);
+  SIM_CHECK(task == 600);
+
+  // 中断：入口为压栈前的SP，用量 = 压栈帧 + 序言 + 函数体
+  SIM_CHECK(Test_StackIsr(&isr, run_sp, 0, 12) == (uint32_t)(uintptr_t)run_sp);
+  SIM_CHECK(isr.max == (8 + 2 + 12) * 4);
+  SIM_CHECK(isr.max < task);
+  SIM_CHECK(Test_StackIsr(&isr_fp, run_sp, 1, 12) == (uint32_t)(uintptr_t)run_sp);
+  SIM_CHECK(isr_fp.max == (27 + 2 + 12) * 4);
+  SIM_CHECK(STACK_GetCtx(0) == &isr && STACK_GetCtx(1) == &isr_fp);
+
+  // 任务先到达240字节深，返回到较浅处后被中断：入口的重新填充抹掉了任务的栈帧，
+  // 任务的用量仍为240字节
+  SIM_SetMsp((uint32_t)(uintptr_t)run_sp);
+  sp = STACK_ProbeBegin();
+  Test_StackDirty(run_sp - 60, run_sp);
+  Test_StackIsr(&isr, run_sp - 20, 0, 4);
+  SIM_CHECK(STACK_ProbeEnd(sp) == 60 * 4);
+  SIM_CHECK(isr.max == (8 + 2 + 12) * 4);
+
+  // 重新填充不丢失MSP高水位
+  SIM_CHECK(STACK_GetMspHighWater() == 16 * 4 + task);
+
+  SIM_SetMsp(0);
+  SIM_CHECK(STACK_IsrEnter() == 0);
+}
+
+/* ------------------------------------------------------------------------ */
+/*                               用例表                                      */
+/* ------------------------------------------------------------------------ */
+
+static const struct
+{
+  const char *name;
+  void (*fn)(void);
+} sim_tests[] = {
+    {"key", Test_Key},
+    {"pool", Test_Pool},
+    {"copy", Test_Copy},
+    {"chain", Test_Chain},
+    {"stream", Test_Stream},
+    {"beep", Test_Beep},
+    {"stack", Test_Stack},
+};
+
+void (*SIM_TestFind(const char *name))(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < sizeof(sim_tests) / sizeof(sim_tests[0]); i++)
+  {
+    if (strcmp(name, sim_tests[i].name) == 0)
+    {
+      return sim_tests[i].fn;
+    }
+  }
+  return 0;
+}
+
+void SIM_TestList(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < sizeof(sim_tests) / sizeof(sim_tests[0]); i++)
+  {
+    printf("%s\n", sim_tests[i].name);
+  }
+}
+
+unsigned SIM_TestFailures(void)
+{
+  return sim_test_fail;
+}
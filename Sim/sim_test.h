@@ -0,0 +1,31 @@
+/**
+ * @file sim_test.h
+ * @brief 主机仿真测试用例
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 每个用例在独立的仿真进程中运行（sim -T <名称>），由脚本化的引脚激励
+ * 或寄存器注入驱动固件模块，检查失败时输出到stderr并计数。
+ */
+
+#ifndef _SIM_TEST_H_
+#define _SIM_TEST_H_
+
+/**
+ * @brief 按名称查找测试用例
+ * @retval 用例入口，不存在时返回NULL
+ */
+void (*SIM_TestFind(const char *name))(void);
+
+/**
+ * @brief 输出全部用例名称，每行一个
+ */
+void SIM_TestList(void);
+
+/**
+ * @brief 获取检查失败的次数
+ */
+unsigned SIM_TestFailures(void);
+
+#endif
@@ -1,169 +1,122 @@
 #include "stm32f4xx.h"
 #include "./myInit/myInit.h"
+#include "./myTime/myTime.h"
+#include "./myKey/myKey.h"
+#include "./mySched/mySched.h"
+#include "./myLed/myLed.h"
+#include "./myBeep/myBeep.h"
+#include "./myBoot/myBoot.h"
+#include "./myVec/myVec.h"
+#include "./myIdle/myIdle.h"
+#include "./myCopy/myCopy.h"
+
+static uint8_t key_task_id = SCHED_INVALID; // 
+static uint8_t led_task_id = SCHED_INVALID; // LEDЧ
 
 /**
- * @brief  ȡ״̬ĽĽ׳ʵ֣
- * @param  None
- * @retval uint8_t: 0~3ֱӦKEY0~KEY3£0xFFʾް
- * @note   "ټ+ʱȷ+ȴͷ"߼
+ * @brief ʾ
  */
-uint8_t Key_Read(void)
-{
-    uint8_t key_pressed = 0xFF; // ʼΪް
-    uint8_t current_state;
-
-    // 1. ټĸİ
-    for(uint8_t i = 0; i < 4; i++)
-    {
-        switch(i)
-        {
-            case 0: current_state = GPIO_ReadInputDataBit(KEY0_PORT, KEY0_PIN); break;
-            case 1: current_state = GPIO_ReadInputDataBit(KEY1_PORT, KEY1_PIN); break;
-            case 2: current_state = GPIO_ReadInputDataBit(KEY2_PORT, KEY2_PIN); break;
-            case 3: current_state = GPIO_ReadInputDataBit(KEY3_PORT, KEY3_PIN); break;
-            default: current_state = 1; break; // ĬΪͷ
-        }
+static const BEEP_Note_t long_press_notes[] = {
+    {1047, 80}, {0, 20}, {1319, 80}, {0, 20}, {1568, 120},
+};
+static const BEEP_Melody_t long_press_melody = {
+    long_press_notes, sizeof(long_press_notes) / sizeof(long_press_notes[0]), 1};
 
-        // 2. ⵽£͵ƽ
-        if(current_state == 0)
-        {
-            key_pressed = i; // ¼ܰµİ
-            break; // ѭټ
-        }
+/**
+ * @brief LED
+ * @param led_num LED(0-3)
+ * @param state LED״̬(0-, 1-ر)
+ */
+void LED_Control(uint8_t led_num, uint8_t state) {
+    if (led_num < 4) {
+        LED_SetBrightness(led_num, state ? 0 : LED_BRIGHTNESS_MAX); // stateΪ1ʱرLED
     }
+}
 
-    // 3. ûа£ֱӷ0xFF
-    if(key_pressed == 0xFF)
-    {
-        return 0xFF;
-    }
+/**
+ * @brief ¼֪ͨSysTickже
+ */
+static void Key_Notify(void) {
+    SCHED_Post(key_task_id);
+}
 
-    // 4. ʱȷϰ£ֹ
-    Delay_ms(15);
-
-    // 5. ٴȷϰǷȻ
-    switch(key_pressed)
-    {
-        case 0: current_state = GPIO_ReadInputDataBit(KEY0_PORT, KEY0_PIN); break;
-        case 1: current_state = GPIO_ReadInputDataBit(KEY1_PORT, KEY1_PIN); break;
-        case 2: current_state = GPIO_ReadInputDataBit(KEY2_PORT, KEY2_PIN); break;
-        case 3: current_state = GPIO_ReadInputDataBit(KEY3_PORT, KEY3_PIN); break;
-        default: current_state = 1; break;
-    }
+/**
+ * @brief ȡȫ¼ʱлӦLED״̬
+ *        ʱӦLEDЧ볤ʾ
+ * @param arg δʹ
+ */
+static void Key_Task(void *arg) {
+    static uint8_t led_state[4] = {0, 0, 0, 0}; // ÿLED״̬
+    KEY_Event_t evt;
 
-    // 6. ȷϰ
-    if(current_state == 0)
-    {
-        // 7. ȴͷ
-        while(1)
-        {
-            switch(key_pressed)
-            {
-                case 0: current_state = GPIO_ReadInputDataBit(KEY0_PORT, KEY0_PIN); break;
-                case 1: current_state = GPIO_ReadInputDataBit(KEY1_PORT, KEY1_PIN); break;
-                case 2: current_state = GPIO_ReadInputDataBit(KEY2_PORT, KEY2_PIN); break;
-                case 3: current_state = GPIO_ReadInputDataBit(KEY3_PORT, KEY3_PIN); break;
-            }
-            if(current_state == 1) // ⵽ͷ
-            {
-                break; // ˳ȴѭ
-            }
-            Delay_ms(10); // СʱCPUռ
+    (void)arg;
+    while (KEY_GetEvent(&evt)) {
+        if (evt.type == KEY_EVT_PRESS && evt.key < 4) {
+            led_state[evt.key] = !led_state[evt.key];
+            LED_Control(evt.key, led_state[evt.key]);
+            BEEP_Tone(2000, 30, 1);
+        } else if (evt.type == KEY_EVT_LONG && evt.key < 4) {
+            LED_SetPattern(evt.key, LED_PATTERN_BREATHE, 2000, LED_BRIGHTNESS_MAX);
+            BEEP_Play(&long_press_melody, 0);
         }
-        
-        // 8. ȷ"-ͷ"̺󣬷ذ
-        return key_pressed;
     }
-
-    // Ƕţ˵ûЧ
-    return 0xFF;
 }
 
 /**
- * @brief LED
- * @param led_num LED(0-3)
- * @param state LED״̬(0-, 1-ر)
+ * @brief LEDЧÿ LED_PATTERN_MS һ
+ * @param arg δʹ
  */
-void LED_Control(uint8_t led_num, uint8_t state) {
-    switch(led_num) {
-        case 0: // LED0
-            if (state) {
-                GPIO_SetBits(LED0_PORT, LED0_PIN);      // رLED
-            } else {
-                GPIO_ResetBits(LED0_PORT, LED0_PIN);    // LED
-            }
-            break;
-        case 1: // LED1
-            if (state) {
-                GPIO_SetBits(LED1_PORT, LED1_PIN);
-            } else {
-                GPIO_ResetBits(LED1_PORT, LED1_PIN);
-            }
-            break;
-        case 2: // LED2
-            if (state) {
-                GPIO_SetBits(LED2_PORT, LED2_PIN);
-            } else {
-                GPIO_ResetBits(LED2_PORT, LED2_PIN);
-            }
-            break;
-        case 3: // LED3
-            if (state) {
-                GPIO_SetBits(LED3_PORT, LED3_PIN);
-            } else {
-                GPIO_ResetBits(LED3_PORT, LED3_PIN);
-            }
-            break;
-    }
+static void Led_Task(void *arg) {
+    (void)arg;
+    LED_PatternTick();
 }
 
 /**
  * @brief 
  */
 int main(void) {
-    uint8_t key_num;
-    static uint8_t led_state[4] = {0, 0, 0, 0}; // ÿLED״̬
-    
-    // ʼӲ
-    // KEY_Init(KEY0_PIN, KEY0_PORT);
-    // KEY_Init(KEY1_PIN, KEY1_PORT);
-    // KEY_Init(KEY2_PIN, KEY2_PORT);
-    // KEY_Init(KEY3_PIN, KEY3_PORT);
-
-    KEY_Initx(0);
-    KEY_Initx(1);
-    KEY_Initx(2);
-    KEY_Initx(3);
-
-    
-//    LED_Init(LED0_PIN, LED0_PORT);
-//    LED_Init(LED1_PIN, LED1_PORT);
-//    LED_Init(LED2_PIN, LED2_PORT);
-//    LED_Init(LED3_PIN, LED3_PORT);
-		
-		LED_Initx(0);
-		LED_Initx(1);
-		LED_Initx(2);
-		LED_Initx(3);
-		
-    
-    // ʼLEDΪ״̬
-    GPIO_ResetBits(LED0_PORT, LED0_PIN);
-    GPIO_ResetBits(LED1_PORT, LED1_PIN);
-    GPIO_ResetBits(LED2_PORT, LED2_PIN);
-    GPIO_ResetBits(LED3_PORT, LED3_PIN);
-    
-    while(1) {
-        // ⰴ
-        key_num = Key_Read();
-        
-        // а£лӦLED״̬
-        if (key_num < 4) {
-            led_state[key_num] = !led_state[key_num];
-            LED_Control(key_num, led_state[key_num]);
-        }
-        
-        // ʱCPUռ
-       Delay_ms(10);
+    uint8_t i;
+
+    // ʱmain
+    BOOT_Mark(BOOT_STAMP_MAIN);
+
+    // ƵSRAMжڲٴFlashȡ
+    VEC_Init();
+
+    // ʼʱSysTick 1ms + DWTڼ
+    TIME_Init();
+
+    // йRTCLSEʱӳԤSTOP
+    IDLE_Init();
+
+    // һȫLED
+    BOARD_Init();
+
+    // ʼ
+    KEY_EngineInit();
+
+    // LED棨TIM1 + DMA2ˢLEDţʼLEDΪ״̬
+    LED_EngineInit();
+    for (i = 0; i < 4; i++) {
+        LED_Control(i, 0);
     }
+
+    // ʼ棨TIM13TIM6 + DMA1У
+    BEEP_EngineInit();
+
+    // 첽֮DMA2ʹʣµ
+    COPY_Init();
+
+    // 񣬰¼ʱжͶݰ
+    SCHED_Init();
+    key_task_id = SCHED_Create(Key_Task, 0, 0, "key");
+    KEY_SetNotify(Key_Notify);
+    led_task_id = SCHED_Create(Led_Task, 0, 1, "led");
+    SCHED_PostEvery(led_task_id, LED_PATTERN_MS);
+
+    // ʱʼɣ BOOT_GetReport()
+    BOOT_Mark(BOOT_STAMP_READY);
+
+    // ¼ѭʱ IDLE_Sleep() ѡWFISTOP
+    SCHED_Run();
 }
@@ -0,0 +1,349 @@
+/**
+ * @file myBeep.c
+ * @brief 基于TIM13输出比较 + DMA音符序列的蜂鸣器音调/旋律引擎实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myBeep.h"
+#include "../myMem/myMem.h"
+#include "../myClock/myClock.h"
+#include "../myIdle/myIdle.h"
+#include "../myDma/myDma.h"
+
+#define BEEP_HALF_SLOTS (BEEP_BUF_SLOTS / 2)
+
+/**
+ * @brief 播放通道
+ */
+typedef struct
+{
+  const BEEP_Note_t *notes; ///< 音符表，NULL表示通道空闲
+  uint16_t len;             ///< 音符数量
+  uint16_t loops;           ///< 剩余播放次数，BEEP_LOOP_FOREVER 表示循环
+  uint16_t idx;             ///< 当前音符
+  uint16_t remain;          ///< 当前音符剩余时隙数，0表示尚未装入
+  uint16_t arr;             ///< 当前音符的ARR
+} BEEP_Chan_t;
+
+static BEEP_Chan_t beep_chan[BEEP_PRIO_NUM] MEM_CCM;
+static BEEP_Note_t beep_tone[BEEP_PRIO_NUM] MEM_CCM; ///< BEEP_Tone() 的单音存储
+MEM_DMA_BUF(static uint16_t, beep_buf, [BEEP_BUF_SLOTS]); ///< DMA环形缓冲，每个时隙一个ARR
+static volatile uint8_t beep_running;
+static uint8_t beep_idle_halves; ///< 连续填充为休止的半缓冲数
+static uint8_t beep_idle_id = 0xFF; ///< 空闲管理中的模块编号，播放期间不允许STOP
+static uint8_t beep_dma = DMAM_INVALID; ///< TIM6_UP请求的DMA数据流
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK）
+ */
+#define BEEP_ENTER_CRITICAL()               \
+  uint32_t beep_primask = __get_PRIMASK();  \
+  __disable_irq()
+#define BEEP_EXIT_CRITICAL() __set_PRIMASK(beep_primask)
+
+uint16_t BEEP_FreqToArr(uint16_t freq)
+{
+  uint32_t arr;
+
+  if (freq == 0)
+  {
+    return BEEP_CCR - 1;
+  }
+
+  // 翻转模式每个周期翻转一次，输出频率为计数溢出频率的一半
+  arr = (BEEP_CNT_HZ + freq) / (2UL * freq) - 1;
+  if (arr < BEEP_CCR)
+  {
+    arr = BEEP_CCR;
+  }
+  return arr > 0xFFFF ? 0xFFFF : (uint16_t)arr;
+}
+
+/**
+ * @brief 取出下一个时隙的ARR
+ * @param active 输出：是否有通道在播放
+ */
+static uint16_t BEEP_NextSlot(uint8_t *active)
+{
+  BEEP_Chan_t *c = 0;
+  uint16_t arr;
+  uint8_t p;
+
+  for (p = 0; p < BEEP_PRIO_NUM; p++)
+  {
+    if (beep_chan[p].notes)
+    {
+      c = &beep_chan[p];
+      break;
+    }
+  }
+  if (c == 0)
+  {
+    *active = 0;
+    return BEEP_CCR - 1;
+  }
+  *active = 1;
+
+  if (c->remain == 0)
+  {
+    const BEEP_Note_t *n = &c->notes[c->idx];
+
+    c->arr = BEEP_FreqToArr(n->freq);
+    c->remain = (uint16_t)((n->ms + BEEP_SLOT_MS / 2) / BEEP_SLOT_MS);
+    if (c->remain == 0)
+    {
+      c->remain = 1;
+    }
+  }
+
+  arr = c->arr;
+  if (--c->remain == 0 && ++c->idx >= c->len)
+  {
+    c->idx = 0;
+    if (c->loops != BEEP_LOOP_FOREVER && --c->loops == 0)
+    {
+      c->notes = 0;
+    }
+  }
+  return arr;
+}
+
+/**
+ * @brief 填充缓冲的一段
+ * @retval 1: 该段内有通道在播放，0: 全部为休止
+ */
+static uint8_t BEEP_Fill(uint16_t *buf, uint16_t n)
+{
+  uint8_t any = 0;
+  uint8_t active;
+
+  while (n--)
+  {
+    *buf++ = BEEP_NextSlot(&active);
+    any |= active;
+  }
+  return any;
+}
+
+/**
+ * @brief 停止输出：关闭时隙定时器，强制输出无效电平
+ */
+static void BEEP_Halt(void)
+{
+  TIM_Cmd(TIM6, DISABLE);
+  TIM_ForcedOC1Config(TIM13, TIM_ForcedAction_InActive);
+  beep_running = 0;
+  IDLE_SetLatency(beep_idle_id, IDLE_LATENCY_ANY);
+}
+
+/**
+ * @brief 从空闲状态启动播放（调用者处于临界区）
+ */
+static void BEEP_Start(void)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(beep_dma);
+
+  if (stream == 0)
+  {
+    return;
+  }
+  DMA_Cmd(stream, DISABLE);
+  while (DMA_GetCmdStatus(stream) != DISABLE)
+    ;
+  DMAM_ClearFlags(beep_dma, DMAM_EVT_ALL);
+
+  beep_idle_halves = 0;
+  BEEP_Fill(beep_buf, BEEP_BUF_SLOTS);
+  DMA_SetCurrDataCounter(stream, BEEP_BUF_SLOTS);
+  DMA_Cmd(stream, ENABLE);
+
+  // 从强制无效电平切回翻转模式（TIM_SelectOCxM 会关闭通道，需重新使能）
+  TIM_SelectOCxM(TIM13, TIM_Channel_1, TIM_OCMode_Toggle);
+  TIM_CCxCmd(TIM13, TIM_Channel_1, TIM_CCx_Enable);
+
+  // 立即产生一次更新，第一个时隙不必等待一个完整的 BEEP_SLOT_MS
+  TIM_SetCounter(TIM6, 0);
+  beep_running = 1;
+  IDLE_SetLatency(beep_idle_id, 0);
+  TIM_Cmd(TIM6, ENABLE);
+  TIM_GenerateEvent(TIM6, TIM_EventSource_Update);
+}
+
+/**
+ * @brief 补充半个缓冲，连续两个半缓冲只剩休止时停止
+ */
+MEM_RAMFUNC static void BEEP_Refill(uint16_t *half)
+{
+  if (BEEP_Fill(half, BEEP_HALF_SLOTS))
+  {
+    beep_idle_halves = 0;
+  }
+  else if (++beep_idle_halves >= 2)
+  {
+    // 两个半缓冲都只剩休止：停止时隙定时器，不再周期性唤醒CPU
+    BEEP_Halt();
+  }
+}
+
+/**
+ * @brief 音符DMA事件：半传输/传输完成时补充已发送完的半个缓冲
+ */
+MEM_RAMFUNC static void BEEP_DmaEvent(void *arg, uint32_t evts)
+{
+  (void)arg;
+
+  // 两个标志同时出现说明补充落后了半个缓冲，按发送顺序依次补充
+  if (evts & DMAM_EVT_HT)
+  {
+    BEEP_Refill(&beep_buf[0]); // 前半段已发送完，后半段正在发送
+  }
+  if ((evts & DMAM_EVT_TC) && beep_running)
+  {
+    BEEP_Refill(&beep_buf[BEEP_HALF_SLOTS]);
+  }
+}
+
+void BEEP_EngineInit(void)
+{
+  static const GPIO_PinCfg_t beep_af_cfg = {
+      BEEP0_PORT, BEEP0_PIN, GPIO_Mode_AF, GPIO_Speed_50MHz, GPIO_OType_PP, GPIO_PuPd_NOPULL, GPIO_AF_TIM13};
+  DMA_InitTypeDef DMA_InitStructure;
+  TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+  TIM_OCInitTypeDef TIM_OCInitStructure;
+  DMA_Stream_TypeDef *stream;
+  uint32_t tim_clk;
+  uint8_t p;
+
+  for (p = 0; p < BEEP_PRIO_NUM; p++)
+  {
+    beep_chan[p].notes = 0;
+  }
+  beep_running = 0;
+  if (beep_idle_id == 0xFF)
+  {
+    beep_idle_id = IDLE_Register("beep");
+  }
+  if (beep_dma == DMAM_INVALID)
+  {
+    beep_dma = DMAM_Alloc(DMAM_REQ_TIM6_UP, "beep");
+  }
+
+  RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM6 | RCC_APB1Periph_TIM13, ENABLE);
+
+  // TIM6与TIM13同在APB1
+  tim_clk = CLOCK_GetTimerClock(TIM13);
+
+  // TIM13：翻转模式，ARR预装载，初始为强制无效电平
+  TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+  TIM_TimeBaseStructure.TIM_Prescaler = (uint16_t)(tim_clk / BEEP_CNT_HZ - 1);
+  TIM_TimeBaseStructure.TIM_Period = BEEP_CCR - 1;
+  TIM_TimeBaseInit(TIM13, &TIM_TimeBaseStructure);
+  TIM_ARRPreloadConfig(TIM13, ENABLE);
+
+  TIM_OCStructInit(&TIM_OCInitStructure);
+  TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Toggle;
+  TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+  TIM_OCInitStructure.TIM_Pulse = BEEP_CCR;
+  TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+  TIM_OC1Init(TIM13, &TIM_OCInitStructure);
+  TIM_ForcedOC1Config(TIM13, TIM_ForcedAction_InActive);
+  TIM_Cmd(TIM13, ENABLE);
+
+  GPIO_BatchInit(&beep_af_cfg, 1);
+
+  // TIM6：每 BEEP_SLOT_MS 毫秒一次更新DMA请求（10kHz计数）
+  TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+  TIM_TimeBaseStructure.TIM_Prescaler = (uint16_t)(tim_clk / 10000 - 1);
+  TIM_TimeBaseStructure.TIM_Period = BEEP_SLOT_MS * 10 - 1;
+  TIM_TimeBaseInit(TIM6, &TIM_TimeBaseStructure);
+  TIM_DMACmd(TIM6, TIM_DMA_Update, ENABLE);
+
+  // 切换时钟档位后保持计数频率，音高与时隙不变
+  CLOCK_RegisterTimer(TIM13, BEEP_CNT_HZ, 0);
+  CLOCK_RegisterTimer(TIM6, 10000, 0);
+
+  // DMA：环形缓冲 -> TIM13->ARR，半传输/传输完成时补充
+  stream = DMAM_GetStream(beep_dma);
+  if (stream == 0)
+  {
+    return;
+  }
+  DMA_DeInit(stream);
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_Channel = DMAM_GetChannel(beep_dma);
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&TIM13->ARR;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)MEM_DMA_PTR(beep_buf);
+  DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+  DMA_InitStructure.DMA_BufferSize = BEEP_BUF_SLOTS;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+  DMA_Init(stream, &DMA_InitStructure);
+  DMA_ITConfig(stream, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+  DMAM_SetCallback(beep_dma, BEEP_DmaEvent, 0, (1 << __NVIC_PRIO_BITS) - 1);
+}
+
+void BEEP_Play(const BEEP_Melody_t *melody, uint8_t prio)
+{
+  BEEP_Chan_t *c;
+
+  if (prio >= BEEP_PRIO_NUM || melody == 0 || melody->len == 0)
+  {
+    return;
+  }
+
+  c = &beep_chan[prio];
+  {
+    BEEP_ENTER_CRITICAL();
+    c->len = melody->len;
+    c->loops = melody->loops;
+    c->idx = 0;
+    c->remain = 0;
+    c->notes = melody->notes;
+    if (!beep_running)
+    {
+      BEEP_Start();
+    }
+    BEEP_EXIT_CRITICAL();
+  }
+}
+
+void BEEP_Tone(uint16_t freq, uint16_t ms, uint8_t prio)
+{
+  BEEP_Melody_t melody;
+
+  if (prio >= BEEP_PRIO_NUM)
+  {
+    return;
+  }
+
+  {
+    BEEP_ENTER_CRITICAL();
+    beep_tone[prio].freq = freq;
+    beep_tone[prio].ms = ms;
+    BEEP_EXIT_CRITICAL();
+  }
+  melody.notes = &beep_tone[prio];
+  melody.len = 1;
+  melody.loops = 1;
+  BEEP_Play(&melody, prio);
+}
+
+void BEEP_Stop(uint8_t prio)
+{
+  if (prio < BEEP_PRIO_NUM)
+  {
+    beep_chan[prio].notes = 0;
+  }
+}
+
+uint8_t BEEP_IsPlaying(void)
+{
+  return beep_running;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file myBeep.h
+ * @brief 基于TIM13输出比较 + DMA音符序列的蜂鸣器音调/旋律引擎
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 蜂鸣器引脚PF8复用为TIM13_CH1，TIM13工作在翻转(toggle)模式，
+ * CCR1固定为 BEEP_CCR，输出频率只由ARR决定：
+ *   f = BEEP_CNT_HZ / (2 * (ARR + 1))
+ * 占空比恒为50%。ARR < BEEP_CCR 时计数器永远达不到CCR1，输出不翻转，即休止。
+ * 旋律中的休止保持当时的输出电平，全部通道播放结束后输出被强制为低电平。
+ *
+ * TIM13没有DMA请求，由TIM6每 BEEP_SLOT_MS 毫秒产生一次更新DMA请求
+ * （数据流由 DMAM_Alloc() 分配，即DMA1 Stream1 Ch7），把环形缓冲中的
+ * 下一个ARR写入TIM13->ARR；
+ * ARR开启预装载，新音高在TIM13下一个周期边界生效，不产生毛刺。
+ * 缓冲在DMA半传输/传输完成中断中按音符表补充，每次补充半个缓冲，
+ * 旋律与报警音完全在后台播放。
+ *
+ * 每个优先级一个播放通道，总是播放优先级最高的通道；被抢占的通道
+ * 保留进度，高优先级播放结束后继续播放。抢占在已缓冲的时隙播完后
+ * 生效，最长延迟 BEEP_BUF_SLOTS * BEEP_SLOT_MS 毫秒。
+ */
+
+#ifndef _MYBEEP_H_
+#define _MYBEEP_H_
+
+#include "stm32f4xx.h"
+#include "../myInit/myInit.h"
+
+/**
+ * @defgroup BEEP_Engine_Config 蜂鸣器引擎参数
+ * @{
+ */
+#define BEEP_CNT_HZ 1000000 ///< TIM13计数频率
+#define BEEP_CCR 2          ///< TIM13 CCR1，ARR小于该值即为休止
+#define BEEP_SLOT_MS 10     ///< 音符时长的最小单位（TIM6更新周期）
+#define BEEP_BUF_SLOTS 8    ///< DMA环形缓冲时隙数（偶数）
+#define BEEP_PRIO_NUM 4     ///< 播放通道（优先级）数量，0为最高
+#define BEEP_LOOP_FOREVER 0 ///< BEEP_Melody_t.loops 取此值时循环播放
+/** @} */
+
+/**
+ * @brief 音符
+ */
+typedef struct
+{
+  uint16_t freq; ///< 频率（Hz），0为休止
+  uint16_t ms;   ///< 时长（毫秒），按 BEEP_SLOT_MS 取整，至少一个时隙
+} BEEP_Note_t;
+
+/**
+ * @brief 旋律
+ * @note 播放期间引擎直接引用 notes，音符表须保持有效（通常为const常量）
+ */
+typedef struct
+{
+  const BEEP_Note_t *notes; ///< 音符表
+  uint16_t len;             ///< 音符数量
+  uint16_t loops;           ///< 播放次数，BEEP_LOOP_FOREVER 表示循环
+} BEEP_Melody_t;
+
+/**
+ * @brief 蜂鸣器引擎初始化
+ * @note 须在 BOARD_Init() 之后调用，PF8被重新配置为TIM13_CH1复用输出
+ */
+void BEEP_EngineInit(void);
+
+/**
+ * @brief 在指定优先级通道播放旋律
+ * @param melody 旋律（引擎保存指针，须保持有效）
+ * @param prio 优先级(0 ~ BEEP_PRIO_NUM-1)，0最高
+ * @note 替换该通道上正在播放的内容；可在任务与中断中调用
+ */
+void BEEP_Play(const BEEP_Melody_t *melody, uint8_t prio);
+
+/**
+ * @brief 在指定优先级通道播放单个音
+ * @param freq 频率（Hz）
+ * @param ms 时长（毫秒）
+ * @param prio 优先级(0 ~ BEEP_PRIO_NUM-1)，0最高
+ */
+void BEEP_Tone(uint16_t freq, uint16_t ms, uint8_t prio);
+
+/**
+ * @brief 停止指定优先级通道
+ * @param prio 优先级(0 ~ BEEP_PRIO_NUM-1)
+ */
+void BEEP_Stop(uint8_t prio);
+
+/**
+ * @brief 查询是否有通道在播放
+ * @retval 1: 正在播放，0: 空闲
+ */
+uint8_t BEEP_IsPlaying(void);
+
+/**
+ * @brief 频率换算为TIM13 ARR
+ * @param freq 频率（Hz），0为休止
+ * @retval ARR值
+ */
+uint16_t BEEP_FreqToArr(uint16_t freq);
+
+#endif
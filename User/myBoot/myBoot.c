@@ -0,0 +1,23 @@
+/**
+ * @file myBoot.c
+ * @brief 启动阶段计时实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myBoot.h"
+#include "../myMem/myMem.h"
+
+uint32_t BOOT_Stamps[BOOT_STAMP_NUM] MEM_NOINIT;
+
+void BOOT_GetReport(BOOT_Report_t *rep)
+{
+  uint32_t hsi_mhz = HSI_VALUE / 1000000;
+  uint32_t core_mhz = SystemCoreClock / 1000000;
+
+  rep->sysinit_us = BOOT_Stamps[BOOT_STAMP_SYSINIT] / hsi_mhz;
+  rep->cinit_us = (BOOT_Stamps[BOOT_STAMP_MAIN] - BOOT_Stamps[BOOT_STAMP_SYSINIT]) / core_mhz;
+  rep->app_us = (BOOT_Stamps[BOOT_STAMP_READY] - BOOT_Stamps[BOOT_STAMP_MAIN]) / core_mhz;
+  rep->total_us = rep->sysinit_us + rep->cinit_us + rep->app_us;
+}
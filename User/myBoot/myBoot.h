@@ -0,0 +1,66 @@
+/**
+ * @file myBoot.h
+ * @brief 启动阶段计时：复位到main、main到就绪
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * Reset_Handler 在第一条指令处启动并清零DWT->CYCCNT，SystemInit返回后
+ * 记录第一个时间戳；main入口与初始化完成处分别调用 BOOT_Mark()。
+ * 时间戳数组位于 MEM_NOINIT 段，不受段初始化影响。
+ *
+ * 启动阶段：
+ *   sysinit  复位 -> SystemInit返回（时钟切换前以HSI运行）
+ *   cinit    SystemInit返回 -> main（.data复制与.bss清零）
+ *   app      main -> 就绪（外设与任务初始化）
+ */
+
+#ifndef _MYBOOT_H_
+#define _MYBOOT_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @brief 时间戳编号
+ */
+typedef enum
+{
+  BOOT_STAMP_SYSINIT = 0, ///< SystemInit返回，由启动文件写入
+  BOOT_STAMP_MAIN,        ///< 进入main
+  BOOT_STAMP_READY,       ///< 初始化完成，即将进入主循环
+  BOOT_STAMP_NUM
+} BOOT_StampId;
+
+/**
+ * @brief 启动报告（微秒）
+ */
+typedef struct
+{
+  uint32_t sysinit_us; ///< 复位到SystemInit返回，按HSI频率换算
+  uint32_t cinit_us;   ///< SystemInit返回到main
+  uint32_t app_us;     ///< main到就绪
+  uint32_t total_us;   ///< 复位到就绪
+} BOOT_Report_t;
+
+/**
+ * @brief 各阶段的DWT周期时间戳，下标为 BOOT_StampId
+ */
+extern uint32_t BOOT_Stamps[BOOT_STAMP_NUM];
+
+/**
+ * @brief 记录时间戳
+ * @param id BOOT_STAMP_MAIN 或 BOOT_STAMP_READY
+ */
+static __INLINE void BOOT_Mark(BOOT_StampId id)
+{
+  BOOT_Stamps[id] = DWT->CYCCNT;
+}
+
+/**
+ * @brief 计算启动报告
+ * @param rep 输出报告
+ * @note 须在 BOOT_Mark(BOOT_STAMP_READY) 之后调用
+ */
+void BOOT_GetReport(BOOT_Report_t *rep);
+
+#endif
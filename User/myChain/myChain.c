@@ -0,0 +1,214 @@
+/**
+ * @file myChain.c
+ * @brief 软件分散/聚集DMA实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myChain.h"
+#include "../myMem/myMem.h"
+#include "../myIdle/myIdle.h"
+
+#define CHAIN_DMA_ERRORS (DMAM_EVT_TE | DMAM_EVT_DME)
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK）
+ */
+#define CHAIN_ENTER_CRITICAL()              \
+  uint32_t chain_primask = __get_PRIMASK(); \
+  __disable_irq()
+#define CHAIN_EXIT_CRITICAL() __set_PRIMASK(chain_primask)
+
+/**
+ * @brief 写入下一个非空段并使能数据流
+ * @retval 1 已启动；0 没有剩余的段
+ * @note 调用时数据流已停止（普通模式下传输完成时硬件清除EN）
+ */
+MEM_RAMFUNC static uint8_t CHAIN_Program(CHAIN_t *c, DMA_Stream_TypeDef *stream)
+{
+  const CHAIN_Seg_t *seg;
+
+  while (c->next < c->num)
+  {
+    seg = &c->segs[c->next++];
+    if (seg->len == 0)
+    {
+      continue;
+    }
+    stream->M0AR = (uint32_t)seg->addr;
+    stream->NDTR = seg->len;
+    stream->CR |= DMA_SxCR_EN;
+    c->segments++;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief 链结束：只报告一次
+ */
+static void CHAIN_Finish(CHAIN_t *c, ErrorStatus status)
+{
+  c->busy = 0;
+  if (status == SUCCESS)
+  {
+    c->chains++;
+  }
+  else
+  {
+    c->errors++;
+  }
+  IDLE_SetLatency(c->idle_id, IDLE_LATENCY_ANY);
+  if (c->cb)
+  {
+    c->cb(c->arg, status);
+  }
+}
+
+/**
+ * @brief DMA事件：传输完成时写入下一段，最后一段完成或出错时结束链
+ */
+MEM_RAMFUNC static void CHAIN_DmaEvent(void *arg, uint32_t evts)
+{
+  CHAIN_t *c = (CHAIN_t *)arg;
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(c->dma);
+
+  if (!c->busy)
+  {
+    return;
+  }
+  if (evts & CHAIN_DMA_ERRORS)
+  {
+    // 传输错误时硬件已清除EN；直接模式错误时数据流仍在运行
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN)
+      ;
+    DMAM_ClearFlags(c->dma, DMAM_EVT_ALL);
+    CHAIN_Finish(c, ERROR);
+  }
+  else if (evts & DMAM_EVT_TC)
+  {
+    // 分发只清除已使能中断的标志，HTIF/FEIF须在重新使能前清除
+    DMAM_ClearFlags(c->dma, DMAM_EVT_ALL);
+    if (!CHAIN_Program(c, stream))
+    {
+      CHAIN_Finish(c, SUCCESS);
+    }
+  }
+}
+
+ErrorStatus CHAIN_Init(CHAIN_t *c, const char *name, DMAM_Request req, DMA_InitTypeDef *init)
+{
+  DMA_Stream_TypeDef *stream;
+
+  c->busy = 0;
+  init->DMA_Memory0BaseAddr = 0;
+  init->DMA_BufferSize = 0;
+  init->DMA_MemoryInc = DMA_MemoryInc_Enable;
+  init->DMA_Mode = DMA_Mode_Normal;
+  // 此时只检查突发/FIFO组合，各段的对齐由 CHAIN_Start() 检查
+  if (DMAM_Validate(init) != SUCCESS)
+  {
+    return ERROR;
+  }
+  c->dma = DMAM_Alloc(req, name);
+  if (c->dma == DMAM_INVALID)
+  {
+    return ERROR;
+  }
+  c->idle_id = IDLE_Register(name);
+
+  stream = DMAM_GetStream(c->dma);
+  DMA_DeInit(stream);
+  init->DMA_Channel = DMAM_GetChannel(c->dma);
+  DMA_Init(stream, init);
+  DMA_ITConfig(stream, DMA_IT_TC | DMA_IT_TE | DMA_IT_DME, ENABLE);
+
+  if (DMAM_SetCallback(c->dma, CHAIN_DmaEvent, c, CHAIN_IRQ_PRIO) != SUCCESS)
+  {
+    DMAM_Free(c->dma);
+    c->dma = DMAM_INVALID;
+    return ERROR;
+  }
+  return SUCCESS;
+}
+
+/**
+ * @brief 占用链对象并启动第一段
+ */
+static ErrorStatus CHAIN_Submit(CHAIN_t *c, DMA_Stream_TypeDef *stream, const CHAIN_Seg_t *segs, uint8_t num,
+                                CHAIN_Callback cb, void *arg)
+{
+  CHAIN_ENTER_CRITICAL();
+
+  if (c->busy)
+  {
+    CHAIN_EXIT_CRITICAL();
+    return ERROR;
+  }
+  c->segs = segs;
+  c->num = num;
+  c->next = 0;
+  c->cb = cb;
+  c->arg = arg;
+  c->busy = 1;
+  // STOP会停止DMA时钟
+  IDLE_SetLatency(c->idle_id, 0);
+  DMAM_ClearFlags(c->dma, DMAM_EVT_ALL);
+  CHAIN_Program(c, stream);
+
+  CHAIN_EXIT_CRITICAL();
+  return SUCCESS;
+}
+
+ErrorStatus CHAIN_Start(CHAIN_t *c, const CHAIN_Seg_t *segs, uint8_t num, CHAIN_Callback cb, void *arg)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(c->dma);
+  uint32_t items = 0;
+  uint8_t i;
+
+  if (stream == 0)
+  {
+    return ERROR;
+  }
+  for (i = 0; i < num; i++)
+  {
+    if (segs[i].len && (segs[i].addr == 0 || DMAM_CheckBuffer(c->dma, segs[i].addr, segs[i].len) != SUCCESS))
+    {
+      return ERROR;
+    }
+    items += segs[i].len;
+  }
+  if (items == 0)
+  {
+    return ERROR;
+  }
+  return CHAIN_Submit(c, stream, segs, num, cb, arg);
+}
+
+void CHAIN_Abort(CHAIN_t *c)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(c->dma);
+  CHAIN_ENTER_CRITICAL();
+
+  if (stream == 0 || !c->busy)
+  {
+    CHAIN_EXIT_CRITICAL();
+    return;
+  }
+  stream->CR &= ~DMA_SxCR_EN;
+  while (stream->CR & DMA_SxCR_EN)
+    ;
+  // 关闭数据流置位的TCIF不再触发中断
+  DMAM_ClearFlags(c->dma, DMAM_EVT_ALL);
+  NVIC_ClearPendingIRQ(DMAM_GetIRQn(c->dma));
+  CHAIN_EXIT_CRITICAL();
+
+  CHAIN_Finish(c, ERROR);
+}
+
+uint8_t CHAIN_IsBusy(const CHAIN_t *c)
+{
+  return c->busy;
+}
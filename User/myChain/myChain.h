@@ -0,0 +1,101 @@
+/**
+ * @file myChain.h
+ * @brief 软件分散/聚集DMA：由传输完成中断逐段推进的描述符链
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * F4的DMA控制器没有链表描述符，一帧由帧头、数据、校验分散在不同缓冲时，
+ * 通常要先拷贝拼成一个缓冲再发送。本模块按描述符数组（地址+数据项数）
+ * 逐段传输：每段的传输完成中断中改写M0AR/NDTR并重新使能数据流，
+ * 整条链完成或出错时只调用一次回调，拼帧拷贝不再需要。
+ *
+ * 段间的间隙为一次中断响应加几次寄存器写入；UART/SPI的数据寄存器本身
+ * 有一级缓冲，这一间隙在一个字符时间内即被掩盖，线上看不到停顿。
+ * 未使用双缓冲模式(DBM)换段：DBM下NDTR对每个缓冲固定不变，且数据流
+ * 运行时无法在段边界停止，最后一段之后会继续传输空闲寄存器指向的缓冲。
+ */
+
+#ifndef _MYCHAIN_H_
+#define _MYCHAIN_H_
+
+#include "stm32f4xx.h"
+#include "../myDma/myDma.h"
+
+/**
+ * @defgroup CHAIN_Config 配置
+ * @{
+ */
+#define CHAIN_IRQ_PRIO ((1 << __NVIC_PRIO_BITS) - 2) ///< 中断优先级，段间间隙取决于中断响应
+/** @} */
+
+/**
+ * @brief 描述符：一段连续的存储器区域
+ */
+typedef struct
+{
+  const void *addr; ///< 存储器地址，不能位于CCM，按数据宽度/突发字节数对齐
+  uint16_t len;     ///< 数据项数（外设数据宽度为单位），0表示跳过
+} CHAIN_Seg_t;
+
+/**
+ * @brief 整条链完成回调，在DMA中断中调用
+ * @param arg CHAIN_Start() 的参数
+ * @param status SUCCESS；传输错误或被 CHAIN_Abort() 中止时为ERROR
+ */
+typedef void (*CHAIN_Callback)(void *arg, ErrorStatus status);
+
+/**
+ * @brief 链对象，由调用者分配存储，成员由本模块维护
+ */
+typedef struct
+{
+  uint8_t dma;               ///< DMA数据流句柄
+  uint8_t idle_id;           ///< 空闲管理中的模块编号
+  volatile uint8_t busy;     ///< 1: 链传输中
+  uint8_t next;              ///< 下一段的序号
+  uint8_t num;               ///< 描述符数
+  const CHAIN_Seg_t *segs;   ///< 描述符数组
+  CHAIN_Callback cb;         ///< 完成回调
+  void *arg;                 ///< 回调参数
+  uint32_t chains;           ///< 完成的链数
+  uint32_t segments;         ///< 传输的段数
+  uint32_t errors;           ///< 出错或中止的链数
+} CHAIN_t;
+
+/**
+ * @brief 初始化：分配数据流并配置为普通模式
+ * @param c 链对象
+ * @param name 使用者名称
+ * @param req DMA请求
+ * @param init DMA配置：由调用者填写外设地址、方向、数据宽度、优先级与FIFO；
+ *             通道、存储器递增与普通模式由本函数设置，地址与长度按段写入
+ * @retval SUCCESS；突发/FIFO组合非法（DMAM_Validate()）或数据流冲突时返回ERROR
+ * @note 在 VEC_Init() 之后调用；外设自身的DMA请求（USART_DMACmd 等）由调用者使能
+ */
+ErrorStatus CHAIN_Init(CHAIN_t *c, const char *name, DMAM_Request req, DMA_InitTypeDef *init);
+
+/**
+ * @brief 开始传输一条链
+ * @param c 链对象
+ * @param segs 描述符数组，完成之前须保持有效且内容不变
+ * @param num 描述符数
+ * @param cb 完成回调，可为NULL
+ * @param arg 回调参数
+ * @retval SUCCESS；上一条链未完成、没有非空的段，或某段不符合数据流配置
+ *         （DMAM_CheckBuffer()：位于CCM、未按数据宽度/突发对齐）时返回ERROR
+ * @note 可在中断中调用（包括完成回调中开始下一条链）
+ */
+ErrorStatus CHAIN_Start(CHAIN_t *c, const CHAIN_Seg_t *segs, uint8_t num, CHAIN_Callback cb, void *arg);
+
+/**
+ * @brief 中止正在传输的链，回调以ERROR调用一次
+ */
+void CHAIN_Abort(CHAIN_t *c);
+
+/**
+ * @brief 查询链是否在传输中
+ */
+uint8_t CHAIN_IsBusy(const CHAIN_t *c);
+
+#endif
@@ -0,0 +1,482 @@
+/**
+ * @file myClock.c
+ * @brief 运行时系统时钟档位切换与外设分频自动重算实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myClock.h"
+#include "../myTime/myTime.h"
+#include "../stm32f4xx_pll_conf.h"
+
+#define CLOCK_PLL_TIMEOUT 0x10000 ///< 等待PLL锁定/时钟切换的最大轮询次数
+#define CLOCK_TC_TIMEOUT 0x10000  ///< 切换前等待USART发送完成的最大轮询次数
+
+/**
+ * @brief 登记的外设类型
+ */
+enum
+{
+  CLOCK_CLIENT_USART = 0,
+  CLOCK_CLIENT_I2C,
+  CLOCK_CLIENT_TIM
+};
+
+/**
+ * @brief 登记的外设
+ */
+typedef struct
+{
+  void *periph;  ///< 外设基地址
+  uint8_t kind;  ///< CLOCK_CLIENT_xxx
+  uint32_t rate; ///< USART波特率 / I2C速率 / 定时器计数频率
+  uint32_t upd;  ///< 定时器更新频率
+} CLOCK_Client_t;
+
+/**
+ * @brief Flash等待周期：VDD 2.7~3.6V时每30MHz一个
+ */
+#define CLOCK_LATENCY_FOR(hz) (((hz) - 1) / 30000000UL)
+
+/**
+ * @brief 档位表，PLL参数与 system_stm32f4xx.c 的 SetSysClock() 相同，
+ *        均由 stm32f4xx_pll_conf.h 求解；BALANCED与PERF共用VCO，只加倍P
+ */
+static const CLOCK_Profile_t clock_profiles[CLOCK_PROFILE_NUM] = {
+    {"perf", CLOCK_PLL_SYSCLK_HZ, 1, CLOCK_PLL_M, CLOCK_PLL_N, CLOCK_PLL_P, CLOCK_PLL_Q,
+     RCC_SYSCLK_Div1, RCC_HCLK_Div4, RCC_HCLK_Div2, CLOCK_LATENCY_FOR(CLOCK_PLL_SYSCLK_HZ)},
+    {"balanced", CLOCK_PLL_SYSCLK_HZ / 2, 1, CLOCK_PLL_M, CLOCK_PLL_N, CLOCK_PLL_P * 2, CLOCK_PLL_Q,
+     RCC_SYSCLK_Div1, RCC_HCLK_Div2, RCC_HCLK_Div1, CLOCK_LATENCY_FOR(CLOCK_PLL_SYSCLK_HZ / 2)},
+    {"lowpower", HSI_VALUE, 0, 0, 0, 0, 0, RCC_SYSCLK_Div1, RCC_HCLK_Div1, RCC_HCLK_Div1, CLOCK_LATENCY_FOR(HSI_VALUE)},
+};
+
+CLOCK_STATIC_ASSERT(CLOCK_PLL_P * 2 <= 8, balanced_pll_p);
+
+static CLOCK_ProfileId clock_profile = CLOCK_PROFILE_PERF;
+static CLOCK_Client_t clock_clients[CLOCK_CLIENT_MAX];
+static uint8_t clock_client_num;
+static void (*clock_notify)(CLOCK_ProfileId id);
+static uint8_t clock_plli2s_on; ///< CLOCK_EnablePllI2s() 已启动PLLI2S
+static CLOCK_Tree_t clock_tree;
+static volatile uint32_t clock_tree_gen; ///< 快照对应的 RCC_GetClocksGeneration() + 1，0表示无效
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK，可嵌套在中断中使用）
+ */
+#define CLOCK_ENTER_CRITICAL()                \
+  uint32_t clock_primask = __get_PRIMASK();   \
+  __disable_irq()
+#define CLOCK_EXIT_CRITICAL() __set_PRIMASK(clock_primask)
+
+/**
+ * @brief 外设是否挂在APB2上
+ */
+static uint8_t CLOCK_OnApb2(const void *periph)
+{
+  return (uint32_t)periph >= APB2PERIPH_BASE && (uint32_t)periph < AHB1PERIPH_BASE;
+}
+
+/**
+ * @brief 登记外设，已登记时更新参数
+ */
+static uint8_t CLOCK_Register(void *periph, uint8_t kind, uint32_t rate, uint32_t upd)
+{
+  uint8_t i;
+
+  for (i = 0; i < clock_client_num; i++)
+  {
+    if (clock_clients[i].periph == periph)
+    {
+      break;
+    }
+  }
+  if (i == CLOCK_CLIENT_MAX)
+  {
+    return 0;
+  }
+
+  clock_clients[i].periph = periph;
+  clock_clients[i].kind = kind;
+  clock_clients[i].rate = rate;
+  clock_clients[i].upd = upd;
+  if (i == clock_client_num)
+  {
+    clock_client_num++;
+  }
+  return 1;
+}
+
+/**
+ * @brief 重算USART波特率，与 USART_Init() 的BRR计算相同
+ */
+static void CLOCK_RescaleUsart(USART_TypeDef *usart, uint32_t baud, const CLOCK_Tree_t *tree)
+{
+  uint32_t pclk = CLOCK_OnApb2(usart) ? tree->pclk2 : tree->pclk1;
+  uint32_t div;
+  uint32_t frac;
+  uint32_t brr;
+
+  if (usart->CR1 & USART_CR1_OVER8)
+  {
+    div = (25 * pclk) / (2 * baud);
+  }
+  else
+  {
+    div = (25 * pclk) / (4 * baud);
+  }
+  brr = (div / 100) << 4;
+  frac = div - 100 * (brr >> 4);
+
+  if (usart->CR1 & USART_CR1_OVER8)
+  {
+    brr |= ((frac * 8 + 50) / 100) & 0x07;
+  }
+  else
+  {
+    brr |= ((frac * 16 + 50) / 100) & 0x0F;
+  }
+  usart->BRR = (uint16_t)brr;
+}
+
+/**
+ * @brief 重算I2C时序，与 I2C_Init() 的计算相同；修改期间关闭PE
+ */
+static void CLOCK_RescaleI2c(I2C_TypeDef *i2c, uint32_t speed, const CLOCK_Tree_t *tree)
+{
+  uint32_t pclk = tree->pclk1;
+  uint16_t freq = (uint16_t)(pclk / 1000000);
+  uint16_t cr1 = i2c->CR1;
+  uint16_t ccr;
+
+  i2c->CR1 = cr1 & (uint16_t)~I2C_CR1_PE;
+  i2c->CR2 = (uint16_t)((i2c->CR2 & ~I2C_CR2_FREQ) | freq);
+
+  if (speed <= 100000)
+  {
+    ccr = (uint16_t)(pclk / (speed << 1));
+    if (ccr < 4)
+    {
+      ccr = 4;
+    }
+    i2c->TRISE = (uint16_t)(freq + 1);
+  }
+  else
+  {
+    if (i2c->CCR & I2C_CCR_DUTY)
+    {
+      ccr = (uint16_t)(pclk / (speed * 25)) | I2C_CCR_DUTY;
+    }
+    else
+    {
+      ccr = (uint16_t)(pclk / (speed * 3));
+    }
+    if ((ccr & I2C_CCR_CCR) == 0)
+    {
+      ccr |= 1;
+    }
+    ccr |= I2C_CCR_FS;
+    i2c->TRISE = (uint16_t)((freq * 300) / 1000 + 1);
+  }
+  i2c->CCR = ccr;
+  i2c->CR1 = cr1;
+}
+
+/**
+ * @brief 重算定时器PSC/ARR，写入预装载寄存器，下一个更新事件生效
+ */
+static void CLOCK_RescaleTimer(TIM_TypeDef *tim, uint32_t cnt_hz, uint32_t upd_hz)
+{
+  uint32_t clk = CLOCK_GetTimerClock(tim);
+  uint32_t psc = cnt_hz ? clk / cnt_hz - 1 : 0;
+
+  tim->PSC = (uint16_t)psc;
+  if (upd_hz)
+  {
+    tim->ARR = clk / (psc + 1) / upd_hz - 1;
+  }
+}
+
+/**
+ * @brief 切换时钟源与分频（调用者处于临界区）
+ * @note 调用前HSE已就绪（PLL档位）
+ */
+static ErrorStatus CLOCK_Apply(const CLOCK_Profile_t *prof)
+{
+  uint32_t timeout;
+
+  // SYSCLK先切到HSI，PLL才能重新配置
+  RCC_HSICmd(ENABLE);
+  while (RCC_GetFlagStatus(RCC_FLAG_HSIRDY) == RESET)
+    ;
+  RCC_SYSCLKConfig(RCC_SYSCLKSource_HSI);
+  while (RCC_GetSYSCLKSource() != 0x00)
+    ;
+
+  // 在16MHz下写入目标分频，任何分频组合都不会超过总线上限
+  RCC_HCLKConfig(prof->hpre);
+  RCC_PCLK1Config(prof->ppre1);
+  RCC_PCLK2Config(prof->ppre2);
+
+  RCC_PLLCmd(DISABLE);
+  if (!prof->pll)
+  {
+    RCC_HSEConfig(RCC_HSE_OFF);
+    return SUCCESS;
+  }
+
+  RCC_PLLConfig(RCC_PLLSource_HSE, prof->pll_m, prof->pll_n, prof->pll_p, prof->pll_q);
+  RCC_PLLCmd(ENABLE);
+  for (timeout = 0; RCC_GetFlagStatus(RCC_FLAG_PLLRDY) == RESET; timeout++)
+  {
+    if (timeout == CLOCK_PLL_TIMEOUT)
+    {
+      return ERROR;
+    }
+  }
+  RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+  while (RCC_GetSYSCLKSource() != 0x08)
+    ;
+  return SUCCESS;
+}
+
+ErrorStatus CLOCK_SetProfile(CLOCK_ProfileId id)
+{
+  const CLOCK_Profile_t *prof;
+  const CLOCK_Profile_t *cur;
+  const CLOCK_Tree_t *tree;
+  ErrorStatus status;
+  uint32_t timeout;
+  uint8_t i;
+
+  if (id >= CLOCK_PROFILE_NUM)
+  {
+    return ERROR;
+  }
+  if (id == clock_profile)
+  {
+    return SUCCESS;
+  }
+  prof = &clock_profiles[id];
+  cur = &clock_profiles[clock_profile];
+
+  // HSE先起振，失败时不做任何修改
+  if (prof->pll && RCC_GetFlagStatus(RCC_FLAG_HSERDY) == RESET)
+  {
+    RCC_HSEConfig(RCC_HSE_ON);
+    if (RCC_WaitForHSEStartUp() != SUCCESS)
+    {
+      RCC_HSEConfig(RCC_HSE_OFF);
+      return ERROR;
+    }
+  }
+
+  // 等待正在发送的字节发完，避免切换时产生错误波特率的帧
+  for (i = 0; i < clock_client_num; i++)
+  {
+    if (clock_clients[i].kind == CLOCK_CLIENT_USART)
+    {
+      USART_TypeDef *usart = (USART_TypeDef *)clock_clients[i].periph;
+
+      for (timeout = 0; (usart->SR & USART_SR_TC) == 0 && timeout < CLOCK_TC_TIMEOUT; timeout++)
+        ;
+    }
+  }
+
+  {
+    CLOCK_ENTER_CRITICAL();
+
+    if (prof->latency > cur->latency)
+    {
+      FLASH_SetLatency(prof->latency);
+      while ((FLASH->ACR & FLASH_ACR_LATENCY) != prof->latency)
+        ;
+    }
+
+    status = CLOCK_Apply(prof);
+    if (status != SUCCESS)
+    {
+      // PLL未锁定：停在HSI，按低功耗档位继续运行
+      id = CLOCK_PROFILE_LOWPOWER;
+      prof = &clock_profiles[id];
+      CLOCK_Apply(prof);
+    }
+
+    if ((FLASH->ACR & FLASH_ACR_LATENCY) > prof->latency)
+    {
+      FLASH_SetLatency(prof->latency);
+    }
+    clock_profile = id;
+
+    SystemCoreClockUpdate();
+    TIME_Recalibrate();
+
+    tree = CLOCK_GetTree();
+    for (i = 0; i < clock_client_num; i++)
+    {
+      CLOCK_Client_t *c = &clock_clients[i];
+
+      switch (c->kind)
+      {
+      case CLOCK_CLIENT_USART:
+        CLOCK_RescaleUsart((USART_TypeDef *)c->periph, c->rate, tree);
+        break;
+      case CLOCK_CLIENT_I2C:
+        CLOCK_RescaleI2c((I2C_TypeDef *)c->periph, c->rate, tree);
+        break;
+      default:
+        CLOCK_RescaleTimer((TIM_TypeDef *)c->periph, c->rate, c->upd);
+        break;
+      }
+    }
+
+    if (clock_notify)
+    {
+      clock_notify(id);
+    }
+
+    CLOCK_EXIT_CRITICAL();
+  }
+  return status;
+}
+
+ErrorStatus CLOCK_EnablePllI2s(void)
+{
+  uint32_t timeout;
+
+  RCC_PLLI2SCmd(DISABLE);
+  RCC_PLLI2SConfig(CLOCK_PLLI2S_N, CLOCK_PLLI2S_R);
+  RCC_PLLI2SCmd(ENABLE);
+  for (timeout = 0; RCC_GetFlagStatus(RCC_FLAG_PLLI2SRDY) == RESET; timeout++)
+  {
+    if (timeout == CLOCK_PLL_TIMEOUT)
+    {
+      return ERROR;
+    }
+  }
+  clock_plli2s_on = 1;
+  return SUCCESS;
+}
+
+ErrorStatus CLOCK_Resume(void)
+{
+  const CLOCK_Profile_t *prof = &clock_profiles[clock_profile];
+  uint32_t timeout;
+
+  if (!prof->pll)
+  {
+    return SUCCESS;
+  }
+
+  RCC_HSEConfig(RCC_HSE_ON);
+  if (RCC_WaitForHSEStartUp() == SUCCESS)
+  {
+    RCC_PLLCmd(ENABLE);
+    for (timeout = 0; RCC_GetFlagStatus(RCC_FLAG_PLLRDY) == RESET && timeout < CLOCK_PLL_TIMEOUT; timeout++)
+      ;
+    if (timeout < CLOCK_PLL_TIMEOUT)
+    {
+      RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+      while (RCC_GetSYSCLKSource() != 0x08)
+        ;
+      if (clock_plli2s_on)
+      {
+        RCC_PLLI2SCmd(ENABLE);
+      }
+      return SUCCESS;
+    }
+  }
+
+  // 已停在HSI：按低功耗档位重算SystemCoreClock与外设分频
+  CLOCK_SetProfile(CLOCK_PROFILE_LOWPOWER);
+  return ERROR;
+}
+
+CLOCK_ProfileId CLOCK_GetProfile(void)
+{
+  return clock_profile;
+}
+
+const CLOCK_Profile_t *CLOCK_GetProfileInfo(CLOCK_ProfileId id)
+{
+  return id < CLOCK_PROFILE_NUM ? &clock_profiles[id] : 0;
+}
+
+uint8_t CLOCK_RegisterUsart(USART_TypeDef *usart, uint32_t baud)
+{
+  return CLOCK_Register(usart, CLOCK_CLIENT_USART, baud, 0);
+}
+
+uint8_t CLOCK_RegisterI2c(I2C_TypeDef *i2c, uint32_t speed)
+{
+  return CLOCK_Register(i2c, CLOCK_CLIENT_I2C, speed, 0);
+}
+
+uint8_t CLOCK_RegisterTimer(TIM_TypeDef *tim, uint32_t cnt_hz, uint32_t update_hz)
+{
+  return CLOCK_Register(tim, CLOCK_CLIENT_TIM, cnt_hz, update_hz);
+}
+
+void CLOCK_SetNotify(void (*notify)(CLOCK_ProfileId id))
+{
+  clock_notify = notify;
+}
+
+/**
+ * @brief 由RCC寄存器计算时钟树
+ */
+static void CLOCK_BuildTree(CLOCK_Tree_t *t)
+{
+  RCC_ClocksTypeDef clocks;
+  uint32_t pllcfgr = RCC->PLLCFGR;
+  uint32_t i2scfgr = RCC->PLLI2SCFGR;
+  uint32_t vco_in;
+
+  RCC_GetClocksFreq(&clocks);
+  t->sysclk = clocks.SYSCLK_Frequency;
+  t->hclk = clocks.HCLK_Frequency;
+  t->pclk1 = clocks.PCLK1_Frequency;
+  t->pclk2 = clocks.PCLK2_Frequency;
+  // APB分频为1时定时器时钟等于PCLK，否则为PCLK的2倍
+  t->tim_apb1 = t->pclk1 == t->hclk ? t->pclk1 : t->pclk1 * 2;
+  t->tim_apb2 = t->pclk2 == t->hclk ? t->pclk2 : t->pclk2 * 2;
+
+  // PLL与PLLI2S共用输入时钟与M分频
+  vco_in = ((pllcfgr & RCC_PLLCFGR_PLLSRC) ? HSE_VALUE : HSI_VALUE) / (pllcfgr & RCC_PLLCFGR_PLLM);
+  t->pll48 = 0;
+  if (RCC->CR & RCC_CR_PLLON)
+  {
+    t->pll48 = vco_in * ((pllcfgr & RCC_PLLCFGR_PLLN) >> 6) / ((pllcfgr & RCC_PLLCFGR_PLLQ) >> 24);
+  }
+  t->plli2s = 0;
+  if (RCC->CR & RCC_CR_PLLI2SON)
+  {
+    t->plli2s = vco_in * ((i2scfgr & RCC_PLLI2SCFGR_PLLI2SN) >> 6) / ((i2scfgr & RCC_PLLI2SCFGR_PLLI2SR) >> 28);
+  }
+}
+
+const CLOCK_Tree_t *CLOCK_GetTree(void)
+{
+  uint32_t gen = RCC_GetClocksGeneration();
+
+  if (clock_tree_gen != gen + 1)
+  {
+    CLOCK_Tree_t t;
+
+    CLOCK_BuildTree(&t);
+    {
+      CLOCK_ENTER_CRITICAL();
+      clock_tree = t;
+      clock_tree_gen = gen + 1;
+      CLOCK_EXIT_CRITICAL();
+    }
+  }
+  return &clock_tree;
+}
+
+uint32_t CLOCK_GetTimerClock(TIM_TypeDef *tim)
+{
+  const CLOCK_Tree_t *tree = CLOCK_GetTree();
+
+  return CLOCK_OnApb2(tim) ? tree->tim_apb2 : tree->tim_apb1;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file myClock.h
+ * @brief 运行时系统时钟档位切换与外设分频自动重算
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * SystemInit() 按编译期参数把系统时钟配置为168MHz，对应档位
+ * CLOCK_PROFILE_PERF。CLOCK_SetProfile() 在运行时切换到其他档位：
+ *   1. 目标频率更高时先增加Flash等待周期；
+ *   2. SYSCLK临时切到HSI，写入AHB/APB分频，重新配置并锁定PLL后切回；
+ *   3. 目标频率更低时最后减少Flash等待周期；
+ *   4. 更新 SystemCoreClock，重装SysTick，按新的总线时钟重算已登记
+ *      外设的USART BRR、I2C CCR/TRISE与定时器PSC/ARR，最后调用通知回调。
+ * 低功耗档位直接使用HSI并关闭PLL与HSE。
+ *
+ * 外设在各自的初始化完成后调用 CLOCK_RegisterXxx() 登记期望的波特率、
+ * 总线速率或计数频率，切换档位时不需要重新初始化驱动。定时器的新PSC/ARR
+ * 写入预装载寄存器，在下一个更新事件生效，不打断正在输出的波形。
+ */
+
+#ifndef _MYCLOCK_H_
+#define _MYCLOCK_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @brief 时钟档位
+ */
+typedef enum
+{
+  CLOCK_PROFILE_PERF = 0, ///< 168MHz，HSE+PLL，APB1 42MHz，APB2 84MHz
+  CLOCK_PROFILE_BALANCED, ///< 84MHz，HSE+PLL，APB1 42MHz，APB2 84MHz
+  CLOCK_PROFILE_LOWPOWER, ///< 16MHz，HSI，PLL与HSE关闭
+  CLOCK_PROFILE_NUM
+} CLOCK_ProfileId;
+
+#define CLOCK_CLIENT_MAX 8 ///< 可登记的外设数量
+
+/**
+ * @brief 时钟树快照（Hz）
+ */
+typedef struct
+{
+  uint32_t sysclk;   ///< SYSCLK
+  uint32_t hclk;     ///< AHB
+  uint32_t pclk1;    ///< APB1
+  uint32_t pclk2;    ///< APB2
+  uint32_t tim_apb1; ///< APB1定时器时钟
+  uint32_t tim_apb2; ///< APB2定时器时钟
+  uint32_t pll48;    ///< PLL Q输出（USB OTG FS/SDIO/RNG），PLL关闭时为0
+  uint32_t plli2s;   ///< PLLI2S R输出（I2S），PLLI2S关闭时为0
+} CLOCK_Tree_t;
+
+/**
+ * @brief 档位参数
+ */
+typedef struct
+{
+  const char *name; ///< 档位名称
+  uint32_t sysclk;  ///< SYSCLK频率（Hz）
+  uint8_t pll;      ///< 1: HSE经PLL，0: 直接使用HSI
+  uint16_t pll_m;   ///< PLL参数，pll为0时忽略
+  uint16_t pll_n;
+  uint16_t pll_p;
+  uint16_t pll_q;
+  uint32_t hpre;    ///< AHB分频，RCC_SYSCLK_DivX
+  uint32_t ppre1;   ///< APB1分频，RCC_HCLK_DivX
+  uint32_t ppre2;   ///< APB2分频，RCC_HCLK_DivX
+  uint32_t latency; ///< Flash等待周期，FLASH_Latency_X（VDD 2.7~3.6V）
+} CLOCK_Profile_t;
+
+/**
+ * @brief 切换时钟档位
+ * @param id 目标档位
+ * @retval SUCCESS: 已切换；ERROR: 档位无效或HSE未起振（时钟保持不变），
+ *         或PLL未锁定（退回 CLOCK_PROFILE_LOWPOWER）
+ * @note 切换期间关中断，PLL锁定约需数百微秒；切换前等待已登记USART发送完成
+ */
+ErrorStatus CLOCK_SetProfile(CLOCK_ProfileId id);
+
+/**
+ * @brief 按 stm32f4xx_pll_conf.h 求解的参数配置并启动PLLI2S
+ * @retval SUCCESS: 已锁定；ERROR: 超时
+ * @note PLLI2S与主PLL共用输入时钟与M分频，低功耗档位关闭HSE后PLLI2S失去输入
+ */
+ErrorStatus CLOCK_EnablePllI2s(void);
+
+/**
+ * @brief STOP模式唤醒后恢复当前档位的时钟源
+ * @retval SUCCESS: 已恢复；ERROR: HSE或PLL启动失败，已按低功耗档位运行
+ * @note 唤醒后硬件以HSI运行并关闭HSE、PLL与PLLI2S，分频与PLL参数保持不变；
+ *       低功耗档位本身运行在HSI上，无需恢复
+ */
+ErrorStatus CLOCK_Resume(void);
+
+/**
+ * @brief 获取当前档位
+ */
+CLOCK_ProfileId CLOCK_GetProfile(void);
+
+/**
+ * @brief 获取档位参数
+ * @retval 参数表项，id无效时返回NULL
+ */
+const CLOCK_Profile_t *CLOCK_GetProfileInfo(CLOCK_ProfileId id);
+
+/**
+ * @brief 登记USART，切换档位后按新的PCLK重算BRR
+ * @param usart USART1~USART6/UART4/UART5
+ * @param baud 波特率
+ * @retval 1: 成功，0: 登记表已满
+ * @note 同一外设重复登记时更新参数，下同
+ */
+uint8_t CLOCK_RegisterUsart(USART_TypeDef *usart, uint32_t baud);
+
+/**
+ * @brief 登记I2C，切换档位后按新的PCLK1重算FREQ/CCR/TRISE
+ * @param i2c I2C1~I2C3
+ * @param speed 总线速率（Hz），大于100kHz为快速模式（保留当前DUTY设置）
+ * @retval 1: 成功，0: 登记表已满
+ * @note PCLK1须不低于2MHz（快速模式4MHz）
+ */
+uint8_t CLOCK_RegisterI2c(I2C_TypeDef *i2c, uint32_t speed);
+
+/**
+ * @brief 登记定时器，切换档位后重算PSC/ARR
+ * @param tim 定时器
+ * @param cnt_hz 计数频率（Hz），0表示不分频（PSC=0）
+ * @param update_hz 更新频率（Hz），0表示保持ARR不变
+ * @retval 1: 成功，0: 登记表已满
+ */
+uint8_t CLOCK_RegisterTimer(TIM_TypeDef *tim, uint32_t cnt_hz, uint32_t update_hz);
+
+/**
+ * @brief 设置档位切换完成后的通知回调
+ * @param notify 回调函数，在关中断状态下调用，NULL表示取消
+ * @note 用于登记表无法覆盖的外设（如SPI分频、ADC预分频）
+ */
+void CLOCK_SetNotify(void (*notify)(CLOCK_ProfileId id));
+
+/**
+ * @brief 获取时钟树快照
+ * @retval 快照，只读
+ * @note 快照在RCC驱动的时钟配置函数调用后失效，下一次调用时重新计算；
+ *       其余情况只比较一次代数计数，O(1)，可在中断中调用
+ */
+const CLOCK_Tree_t *CLOCK_GetTree(void);
+
+/**
+ * @brief 获取定时器的输入时钟
+ * @param tim 定时器
+ * @retval 频率（Hz）：APB分频为1时等于PCLK，否则为PCLK的2倍
+ */
+uint32_t CLOCK_GetTimerClock(TIM_TypeDef *tim);
+
+#endif
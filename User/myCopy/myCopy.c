@@ -0,0 +1,383 @@
+/**
+ * @file myCopy.c
+ * @brief 异步DMA拷贝/填充队列实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include <string.h>
+
+#include "./myCopy.h"
+#include "../myDma/myDma.h"
+#include "../myMem/myMem.h"
+#include "../myIdle/myIdle.h"
+
+#define COPY_ALIGN 16         ///< FIFO大小，也是一次突发的字节数
+#define COPY_NDTR_MAX 65535   ///< 单段传输的最大数据项数
+#define COPY_DMA_ERRORS (DMAM_EVT_TE | DMAM_EVT_DME | DMAM_EVT_FE)
+
+/**
+ * @brief 排队的请求
+ */
+typedef struct
+{
+  uint8_t *dst;       ///< 剩余部分的目的地址
+  const uint8_t *src; ///< 剩余部分的源地址，NULL表示填充
+  uint32_t len;       ///< 剩余字节数
+  uint32_t fill;      ///< 填充字（字节重复4次）
+  uint32_t chunk;     ///< 正在传输的字节数
+  uint8_t size;       ///< 数据宽度（1/2/4字节）
+  COPY_Callback cb;   ///< 完成回调
+  void *arg;          ///< 回调参数
+} COPY_Job_t;
+
+static COPY_Job_t copy_jobs[COPY_QUEUE_LEN] MEM_CCM;
+static uint8_t copy_head;
+static uint8_t copy_count;
+static volatile uint8_t copy_active;      ///< DMA传输进行中
+static COPY_Ticket copy_submitted;        ///< 最后提交的票据
+static volatile COPY_Ticket copy_done;    ///< 最后完成的票据
+static uint8_t copy_dma = DMAM_INVALID;   ///< 分配到的DMA2数据流
+static uint8_t copy_idle_id = 0xFF;       ///< 空闲管理中的模块编号，队列非空时不允许STOP
+static COPY_Stats_t copy_stats;
+
+/**
+ * @brief 填充源：存储器到存储器模式下源端固定指向该字
+ */
+MEM_DMA_BUF(static uint32_t, copy_fill, [1]);
+
+/**
+ * @brief 按数据宽度（下标为宽度/2）的CR配置：数据宽度与16字节目的端突发
+ */
+static const uint32_t copy_cr_size[3] = {
+    DMA_PeripheralDataSize_Byte | DMA_MemoryDataSize_Byte | DMA_MemoryBurst_INC16,
+    DMA_PeripheralDataSize_HalfWord | DMA_MemoryDataSize_HalfWord | DMA_MemoryBurst_INC8,
+    DMA_PeripheralDataSize_Word | DMA_MemoryDataSize_Word | DMA_MemoryBurst_INC4,
+};
+
+/**
+ * @brief 源端也对齐到16字节时的源端突发
+ */
+static const uint32_t copy_cr_pburst[3] = {DMA_PeripheralBurst_INC16, DMA_PeripheralBurst_INC8,
+                                           DMA_PeripheralBurst_INC4};
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK）
+ */
+#define COPY_ENTER_CRITICAL()              \
+  uint32_t copy_primask = __get_PRIMASK(); \
+  __disable_irq()
+#define COPY_EXIT_CRITICAL() __set_PRIMASK(copy_primask)
+
+/**
+ * @brief 下一个票据，跳过表示失败的0
+ */
+static COPY_Ticket COPY_Next(COPY_Ticket t)
+{
+  return t + 1 ? t + 1 : 1;
+}
+
+/**
+ * @brief CPU拷贝或填充
+ */
+static void COPY_Cpu(uint8_t *dst, const uint8_t *src, uint32_t fill, uint32_t len)
+{
+  if (src)
+  {
+    memcpy(dst, src, len);
+  }
+  else
+  {
+    memset(dst, (int)(fill & 0xFF), len);
+  }
+}
+
+/**
+ * @brief 启动当前请求的下一段DMA传输
+ */
+MEM_RAMFUNC static void COPY_Chunk(COPY_Job_t *job)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(copy_dma);
+  uint32_t per = COPY_ALIGN / job->size;
+  uint32_t items = job->len / job->size;
+  uint32_t cr;
+
+  // 每段的数据项数须为突发拍数的整数倍
+  if (items > COPY_NDTR_MAX - COPY_NDTR_MAX % per)
+  {
+    items = COPY_NDTR_MAX - COPY_NDTR_MAX % per;
+  }
+  job->chunk = items * job->size;
+
+  cr = DMA_DIR_MemoryToMemory | DMA_MemoryInc_Enable | copy_cr_size[job->size >> 1] | COPY_DMA_PRIORITY |
+       DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+  if (job->src)
+  {
+    stream->PAR = (uint32_t)job->src;
+    cr |= DMA_PeripheralInc_Enable;
+    if (((uint32_t)job->src & (COPY_ALIGN - 1)) == 0)
+    {
+      cr |= copy_cr_pburst[job->size >> 1];
+    }
+  }
+  else
+  {
+    copy_fill[0] = job->fill;
+    stream->PAR = (uint32_t)MEM_DMA_PTR(copy_fill);
+  }
+  stream->M0AR = (uint32_t)job->dst;
+  stream->NDTR = items;
+  // 上一段留下的HTIF/FEIF等标志须在使能前清除
+  DMAM_ClearFlags(copy_dma, DMAM_EVT_ALL);
+  // 存储器到存储器不支持直接模式，FIFO满16字节时以一次突发写出
+  stream->FCR = DMA_FIFOMode_Enable | DMA_FIFOThreshold_Full;
+  stream->CR = cr;
+  stream->CR = cr | DMA_SxCR_EN;
+
+  copy_active = 1;
+  copy_stats.chunks++;
+}
+
+/**
+ * @brief 开始队首请求：CPU完成首尾，主体交给DMA
+ * @retval 1 DMA已启动；0 已由CPU全部完成
+ */
+static uint8_t COPY_Start(COPY_Job_t *job)
+{
+  uint32_t head;
+  uint32_t tail;
+  uint32_t x;
+
+  if (copy_dma == DMAM_INVALID || job->len < COPY_CPU_BYTES || MEM_IS_CCM(job->dst) ||
+      (job->src && MEM_IS_CCM(job->src)))
+  {
+    COPY_Cpu(job->dst, job->src, job->fill, job->len);
+    copy_stats.cpu_jobs++;
+    return 0;
+  }
+
+  head = (COPY_ALIGN - ((uint32_t)job->dst & (COPY_ALIGN - 1))) & (COPY_ALIGN - 1);
+  tail = (job->len - head) & (COPY_ALIGN - 1);
+  COPY_Cpu(job->dst, job->src, job->fill, head);
+  COPY_Cpu(job->dst + job->len - tail, job->src ? job->src + job->len - tail : 0, job->fill, tail);
+  job->dst += head;
+  if (job->src)
+  {
+    job->src += head;
+  }
+  job->len -= head + tail;
+
+  // 目的已对齐到16字节，宽度只取决于源地址的低位
+  x = job->src ? (uint32_t)job->src : 0;
+  job->size = (x & 3) == 0 ? 4 : ((x & 1) == 0 ? 2 : 1);
+
+  COPY_Chunk(job);
+  copy_stats.dma_jobs++;
+  return 1;
+}
+
+/**
+ * @brief 队首请求完成：出队并调用回调
+ * @note 在最低优先级的DMA中断中运行，更高优先级的中断可能同时提交请求，
+ *       出队与计数须在临界区内完成；回调在临界区外调用
+ */
+static void COPY_Finish(ErrorStatus status)
+{
+  COPY_Callback cb;
+  void *arg;
+  COPY_ENTER_CRITICAL();
+
+  cb = copy_jobs[copy_head].cb;
+  arg = copy_jobs[copy_head].arg;
+  copy_head = (uint8_t)((copy_head + 1) % COPY_QUEUE_LEN);
+  copy_count--;
+  copy_done = COPY_Next(copy_done);
+  if (copy_count == 0)
+  {
+    IDLE_SetLatency(copy_idle_id, IDLE_LATENCY_ANY);
+  }
+
+  COPY_EXIT_CRITICAL();
+  if (cb)
+  {
+    cb(arg, status);
+  }
+}
+
+/**
+ * @brief DMA事件：推进当前请求，空闲时开始队首请求
+ * @note evts为0时是提交者软件挂起的中断
+ */
+MEM_RAMFUNC static void COPY_DmaEvent(void *arg, uint32_t evts)
+{
+  COPY_Job_t *job = &copy_jobs[copy_head];
+
+  (void)arg;
+  if (copy_active && (evts & (DMAM_EVT_TC | COPY_DMA_ERRORS)))
+  {
+    copy_active = 0;
+    if (evts & COPY_DMA_ERRORS)
+    {
+      copy_stats.errors++;
+      COPY_Finish(ERROR);
+    }
+    else
+    {
+      copy_stats.dma_bytes += job->chunk;
+      job->dst += job->chunk;
+      if (job->src)
+      {
+        job->src += job->chunk;
+      }
+      job->len -= job->chunk;
+      if (job->len)
+      {
+        COPY_Chunk(job);
+        return;
+      }
+      COPY_Finish(SUCCESS);
+    }
+  }
+
+  while (!copy_active && copy_count)
+  {
+    if (!COPY_Start(&copy_jobs[copy_head]))
+    {
+      COPY_Finish(SUCCESS);
+    }
+  }
+}
+
+ErrorStatus COPY_Init(void)
+{
+  if (copy_idle_id == 0xFF)
+  {
+    copy_idle_id = IDLE_Register("copy");
+  }
+  if (copy_dma == DMAM_INVALID)
+  {
+    copy_dma = DMAM_Alloc(DMAM_REQ_MEM2MEM, "copy");
+  }
+  if (copy_dma == DMAM_INVALID)
+  {
+    return ERROR;
+  }
+  if (DMAM_SetCallback(copy_dma, COPY_DmaEvent, 0, (1 << __NVIC_PRIO_BITS) - 1) != SUCCESS)
+  {
+    DMAM_Free(copy_dma);
+    copy_dma = DMAM_INVALID;
+    return ERROR;
+  }
+  return SUCCESS;
+}
+
+/**
+ * @brief 提交请求
+ * @param src 源地址，NULL表示填充
+ */
+static COPY_Ticket COPY_Submit(void *dst, const void *src, uint32_t fill, uint32_t len, COPY_Callback cb, void *arg)
+{
+  COPY_Job_t *job;
+  COPY_Ticket t;
+  COPY_ENTER_CRITICAL();
+
+  // 没有DMA时全部请求在调用者中完成；长度不受限，拷贝放在临界区外，
+  // 只有票据的分配与完成在临界区内
+  if (copy_dma == DMAM_INVALID)
+  {
+    copy_stats.cpu_jobs++;
+    t = copy_submitted = COPY_Next(copy_submitted);
+    COPY_EXIT_CRITICAL();
+
+    COPY_Cpu((uint8_t *)dst, (const uint8_t *)src, fill, len);
+    __disable_irq();
+    // 拷贝期间被抢占的提交可能已先完成更新的票据
+    if ((int32_t)(t - copy_done) > 0)
+    {
+      copy_done = t;
+    }
+    COPY_EXIT_CRITICAL();
+    if (cb)
+    {
+      cb(arg, SUCCESS);
+    }
+    return t;
+  }
+  // 队列为空的短请求直接完成，不经过中断；不超过 COPY_CPU_BYTES，关中断时间有界
+  if (copy_count == 0 && len < COPY_CPU_BYTES)
+  {
+    COPY_Cpu((uint8_t *)dst, (const uint8_t *)src, fill, len);
+    copy_stats.cpu_jobs++;
+    t = copy_submitted = COPY_Next(copy_submitted);
+    copy_done = t;
+    COPY_EXIT_CRITICAL();
+    if (cb)
+    {
+      cb(arg, SUCCESS);
+    }
+    return t;
+  }
+  if (copy_count == COPY_QUEUE_LEN)
+  {
+    copy_stats.full++;
+    COPY_EXIT_CRITICAL();
+    return 0;
+  }
+
+  job = &copy_jobs[(copy_head + copy_count) % COPY_QUEUE_LEN];
+  job->dst = (uint8_t *)dst;
+  job->src = (const uint8_t *)src;
+  job->len = len;
+  job->fill = fill;
+  job->cb = cb;
+  job->arg = arg;
+  if (++copy_count > copy_stats.peak)
+  {
+    copy_stats.peak = copy_count;
+  }
+  t = copy_submitted = COPY_Next(copy_submitted);
+  // STOP会停止DMA时钟
+  IDLE_SetLatency(copy_idle_id, 0);
+
+  // 空闲时挂起DMA中断，由中断开始传输，请求只在一个上下文中推进
+  if (!copy_active)
+  {
+    NVIC_SetPendingIRQ(DMAM_GetIRQn(copy_dma));
+  }
+  COPY_EXIT_CRITICAL();
+  return t;
+}
+
+COPY_Ticket COPY_Memcpy(void *dst, const void *src, uint32_t len, COPY_Callback cb, void *arg)
+{
+  return COPY_Submit(dst, src, 0, len, cb, arg);
+}
+
+COPY_Ticket COPY_Memset(void *dst, uint8_t value, uint32_t len, COPY_Callback cb, void *arg)
+{
+  return COPY_Submit(dst, 0, value * 0x01010101UL, len, cb, arg);
+}
+
+uint8_t COPY_IsDone(COPY_Ticket t)
+{
+  return (int32_t)(copy_done - t) >= 0;
+}
+
+void COPY_Wait(COPY_Ticket t)
+{
+  // 关中断检查后再WFI：完成中断在检查之后到来时WFI立即返回，不会错过
+  __disable_irq();
+  while (!COPY_IsDone(t))
+  {
+    __WFI();
+    __enable_irq();
+    __disable_irq();
+  }
+  __enable_irq();
+}
+
+const COPY_Stats_t *COPY_GetStats(void)
+{
+  return &copy_stats;
+}
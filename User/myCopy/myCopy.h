@@ -0,0 +1,115 @@
+/**
+ * @file myCopy.h
+ * @brief 基于DMA2存储器到存储器传输的异步拷贝/填充队列
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * COPY_Memcpy()/COPY_Memset() 把请求放入提交队列后立即返回票据，
+ * 传输由DMA2在后台完成，CPU同时可以继续计算；完成后调用回调，
+ * 或由 COPY_IsDone()/COPY_Wait() 按票据查询。请求按提交顺序执行。
+ *
+ * - 只有DMA2支持存储器到存储器，数据流由 DMAM_Alloc(DMAM_REQ_MEM2MEM) 分配；
+ * - 目的地址先由CPU对齐到16字节，剩余长度按16字节取整，首尾不足16字节的
+ *   部分由CPU完成；主体按源/目的的相对对齐选择字/半字/字节宽度，
+ *   以满FIFO(16字节)的INC4/INC8/INC16突发传输，源地址也对齐到16字节时
+ *   源端同样突发；
+ * - 超过 65535 个数据项的请求自动拆分为多段连续传输；
+ * - 短于 COPY_CPU_BYTES 的请求、涉及CCM的请求（DMA不能访问CCM）由CPU完成：
+ *   队列为空时在调用者中直接完成，否则排队按序完成。
+ *
+ * 回调在DMA中断（最低优先级）中调用；直接完成的短请求在调用者中调用。
+ * 队列非空期间向空闲管理声明唤醒延迟容限0，不进入STOP。
+ * 源与目的区域不能重叠。
+ */
+
+#ifndef _MYCOPY_H_
+#define _MYCOPY_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @defgroup COPY_Config 配置
+ * @{
+ */
+#define COPY_QUEUE_LEN 8                       ///< 提交队列深度
+#define COPY_CPU_BYTES 64                      ///< 短于该长度由CPU完成，DMA的启动开销超过收益
+#define COPY_DMA_PRIORITY DMA_Priority_Low     ///< 数据流仲裁优先级，低于外设DMA
+/** @} */
+
+/**
+ * @brief 票据，按提交顺序递增；0表示提交失败（队列已满）
+ */
+typedef uint32_t COPY_Ticket;
+
+/**
+ * @brief 完成回调
+ * @param arg 提交时的参数
+ * @param status SUCCESS；DMA传输错误时为ERROR
+ */
+typedef void (*COPY_Callback)(void *arg, ErrorStatus status);
+
+/**
+ * @brief 拷贝统计
+ */
+typedef struct
+{
+  uint32_t dma_jobs;  ///< 由DMA完成的请求数
+  uint32_t cpu_jobs;  ///< 由CPU完成的请求数
+  uint32_t chunks;    ///< DMA传输段数（超过65535项的请求拆分为多段）
+  uint64_t dma_bytes; ///< DMA搬运的字节数
+  uint32_t errors;    ///< 传输错误次数
+  uint32_t full;      ///< 队列已满被拒绝的次数
+  uint8_t peak;       ///< 队列深度峰值
+} COPY_Stats_t;
+
+/**
+ * @brief 初始化：分配DMA2数据流并登记中断回调
+ * @retval SUCCESS；没有空闲数据流时返回ERROR，之后的请求全部由CPU完成
+ * @note 在 VEC_Init() 之后调用
+ */
+ErrorStatus COPY_Init(void);
+
+/**
+ * @brief 异步拷贝
+ * @param dst 目的地址
+ * @param src 源地址
+ * @param len 字节数
+ * @param cb 完成回调，可为NULL
+ * @param arg 回调参数
+ * @retval 票据，队列已满返回0
+ * @note 完成之前不能修改源区域，也不能读取目的区域；可在中断中调用
+ */
+COPY_Ticket COPY_Memcpy(void *dst, const void *src, uint32_t len, COPY_Callback cb, void *arg);
+
+/**
+ * @brief 异步填充
+ * @param dst 目的地址
+ * @param value 填充的字节
+ * @param len 字节数
+ * @param cb 完成回调，可为NULL
+ * @param arg 回调参数
+ * @retval 票据，队列已满返回0
+ */
+COPY_Ticket COPY_Memset(void *dst, uint8_t value, uint32_t len, COPY_Callback cb, void *arg);
+
+/**
+ * @brief 查询请求是否完成
+ * @param t 票据
+ * @retval 1 已完成（包括该票据之前提交的全部请求）
+ */
+uint8_t COPY_IsDone(COPY_Ticket t);
+
+/**
+ * @brief 等待请求完成
+ * @note 等待期间WFI睡眠；依赖DMA中断推进，不能在优先级不低于DMA中断的
+ *       中断中或关中断时调用
+ */
+void COPY_Wait(COPY_Ticket t);
+
+/**
+ * @brief 获取拷贝统计
+ */
+const COPY_Stats_t *COPY_GetStats(void);
+
+#endif
@@ -0,0 +1,510 @@
+/**
+ * @file myDma.c
+ * @brief DMA数据流分配实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myDma.h"
+#include "../myMem/myMem.h"
+#include "../myVec/myVec.h"
+#include "../myStack/myStack.h"
+
+/**
+ * @brief 映射表项：请求可由哪个数据流的哪个通道服务
+ */
+typedef struct
+{
+  uint8_t req;    ///< DMAM_Request
+  uint8_t handle; ///< 数据流句柄
+  uint8_t ch;     ///< 通道0~7
+} DMAM_Map_t;
+
+#define DMAM_MAP(req, dma, stream, ch) {DMAM_REQ_##req, DMAM_HANDLE(dma, stream), ch}
+
+/**
+ * @brief STM32F40x请求映射（RM0090 表42/43），同一请求的表项按优先顺序排列
+ */
+static const DMAM_Map_t dmam_map[] = {
+    DMAM_MAP(SPI3_RX, 1, 0, 0), DMAM_MAP(SPI3_RX, 1, 2, 0),
+    DMAM_MAP(SPI3_TX, 1, 5, 0), DMAM_MAP(SPI3_TX, 1, 7, 0),
+    DMAM_MAP(SPI2_RX, 1, 3, 0),
+    DMAM_MAP(SPI2_TX, 1, 4, 0),
+    DMAM_MAP(I2C1_RX, 1, 0, 1), DMAM_MAP(I2C1_RX, 1, 5, 1),
+    DMAM_MAP(I2C1_TX, 1, 6, 1), DMAM_MAP(I2C1_TX, 1, 7, 1),
+    DMAM_MAP(I2C2_RX, 1, 2, 7), DMAM_MAP(I2C2_RX, 1, 3, 7),
+    DMAM_MAP(I2C2_TX, 1, 7, 7),
+    DMAM_MAP(I2C3_RX, 1, 2, 3),
+    DMAM_MAP(I2C3_TX, 1, 4, 3),
+    DMAM_MAP(USART2_RX, 1, 5, 4),
+    DMAM_MAP(USART2_TX, 1, 6, 4),
+    DMAM_MAP(USART3_RX, 1, 1, 4),
+    DMAM_MAP(USART3_TX, 1, 3, 4), DMAM_MAP(USART3_TX, 1, 4, 7),
+    DMAM_MAP(UART4_RX, 1, 2, 4),
+    DMAM_MAP(UART4_TX, 1, 4, 4),
+    DMAM_MAP(UART5_RX, 1, 0, 4),
+    DMAM_MAP(UART5_TX, 1, 7, 4),
+    DMAM_MAP(TIM2_UP, 1, 1, 3), DMAM_MAP(TIM2_UP, 1, 7, 3),
+    DMAM_MAP(TIM2_CH1, 1, 5, 3),
+    DMAM_MAP(TIM2_CH2, 1, 6, 3),
+    DMAM_MAP(TIM2_CH3, 1, 1, 3),
+    DMAM_MAP(TIM2_CH4, 1, 6, 3), DMAM_MAP(TIM2_CH4, 1, 7, 3),
+    DMAM_MAP(TIM3_UP, 1, 2, 5),
+    DMAM_MAP(TIM3_CH1, 1, 4, 5),
+    DMAM_MAP(TIM3_CH2, 1, 5, 5),
+    DMAM_MAP(TIM3_CH3, 1, 7, 5),
+    DMAM_MAP(TIM3_CH4, 1, 2, 5),
+    DMAM_MAP(TIM4_UP, 1, 6, 2),
+    DMAM_MAP(TIM4_CH1, 1, 0, 2),
+    DMAM_MAP(TIM4_CH2, 1, 3, 2),
+    DMAM_MAP(TIM4_CH3, 1, 7, 2),
+    DMAM_MAP(TIM5_UP, 1, 0, 6), DMAM_MAP(TIM5_UP, 1, 6, 6),
+    DMAM_MAP(TIM5_CH1, 1, 2, 6),
+    DMAM_MAP(TIM5_CH2, 1, 4, 6),
+    DMAM_MAP(TIM5_CH3, 1, 0, 6),
+    DMAM_MAP(TIM5_CH4, 1, 1, 6), DMAM_MAP(TIM5_CH4, 1, 3, 6),
+    DMAM_MAP(TIM6_UP, 1, 1, 7),
+    DMAM_MAP(TIM7_UP, 1, 2, 1), DMAM_MAP(TIM7_UP, 1, 4, 1),
+    DMAM_MAP(DAC1, 1, 5, 7),
+    DMAM_MAP(DAC2, 1, 6, 7),
+
+    DMAM_MAP(ADC1, 2, 0, 0), DMAM_MAP(ADC1, 2, 4, 0),
+    DMAM_MAP(ADC2, 2, 2, 1), DMAM_MAP(ADC2, 2, 3, 1),
+    DMAM_MAP(ADC3, 2, 0, 2), DMAM_MAP(ADC3, 2, 1, 2),
+    DMAM_MAP(DCMI, 2, 1, 1), DMAM_MAP(DCMI, 2, 7, 1),
+    DMAM_MAP(SPI1_RX, 2, 0, 3), DMAM_MAP(SPI1_RX, 2, 2, 3),
+    DMAM_MAP(SPI1_TX, 2, 3, 3), DMAM_MAP(SPI1_TX, 2, 5, 3),
+    DMAM_MAP(USART1_RX, 2, 2, 4), DMAM_MAP(USART1_RX, 2, 5, 4),
+    DMAM_MAP(USART1_TX, 2, 7, 4),
+    DMAM_MAP(USART6_RX, 2, 1, 5), DMAM_MAP(USART6_RX, 2, 2, 5),
+    DMAM_MAP(USART6_TX, 2, 6, 5), DMAM_MAP(USART6_TX, 2, 7, 5),
+    DMAM_MAP(SDIO, 2, 3, 4), DMAM_MAP(SDIO, 2, 6, 4),
+    DMAM_MAP(TIM1_UP, 2, 5, 6),
+    DMAM_MAP(TIM1_CH1, 2, 1, 6), DMAM_MAP(TIM1_CH1, 2, 3, 6), DMAM_MAP(TIM1_CH1, 2, 6, 0),
+    DMAM_MAP(TIM1_CH2, 2, 2, 6), DMAM_MAP(TIM1_CH2, 2, 6, 0),
+    DMAM_MAP(TIM1_CH3, 2, 6, 6), DMAM_MAP(TIM1_CH3, 2, 6, 0),
+    DMAM_MAP(TIM1_CH4, 2, 4, 6),
+    DMAM_MAP(TIM1_TRIG, 2, 0, 6), DMAM_MAP(TIM1_TRIG, 2, 4, 6),
+    DMAM_MAP(TIM8_UP, 2, 1, 7),
+    DMAM_MAP(TIM8_CH1, 2, 2, 7), DMAM_MAP(TIM8_CH1, 2, 2, 0),
+    DMAM_MAP(TIM8_CH2, 2, 3, 7), DMAM_MAP(TIM8_CH2, 2, 2, 0),
+    DMAM_MAP(TIM8_CH3, 2, 4, 7), DMAM_MAP(TIM8_CH3, 2, 2, 0),
+    DMAM_MAP(TIM8_CH4, 2, 7, 7),
+    DMAM_MAP(CRYP_OUT, 2, 5, 2),
+    DMAM_MAP(CRYP_IN, 2, 6, 2),
+    DMAM_MAP(HASH_IN, 2, 7, 2),
+
+    // 存储器到存储器不占用外设请求，先用外设请求都另有备选的数据流
+    DMAM_MAP(MEM2MEM, 2, 0, 0), DMAM_MAP(MEM2MEM, 2, 3, 0), DMAM_MAP(MEM2MEM, 2, 6, 0),
+    DMAM_MAP(MEM2MEM, 2, 2, 0), DMAM_MAP(MEM2MEM, 2, 4, 0), DMAM_MAP(MEM2MEM, 2, 1, 0),
+    DMAM_MAP(MEM2MEM, 2, 7, 0), DMAM_MAP(MEM2MEM, 2, 5, 0),
+};
+
+#define DMAM_MAP_NUM (sizeof(dmam_map) / sizeof(dmam_map[0]))
+
+static DMA_Stream_TypeDef *const dmam_streams[DMAM_STREAM_NUM] = {
+    DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3, DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7,
+    DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3, DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7,
+};
+
+static const uint8_t dmam_irqn[DMAM_STREAM_NUM] = {
+    DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+};
+
+/**
+ * @brief 各数据流事件标志在 LISR/HISR 中的起始位
+ */
+static const uint8_t dmam_flag_shift[4] = {0, 6, 16, 22};
+
+/**
+ * @brief 数据流的占用状态
+ */
+typedef struct
+{
+  const char *owner; ///< 使用者，NULL表示空闲
+  DMAM_Callback cb;  ///< 事件回调
+  void *arg;         ///< 回调参数
+  uint32_t channel;  ///< 选定的通道（DMA_Channel_x）
+} DMAM_Slot_t;
+
+static DMAM_Slot_t dmam_slots[DMAM_STREAM_NUM] MEM_CCM;
+static uint32_t dmam_conflicts;
+
+#if STACK_STATS
+static STACK_Ctx_t dmam_stack = {"DMA"};
+#endif
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK）
+ */
+#define DMAM_ENTER_CRITICAL()              \
+  uint32_t dmam_primask = __get_PRIMASK(); \
+  __disable_irq()
+#define DMAM_EXIT_CRITICAL() __set_PRIMASK(dmam_primask)
+
+/**
+ * @brief 占用数据流（调用者处于临界区）
+ * @retval 1 成功；0 已被占用，或未经分配却已在运行（有驱动绕过了分配）
+ */
+static uint8_t DMAM_Take(const DMAM_Map_t *m, const char *owner)
+{
+  DMAM_Slot_t *s = &dmam_slots[m->handle];
+
+  if (s->owner != 0 || (dmam_streams[m->handle]->CR & DMA_SxCR_EN))
+  {
+    return 0;
+  }
+  s->owner = owner;
+  s->cb = 0;
+  s->arg = 0;
+  s->channel = (uint32_t)m->ch << 25;
+  RCC_AHB1PeriphClockCmd(m->handle < 8 ? RCC_AHB1Periph_DMA1 : RCC_AHB1Periph_DMA2, ENABLE);
+  return 1;
+}
+
+uint8_t DMAM_Alloc(DMAM_Request req, const char *owner)
+{
+  uint8_t i;
+  DMAM_ENTER_CRITICAL();
+
+  for (i = 0; i < DMAM_MAP_NUM; i++)
+  {
+    if (dmam_map[i].req == req && DMAM_Take(&dmam_map[i], owner))
+    {
+      DMAM_EXIT_CRITICAL();
+      return dmam_map[i].handle;
+    }
+  }
+  dmam_conflicts++;
+
+  DMAM_EXIT_CRITICAL();
+  return DMAM_INVALID;
+}
+
+uint8_t DMAM_Claim(DMAM_Request req, uint8_t handle, const char *owner)
+{
+  uint8_t i;
+  DMAM_ENTER_CRITICAL();
+
+  for (i = 0; i < DMAM_MAP_NUM; i++)
+  {
+    if (dmam_map[i].req == req && dmam_map[i].handle == handle)
+    {
+      if (DMAM_Take(&dmam_map[i], owner))
+      {
+        DMAM_EXIT_CRITICAL();
+        return handle;
+      }
+      break;
+    }
+  }
+  dmam_conflicts++;
+
+  DMAM_EXIT_CRITICAL();
+  return DMAM_INVALID;
+}
+
+void DMAM_Free(uint8_t handle)
+{
+  DMA_Stream_TypeDef *stream;
+
+  if (handle >= DMAM_STREAM_NUM || dmam_slots[handle].owner == 0)
+  {
+    return;
+  }
+  stream = dmam_streams[handle];
+  NVIC_DisableIRQ((IRQn_Type)dmam_irqn[handle]);
+  DMA_Cmd(stream, DISABLE);
+  while (DMA_GetCmdStatus(stream) != DISABLE)
+    ;
+  stream->CR &= ~(DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE);
+  stream->FCR &= ~DMA_SxFCR_FEIE;
+  DMAM_ClearFlags(handle, DMAM_EVT_ALL);
+
+  {
+    DMAM_ENTER_CRITICAL();
+    dmam_slots[handle].cb = 0;
+    dmam_slots[handle].owner = 0;
+    DMAM_EXIT_CRITICAL();
+  }
+}
+
+DMA_Stream_TypeDef *DMAM_GetStream(uint8_t handle)
+{
+  return handle < DMAM_STREAM_NUM ? dmam_streams[handle] : 0;
+}
+
+uint32_t DMAM_GetChannel(uint8_t handle)
+{
+  return handle < DMAM_STREAM_NUM ? dmam_slots[handle].channel : 0;
+}
+
+IRQn_Type DMAM_GetIRQn(uint8_t handle)
+{
+  return (IRQn_Type)(handle < DMAM_STREAM_NUM ? dmam_irqn[handle] : 0);
+}
+
+const char *DMAM_GetOwner(uint8_t handle)
+{
+  return handle < DMAM_STREAM_NUM ? dmam_slots[handle].owner : 0;
+}
+
+void DMAM_ClearFlags(uint8_t handle, uint32_t evts)
+{
+  DMA_TypeDef *dma = handle < 8 ? DMA1 : DMA2;
+  uint8_t s = handle & 7;
+
+  evts = (evts & DMAM_EVT_ALL) << dmam_flag_shift[s & 3];
+  if (s < 4)
+  {
+    dma->LIFCR = evts;
+  }
+  else
+  {
+    dma->HIFCR = evts;
+  }
+}
+
+/**
+ * @brief 由中断号找回数据流句柄
+ */
+static uint8_t DMAM_IrqToHandle(int32_t irqn)
+{
+  if (irqn <= DMA1_Stream6_IRQn)
+  {
+    return (uint8_t)(irqn - DMA1_Stream0_IRQn);
+  }
+  if (irqn == DMA1_Stream7_IRQn)
+  {
+    return 7;
+  }
+  if (irqn <= DMA2_Stream4_IRQn)
+  {
+    return (uint8_t)(8 + irqn - DMA2_Stream0_IRQn);
+  }
+  return (uint8_t)(13 + irqn - DMA2_Stream5_IRQn);
+}
+
+/**
+ * @brief 读取并清除当前数据流已使能的事件，调用回调
+ */
+MEM_RAMFUNC static void DMAM_Dispatch(void)
+{
+  uint8_t handle = DMAM_IrqToHandle((int32_t)__get_IPSR() - 16);
+  DMA_Stream_TypeDef *stream = dmam_streams[handle];
+  DMA_TypeDef *dma = handle < 8 ? DMA1 : DMA2;
+  uint8_t s = handle & 7;
+  uint8_t shift = dmam_flag_shift[s & 3];
+  uint32_t enabled;
+  uint32_t evts;
+
+  // 中断使能位 TCIE/HTIE/TEIE/DMEIE 左移一位正好对应各自的标志位
+  enabled = (stream->CR & (DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE)) << 1;
+  if (stream->FCR & DMA_SxFCR_FEIE)
+  {
+    enabled |= DMAM_EVT_FE;
+  }
+  evts = ((s < 4 ? dma->LISR : dma->HISR) >> shift) & enabled;
+  if (s < 4)
+  {
+    dma->LIFCR = evts << shift;
+  }
+  else
+  {
+    dma->HIFCR = evts << shift;
+  }
+
+  // 没有事件时是软件挂起的中断（NVIC_SetPendingIRQ），同样交给回调
+  if (dmam_slots[handle].cb)
+  {
+    dmam_slots[handle].cb(dmam_slots[handle].arg, evts);
+  }
+}
+
+/**
+ * @brief 全部数据流共用的中断处理函数
+ */
+MEM_RAMFUNC static void DMAM_IRQHandler(void)
+{
+  STACK_ISR_BEGIN();
+
+  DMAM_Dispatch();
+
+  STACK_ISR_END(dmam_stack);
+}
+
+ErrorStatus DMAM_SetCallback(uint8_t handle, DMAM_Callback cb, void *arg, uint8_t prio)
+{
+  IRQn_Type irqn;
+
+  if (handle >= DMAM_STREAM_NUM || dmam_slots[handle].owner == 0)
+  {
+    return ERROR;
+  }
+  irqn = (IRQn_Type)dmam_irqn[handle];
+  NVIC_DisableIRQ(irqn);
+  if (cb == 0)
+  {
+    dmam_slots[handle].cb = 0;
+    return SUCCESS;
+  }
+
+  VEC_SetHandler(irqn, DMAM_IRQHandler);
+  if (VEC_GetHandler(irqn) != DMAM_IRQHandler)
+  {
+    return ERROR;
+  }
+  dmam_slots[handle].arg = arg;
+  dmam_slots[handle].cb = cb;
+  NVIC_SetPriority(irqn, prio);
+  NVIC_EnableIRQ(irqn);
+  return SUCCESS;
+}
+
+uint32_t DMAM_GetConflictCount(void)
+{
+  return dmam_conflicts;
+}
+
+/**
+ * @brief 突发拍数 -> MBURST/PBURST字段值
+ */
+static uint32_t DMAM_BurstCode(uint32_t beats)
+{
+  return beats >= 16 ? 3 : (beats >= 8 ? 2 : (beats >= 4 ? 1 : 0));
+}
+
+/**
+ * @brief 按CR/FCR格式的配置检查突发/FIFO组合、对齐与长度
+ */
+static ErrorStatus DMAM_CheckLayout(uint32_t cr, uint32_t fcr, uint32_t par, uint32_t m0ar, uint32_t items)
+{
+  static const uint8_t beats[4] = {1, 4, 8, 16};
+  uint32_t psize = 1UL << ((cr & DMA_SxCR_PSIZE) >> 11);
+  uint32_t msize = 1UL << ((cr & DMA_SxCR_MSIZE) >> 13);
+  uint32_t pburst = beats[(cr & DMA_SxCR_PBURST) >> 21] * psize;
+  uint32_t mburst = beats[(cr & DMA_SxCR_MBURST) >> 23] * msize;
+  uint32_t thr = ((fcr & DMA_SxFCR_FTH) + 1) * 4;
+  uint32_t bytes = items * psize;
+  uint8_t m2m = (cr & DMA_SxCR_DIR) == DMA_DIR_MemoryToMemory;
+
+  if (psize > 4 || msize > 4)
+  {
+    return ERROR; // 数据宽度取值11保留
+  }
+  if (fcr & DMA_SxFCR_DMDIS)
+  {
+    // FIFO模式：门限须为存储器突发字节数的整数倍（表48）
+    if ((mburst > msize && thr % mburst) || pburst > 16)
+    {
+      return ERROR;
+    }
+  }
+  else if (m2m || msize != psize || mburst != msize || pburst != psize)
+  {
+    return ERROR; // 直接模式不能打包，也不能突发
+  }
+  if (m2m && (cr & DMA_SxCR_CIRC))
+  {
+    return ERROR;
+  }
+  if (MEM_IS_CCM(m0ar) || (m2m && MEM_IS_CCM(par)))
+  {
+    return ERROR; // DMA不能访问CCM
+  }
+  if (m0ar % msize || par % psize || bytes % msize)
+  {
+    return ERROR;
+  }
+  // 按突发字节数对齐即保证突发不跨1KB边界
+  if (mburst > msize && (m0ar % mburst || bytes % mburst))
+  {
+    return ERROR;
+  }
+  if (pburst > psize && (((cr & DMA_SxCR_PINC) && par % pburst) || bytes % pburst))
+  {
+    return ERROR;
+  }
+  return SUCCESS;
+}
+
+ErrorStatus DMAM_Validate(const DMA_InitTypeDef *init)
+{
+  uint32_t cr = init->DMA_DIR | init->DMA_PeripheralInc | init->DMA_MemoryInc | init->DMA_PeripheralDataSize |
+                init->DMA_MemoryDataSize | init->DMA_Mode | init->DMA_PeripheralBurst | init->DMA_MemoryBurst;
+
+  return DMAM_CheckLayout(cr, init->DMA_FIFOMode | init->DMA_FIFOThreshold, init->DMA_PeripheralBaseAddr,
+                          init->DMA_Memory0BaseAddr, init->DMA_BufferSize);
+}
+
+ErrorStatus DMAM_CheckBuffer(uint8_t handle, const void *addr, uint32_t items)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(handle);
+
+  if (stream == 0)
+  {
+    return ERROR;
+  }
+  return DMAM_CheckLayout(stream->CR, stream->FCR, stream->PAR, (uint32_t)addr, items);
+}
+
+ErrorStatus DMAM_Tune(DMA_InitTypeDef *init, DMAM_TuneReport_t *report)
+{
+  uint32_t psize = 1UL << (init->DMA_PeripheralDataSize >> 11);
+  uint32_t bytes = init->DMA_BufferSize * psize;
+  uint32_t m = init->DMA_Memory0BaseAddr;
+  uint32_t p = init->DMA_PeripheralBaseAddr;
+  uint8_t m2m = init->DMA_DIR == DMA_DIR_MemoryToMemory;
+  uint32_t msize = psize;
+  uint32_t mburst = psize;
+  uint32_t pburst = psize;
+
+  if (init->DMA_MemoryInc == DMA_MemoryInc_Enable)
+  {
+    // 地址与长度允许的最大数据宽度，再取不超过FIFO的最大突发（至少4拍）
+    for (msize = 4; msize > 1 && ((m | bytes) & (msize - 1)); msize >>= 1)
+      ;
+    for (mburst = 16; mburst > msize && ((m | bytes) & (mburst - 1)); mburst >>= 1)
+      ;
+    if (mburst / msize < 4)
+    {
+      mburst = msize;
+    }
+  }
+  if (m2m && init->DMA_PeripheralInc == DMA_PeripheralInc_Enable)
+  {
+    for (pburst = 16; pburst > psize && ((p | bytes) & (pburst - 1)); pburst >>= 1)
+      ;
+    if (pburst / psize < 4)
+    {
+      pburst = psize;
+    }
+  }
+
+  init->DMA_MemoryDataSize = (msize == 4 ? 2 : msize >> 1) << 13;
+  init->DMA_MemoryBurst = DMAM_BurstCode(mburst / msize) << 23;
+  init->DMA_PeripheralBurst = DMAM_BurstCode(pburst / psize) << 21;
+  if (m2m || msize != psize || mburst != msize || pburst != psize)
+  {
+    init->DMA_FIFOMode = DMA_FIFOMode_Enable;
+    init->DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+  }
+  else
+  {
+    init->DMA_FIFOMode = DMA_FIFOMode_Disable;
+  }
+
+  if (report)
+  {
+    report->base_beats = init->DMA_BufferSize;
+    report->beats = bytes / msize;
+    report->bursts = report->beats / (mburst / msize);
+    // 外设宽度大于存储器允许的宽度时拍数反而增加，默认配置在这种地址上本就非法
+    report->beats_saved = report->base_beats > report->beats ? report->base_beats - report->beats : 0;
+  }
+  return DMAM_Validate(init);
+}
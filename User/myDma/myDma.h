@@ -0,0 +1,248 @@
+/**
+ * @file myDma.h
+ * @brief DMA数据流分配：请求映射表、冲突检测与统一中断分发
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * STM32F40x的每个外设DMA请求只能由固定的(DMA, 数据流, 通道)组合服务，
+ * 部分请求有两到三个可选数据流（RM0090 表42/43）。驱动不再写死数据流，
+ * 而是按请求调用 DMAM_Alloc()：按映射表顺序取第一个空闲的数据流，首选被
+ * 占用时自动改用备选；全部被占用时返回 DMAM_INVALID 并计入冲突，
+ * 从而在初始化阶段就发现两个驱动争用同一数据流，而不是运行时互相改写配置。
+ *
+ * 数据流句柄为0~15：DMA1 Stream0~7为0~7，DMA2 Stream0~7为8~15。
+ * DMAM_SetCallback() 把同一个处理函数注册到该数据流的中断向量（VEC_SetHandler），
+ * 中断中按IPSR找回数据流，读取并清除事件标志后调用登记的回调，
+ * 驱动不需要在 stm32f4xx_it.c 中为每个数据流各写一个处理函数。
+ *
+ * DMA_StructInit() 默认为直接模式、单次传输，存储器端每个数据项一次AHB访问。
+ * DMAM_Tune() 按存储器地址、长度与外设数据宽度选择存储器数据宽度、突发长度
+ * 与FIFO门限；DMAM_Validate() 按RM0090 9.3.11/表48检查突发与FIFO的组合，
+ * 非法组合在初始化时返回ERROR，而不是运行时出现FIFO错误或数据错位。
+ */
+
+#ifndef _MYDMA_H_
+#define _MYDMA_H_
+
+#include "stm32f4xx.h"
+
+#define DMAM_STREAM_NUM 16 ///< 数据流总数
+#define DMAM_INVALID 0xFF  ///< 无效句柄
+
+/**
+ * @brief 由DMA编号(1/2)与数据流编号(0~7)得到句柄
+ */
+#define DMAM_HANDLE(dma, stream) ((uint8_t)(((dma) - 1) * 8 + (stream)))
+
+/**
+ * @defgroup DMAM_Events 回调事件（与中断标志位对应）
+ * @{
+ */
+#define DMAM_EVT_FE 0x01  ///< FIFO错误
+#define DMAM_EVT_DME 0x04 ///< 直接模式错误
+#define DMAM_EVT_TE 0x08  ///< 传输错误
+#define DMAM_EVT_HT 0x10  ///< 半传输
+#define DMAM_EVT_TC 0x20  ///< 传输完成
+#define DMAM_EVT_ALL 0x3D
+/** @} */
+
+/**
+ * @brief DMA请求（STM32F40x）
+ */
+typedef enum
+{
+  // DMA1
+  DMAM_REQ_SPI3_RX = 0,
+  DMAM_REQ_SPI3_TX,
+  DMAM_REQ_SPI2_RX,
+  DMAM_REQ_SPI2_TX,
+  DMAM_REQ_I2C1_RX,
+  DMAM_REQ_I2C1_TX,
+  DMAM_REQ_I2C2_RX,
+  DMAM_REQ_I2C2_TX,
+  DMAM_REQ_I2C3_RX,
+  DMAM_REQ_I2C3_TX,
+  DMAM_REQ_USART2_RX,
+  DMAM_REQ_USART2_TX,
+  DMAM_REQ_USART3_RX,
+  DMAM_REQ_USART3_TX,
+  DMAM_REQ_UART4_RX,
+  DMAM_REQ_UART4_TX,
+  DMAM_REQ_UART5_RX,
+  DMAM_REQ_UART5_TX,
+  DMAM_REQ_TIM2_UP,
+  DMAM_REQ_TIM2_CH1,
+  DMAM_REQ_TIM2_CH2,
+  DMAM_REQ_TIM2_CH3,
+  DMAM_REQ_TIM2_CH4,
+  DMAM_REQ_TIM3_UP,
+  DMAM_REQ_TIM3_CH1,
+  DMAM_REQ_TIM3_CH2,
+  DMAM_REQ_TIM3_CH3,
+  DMAM_REQ_TIM3_CH4,
+  DMAM_REQ_TIM4_UP,
+  DMAM_REQ_TIM4_CH1,
+  DMAM_REQ_TIM4_CH2,
+  DMAM_REQ_TIM4_CH3,
+  DMAM_REQ_TIM5_UP,
+  DMAM_REQ_TIM5_CH1,
+  DMAM_REQ_TIM5_CH2,
+  DMAM_REQ_TIM5_CH3,
+  DMAM_REQ_TIM5_CH4,
+  DMAM_REQ_TIM6_UP,
+  DMAM_REQ_TIM7_UP,
+  DMAM_REQ_DAC1,
+  DMAM_REQ_DAC2,
+  // DMA2
+  DMAM_REQ_ADC1,
+  DMAM_REQ_ADC2,
+  DMAM_REQ_ADC3,
+  DMAM_REQ_DCMI,
+  DMAM_REQ_SPI1_RX,
+  DMAM_REQ_SPI1_TX,
+  DMAM_REQ_USART1_RX,
+  DMAM_REQ_USART1_TX,
+  DMAM_REQ_USART6_RX,
+  DMAM_REQ_USART6_TX,
+  DMAM_REQ_SDIO,
+  DMAM_REQ_TIM1_UP,
+  DMAM_REQ_TIM1_CH1,
+  DMAM_REQ_TIM1_CH2,
+  DMAM_REQ_TIM1_CH3,
+  DMAM_REQ_TIM1_CH4,
+  DMAM_REQ_TIM1_TRIG,
+  DMAM_REQ_TIM8_UP,
+  DMAM_REQ_TIM8_CH1,
+  DMAM_REQ_TIM8_CH2,
+  DMAM_REQ_TIM8_CH3,
+  DMAM_REQ_TIM8_CH4,
+  DMAM_REQ_CRYP_IN,
+  DMAM_REQ_CRYP_OUT,
+  DMAM_REQ_HASH_IN,
+  DMAM_REQ_MEM2MEM, ///< 存储器到存储器，只能使用DMA2，任一数据流
+  DMAM_REQ_NUM
+} DMAM_Request;
+
+/**
+ * @brief DMAM_Tune() 的评估结果（存储器端）
+ */
+typedef struct
+{
+  uint32_t base_beats;  ///< 默认配置（直接模式、单次传输）下的AHB访问数
+  uint32_t beats;       ///< 调整后的AHB拍数
+  uint32_t bursts;      ///< 调整后的总线事务数，每次突发仲裁一次
+  uint32_t beats_saved; ///< 节省的AHB拍数
+} DMAM_TuneReport_t;
+
+/**
+ * @brief 事件回调，在DMA中断中调用
+ * @param arg DMAM_SetCallback() 登记的参数
+ * @param evts 本次发生的事件，DMAM_EVT_* 的组合（只含已使能中断的事件）；
+ *             0表示中断由软件挂起（NVIC_SetPendingIRQ(DMAM_GetIRQn())）
+ */
+typedef void (*DMAM_Callback)(void *arg, uint32_t evts);
+
+/**
+ * @brief 为请求分配数据流
+ * @param req DMA请求
+ * @param owner 使用者名称，用于冲突诊断
+ * @retval 句柄；请求的全部可选数据流都被占用时返回 DMAM_INVALID
+ * @note 同时使能对应DMA的时钟
+ */
+uint8_t DMAM_Alloc(DMAM_Request req, const char *owner);
+
+/**
+ * @brief 为请求占用指定的数据流
+ * @param req DMA请求
+ * @param handle 数据流句柄，见 DMAM_HANDLE()
+ * @param owner 使用者名称
+ * @retval 句柄；该数据流不能服务此请求或已被占用时返回 DMAM_INVALID
+ */
+uint8_t DMAM_Claim(DMAM_Request req, uint8_t handle, const char *owner);
+
+/**
+ * @brief 释放数据流：关闭数据流与中断，注销回调
+ */
+void DMAM_Free(uint8_t handle);
+
+/**
+ * @brief 获取数据流寄存器
+ */
+DMA_Stream_TypeDef *DMAM_GetStream(uint8_t handle);
+
+/**
+ * @brief 获取分配时选定的通道，即 DMA_InitTypeDef::DMA_Channel 的取值
+ */
+uint32_t DMAM_GetChannel(uint8_t handle);
+
+/**
+ * @brief 获取数据流的中断号
+ */
+IRQn_Type DMAM_GetIRQn(uint8_t handle);
+
+/**
+ * @brief 获取数据流的使用者，空闲时返回NULL
+ */
+const char *DMAM_GetOwner(uint8_t handle);
+
+/**
+ * @brief 登记事件回调并使能数据流中断
+ * @param handle 数据流句柄
+ * @param cb 回调，NULL表示关闭中断
+ * @param arg 回调参数
+ * @param prio NVIC抢占优先级
+ * @retval SUCCESS；未调用 VEC_Init() 时返回ERROR
+ * @note 数据流自身的中断使能位（DMA_ITConfig）仍由驱动设置
+ */
+ErrorStatus DMAM_SetCallback(uint8_t handle, DMAM_Callback cb, void *arg, uint8_t prio);
+
+/**
+ * @brief 清除数据流的事件标志
+ * @param evts DMAM_EVT_* 的组合
+ */
+void DMAM_ClearFlags(uint8_t handle, uint32_t evts);
+
+/**
+ * @brief 获取分配失败（数据流冲突）的次数
+ */
+uint32_t DMAM_GetConflictCount(void);
+
+/**
+ * @brief 检查配置是否符合突发/FIFO规则
+ * @param init DMA配置，按其中的地址与 DMA_BufferSize 检查对齐与长度
+ * @retval SUCCESS；以下情况返回ERROR：
+ *         - 直接模式下使用突发、存储器与外设数据宽度不同，或为存储器到存储器；
+ *         - 存储器突发字节数不能整除FIFO门限（表48中的禁止组合）；
+ *         - 外设突发超过16字节FIFO；
+ *         - 地址未按数据宽度对齐，或未按突发字节数对齐（突发不能跨1KB边界）；
+ *         - 总字节数不是数据宽度或突发字节数的整数倍；
+ *         - 存储器地址位于CCM；存储器到存储器使用循环模式
+ */
+ErrorStatus DMAM_Validate(const DMA_InitTypeDef *init);
+
+/**
+ * @brief 按数据流当前配置检查一段存储器区域
+ * @param handle 数据流句柄
+ * @param addr 存储器地址
+ * @param items 数据项数（外设数据宽度为单位）
+ * @retval SUCCESS；对齐、长度不符或位于CCM时返回ERROR
+ * @note 用于逐段改写M0AR/NDTR的驱动（如分散/聚集链）
+ */
+ErrorStatus DMAM_CheckBuffer(uint8_t handle, const void *addr, uint32_t items);
+
+/**
+ * @brief 按存储器地址、长度与外设数据宽度选择存储器端配置
+ * @param init DMA配置：读取方向、外设地址/递增/数据宽度、存储器地址/递增、
+ *             DMA_BufferSize；改写存储器数据宽度、存储器/外设突发、FIFO模式与门限
+ * @param report 评估结果，可为NULL
+ * @retval DMAM_Validate() 的结果
+ * @note 存储器递增时取地址与长度允许的最大数据宽度（最大字），再取不超过16字节
+ *       FIFO的最大突发；需要打包或突发时使用FIFO、门限为满，否则保持直接模式。
+ *       外设端只在存储器到存储器（源为存储器）时突发。外设到存储器使用FIFO时，
+ *       数据凑满一次突发才写入存储器，按字节读取进度（如UART接收环形缓冲）的
+ *       使用者需考虑这一延迟
+ */
+ErrorStatus DMAM_Tune(DMA_InitTypeDef *init, DMAM_TuneReport_t *report);
+
+#endif
@@ -0,0 +1,305 @@
+/**
+ * @file myIdle.c
+ * @brief 低功耗空闲管理实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myIdle.h"
+#include "../myTime/myTime.h"
+#include "../myClock/myClock.h"
+#include "../myMem/myMem.h"
+
+#define IDLE_RTC_PREDIV_A 31   ///< 32768/32 = 1024Hz亚秒计数
+#define IDLE_RTC_PREDIV_S 1023 ///< 1024/1024 = 1Hz日历
+#define IDLE_RTC_UNITS_DAY (86400UL * (IDLE_RTC_PREDIV_S + 1))
+#define IDLE_WUT_HZ (32768 / 16) ///< 唤醒定时器时钟 RTCCLK/16
+
+/**
+ * @brief 登记的模块
+ */
+typedef struct
+{
+  const char *name; ///< 模块名称
+  uint32_t us;      ///< 唤醒延迟容限
+} IDLE_Client_t;
+
+static IDLE_Client_t idle_clients[IDLE_CLIENT_MAX];
+static uint8_t idle_client_num;
+static volatile uint32_t idle_latency = IDLE_LATENCY_ANY; ///< 全部容限的最小值
+static uint8_t idle_rtc_ready;                             ///< RTC已由LSE驱动
+static uint32_t idle_frac;                                 ///< 亚秒计数换算毫秒的余数
+static volatile uint8_t idle_soe;                          ///< 退出时睡眠中
+static uint64_t idle_soe_until;                            ///< 退出时睡眠的截止节拍
+static IDLE_Stats_t idle_stats;
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK，可嵌套在中断中使用）
+ */
+#define IDLE_ENTER_CRITICAL()                \
+  uint32_t idle_primask = __get_PRIMASK();   \
+  __disable_irq()
+#define IDLE_EXIT_CRITICAL() __set_PRIMASK(idle_primask)
+
+void IDLE_Init(void)
+{
+  RTC_InitTypeDef RTC_InitStructure;
+  EXTI_InitTypeDef EXTI_InitStructure;
+  uint64_t deadline;
+
+  RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+  PWR_BackupAccessCmd(ENABLE);
+
+  // RTCSEL只能经备份域复位修改；备份域在系统复位后保持，LSE可能已在运行
+  if ((RCC->BDCR & RCC_BDCR_RTCSEL) != 0 && (RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_RTCCLKSource_LSE)
+  {
+    RCC_BackupResetCmd(ENABLE);
+    RCC_BackupResetCmd(DISABLE);
+  }
+  if (RCC_GetFlagStatus(RCC_FLAG_LSERDY) == RESET)
+  {
+    RCC_LSEConfig(RCC_LSE_ON);
+    deadline = TIME_Deadline(IDLE_LSE_START_MS);
+    while (RCC_GetFlagStatus(RCC_FLAG_LSERDY) == RESET)
+    {
+      if (TIME_Expired(deadline))
+      {
+        RCC_LSEConfig(RCC_LSE_OFF);
+        return;
+      }
+    }
+  }
+  RCC_RTCCLKConfig(RCC_RTCCLKSource_LSE);
+  RCC_RTCCLKCmd(ENABLE);
+
+  // 只用亚秒与秒计数测量时间差，不设置日历
+  RTC_InitStructure.RTC_HourFormat = RTC_HourFormat_24;
+  RTC_InitStructure.RTC_AsynchPrediv = IDLE_RTC_PREDIV_A;
+  RTC_InitStructure.RTC_SynchPrediv = IDLE_RTC_PREDIV_S;
+  if (RTC_Init(&RTC_InitStructure) != SUCCESS)
+  {
+    return;
+  }
+  // 直接读计数器：STOP唤醒后不必等待影子寄存器同步
+  RTC_BypassShadowCmd(ENABLE);
+
+  RTC_WakeUpCmd(DISABLE);
+  RTC_WakeUpClockConfig(RTC_WakeUpClock_RTCCLK_Div16);
+  RTC_ITConfig(RTC_IT_WUT, ENABLE);
+  RTC_ClearITPendingBit(RTC_IT_WUT);
+
+  // 唤醒事件接EXTI线22，STOP期间同样有效
+  EXTI_ClearITPendingBit(EXTI_Line22);
+  EXTI_InitStructure.EXTI_Line = EXTI_Line22;
+  EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+  EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+  EXTI_Init(&EXTI_InitStructure);
+  NVIC_SetPriority(RTC_WKUP_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+  NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+#if IDLE_STOP_FLASH_PD
+  PWR_FlashPowerDownCmd(ENABLE);
+#endif
+  idle_frac = 0;
+  idle_rtc_ready = 1;
+}
+
+uint8_t IDLE_Register(const char *name)
+{
+  uint8_t id;
+  IDLE_ENTER_CRITICAL();
+
+  if (idle_client_num == IDLE_CLIENT_MAX)
+  {
+    IDLE_EXIT_CRITICAL();
+    return 0xFF;
+  }
+  id = idle_client_num++;
+  idle_clients[id].name = name;
+  idle_clients[id].us = IDLE_LATENCY_ANY;
+
+  IDLE_EXIT_CRITICAL();
+  return id;
+}
+
+void IDLE_SetLatency(uint8_t id, uint32_t us)
+{
+  uint32_t min = IDLE_LATENCY_ANY;
+  uint8_t i;
+
+  if (id >= idle_client_num || idle_clients[id].us == us)
+  {
+    return;
+  }
+
+  {
+    IDLE_ENTER_CRITICAL();
+    idle_clients[id].us = us;
+    for (i = 0; i < idle_client_num; i++)
+    {
+      if (idle_clients[i].us < min)
+      {
+        min = idle_clients[i].us;
+      }
+    }
+    idle_latency = min;
+    IDLE_EXIT_CRITICAL();
+  }
+}
+
+uint32_t IDLE_GetLatency(void)
+{
+  return idle_latency;
+}
+
+/**
+ * @brief 读取RTC计数（秒 * 1024 + 亚秒），一天回绕
+ * @note 亚秒寄存器递减计数；前后两次读到相同亚秒值时秒寄存器有效
+ */
+static uint32_t IDLE_RtcRead(void)
+{
+  uint32_t ssr;
+  uint32_t tr;
+  uint32_t sec;
+
+  do
+  {
+    ssr = RTC->SSR;
+    tr = RTC->TR;
+  } while (ssr != RTC->SSR);
+
+  sec = (((tr >> 20) & 3) * 10 + ((tr >> 16) & 0xF)) * 3600 + (((tr >> 12) & 7) * 10 + ((tr >> 8) & 0xF)) * 60 +
+        ((tr >> 4) & 7) * 10 + (tr & 0xF);
+  return sec * (IDLE_RTC_PREDIV_S + 1) + (IDLE_RTC_PREDIV_S - ssr);
+}
+
+/**
+ * @brief STOP睡眠：SysTick暂停，RTC唤醒定时器在截止时刻前唤醒
+ * @retval 补偿的节拍数
+ */
+static uint32_t IDLE_Stop(uint32_t ms)
+{
+  uint32_t count;
+  uint32_t start;
+  uint32_t units;
+  uint32_t cycles;
+  uint32_t done;
+
+  if (ms > IDLE_STOP_MAX_MS)
+  {
+    ms = IDLE_STOP_MAX_MS;
+  }
+  // 提前一个唤醒延迟，恢复时钟后正好到达截止时刻
+  count = (uint32_t)(((uint64_t)ms * 1000 - IDLE_STOP_WAKE_US) * IDLE_WUT_HZ / 1000000);
+  if (count == 0)
+  {
+    count = 1;
+  }
+
+  RTC_WakeUpCmd(DISABLE);
+  RTC_SetWakeUpCounter(count - 1);
+  RTC_ClearITPendingBit(RTC_IT_WUT);
+  EXTI_ClearITPendingBit(EXTI_Line22);
+  RTC_WakeUpCmd(ENABLE);
+
+  // 暂停SysTick，当前节拍的相位保持到唤醒之后，期间的时间全部由RTC测量
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  start = IDLE_RtcRead();
+
+  PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);
+
+  cycles = TIME_GetCycles();
+  CLOCK_Resume();
+  cycles = TIME_GetCycles() - cycles; // 恢复期间内核运行在HSI
+  if (cycles / (HSI_VALUE / 1000000) > idle_stats.resume_max_us)
+  {
+    idle_stats.resume_max_us = cycles / (HSI_VALUE / 1000000);
+  }
+
+  units = IDLE_RtcRead() - start;
+  if ((int32_t)units < 0)
+  {
+    units += IDLE_RTC_UNITS_DAY;
+  }
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+  if (RTC_GetITStatus(RTC_IT_WUT) == RESET)
+  {
+    idle_stats.early_wakes++;
+  }
+  RTC_WakeUpCmd(DISABLE);
+
+  // 1024Hz换算为毫秒，余数留到下一次，长期不漂移
+  idle_frac += units * 1000;
+  done = idle_frac / (IDLE_RTC_PREDIV_S + 1);
+  idle_frac %= IDLE_RTC_PREDIV_S + 1;
+  idle_stats.stop_ms += done;
+  TIME_Compensate(done);
+  return done;
+}
+
+/**
+ * @brief 退出时睡眠：中断处理完直接回到睡眠，IDLE_Wake() 后回到线程
+ */
+static void IDLE_SleepOnExit(uint32_t ms)
+{
+  idle_soe_until = ms == 0xFFFFFFFF ? (uint64_t)-1 : TIME_GetTick() + ms;
+  idle_soe = 1;
+  SCB->SCR |= SCB_SCR_SLEEPONEXIT_Msk;
+
+  // 关中断下挂起的中断同样唤醒WFI；开中断后处理，返回时按SLEEPONEXIT继续睡眠
+  __DSB();
+  __WFI();
+  __ISB();
+  __enable_irq();
+  __disable_irq();
+
+  SCB->SCR &= ~SCB_SCR_SLEEPONEXIT_Msk;
+  idle_soe = 0;
+}
+
+uint32_t IDLE_Sleep(uint32_t ms)
+{
+  if (TIME_IsTickHeld())
+  {
+    idle_stats.count[IDLE_MODE_SLEEP_ON_EXIT]++;
+    IDLE_SleepOnExit(ms);
+    return 0;
+  }
+  if (idle_rtc_ready && ms >= IDLE_STOP_MIN_MS && idle_latency >= IDLE_STOP_WAKE_US)
+  {
+    idle_stats.count[IDLE_MODE_STOP]++;
+    return IDLE_Stop(ms);
+  }
+  idle_stats.count[IDLE_MODE_WFI]++;
+  return TIME_TicklessSleep(ms);
+}
+
+void IDLE_Wake(void)
+{
+  if (idle_soe)
+  {
+    SCB->SCR &= ~SCB_SCR_SLEEPONEXIT_Msk;
+  }
+}
+
+MEM_RAMFUNC void IDLE_Tick(void)
+{
+  if (idle_soe && (TIME_GetTick() >= idle_soe_until || !TIME_IsTickHeld()))
+  {
+    SCB->SCR &= ~SCB_SCR_SLEEPONEXIT_Msk;
+  }
+}
+
+void IDLE_RTC_IRQHandler(void)
+{
+  RTC_ClearITPendingBit(RTC_IT_WUT);
+  EXTI_ClearITPendingBit(EXTI_Line22);
+}
+
+const IDLE_Stats_t *IDLE_GetStats(void)
+{
+  return &idle_stats;
+}
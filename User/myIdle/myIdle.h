@@ -0,0 +1,118 @@
+/**
+ * @file myIdle.h
+ * @brief 低功耗空闲管理：按唤醒延迟预算在WFI、退出时睡眠与STOP之间选择
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 调度器空闲时调用 IDLE_Sleep()，按以下顺序选择睡眠方式：
+ * - 有模块申请连续节拍（TIME_HoldTick()）：退出时睡眠(SLEEPONEXIT)，
+ *   中断处理完直接回到睡眠，只有投递任务或到达截止时刻才回到线程；
+ * - 睡眠时间不小于 IDLE_STOP_MIN_MS，且所有模块登记的唤醒延迟容限都
+ *   不小于 IDLE_STOP_WAKE_US：进入STOP（调压器低功耗模式），由RTC唤醒
+ *   定时器在截止时刻前唤醒，唤醒后恢复PLL，并按RTC亚秒计数补偿节拍；
+ * - 其余情况：无节拍WFI睡眠（TIME_TicklessSleep()）。
+ *
+ * 需要外设时钟持续运行的模块（PWM、音频、串口DMA等）在活动期间用
+ * IDLE_SetLatency() 声明容限0，空闲后恢复为 IDLE_LATENCY_ANY。
+ * STOP期间EXTI（按键）与RTC仍可唤醒；RTC时钟使用LSE，LSE不起振时不进入STOP。
+ */
+
+#ifndef _MYIDLE_H_
+#define _MYIDLE_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @defgroup IDLE_Config 配置
+ * @{
+ */
+#define IDLE_CLIENT_MAX 8        ///< 可登记的模块数
+#define IDLE_STOP_WAKE_US 2500   ///< STOP唤醒到PLL恢复的最坏延迟：调压器与Flash唤醒、HSE起振、PLL锁定
+#define IDLE_STOP_MIN_MS 5       ///< 进入STOP的最短睡眠时间，更短时唤醒开销超过节省
+#define IDLE_STOP_MAX_MS 30000   ///< 单次STOP的最长时间（唤醒定时器16位计数）
+#define IDLE_STOP_FLASH_PD 1     ///< STOP期间关闭Flash电源
+#define IDLE_LSE_START_MS 3000   ///< 等待LSE起振的最长时间
+#define IDLE_LATENCY_ANY 0xFFFFFFFF ///< 不限制唤醒延迟
+/** @} */
+
+/**
+ * @brief 睡眠方式
+ */
+typedef enum
+{
+  IDLE_MODE_WFI = 0,       ///< 无节拍WFI
+  IDLE_MODE_SLEEP_ON_EXIT, ///< 退出时睡眠
+  IDLE_MODE_STOP,          ///< STOP，调压器低功耗模式
+  IDLE_MODE_NUM
+} IDLE_Mode;
+
+/**
+ * @brief 空闲统计
+ */
+typedef struct
+{
+  uint32_t count[IDLE_MODE_NUM]; ///< 各睡眠方式的进入次数
+  uint64_t stop_ms;              ///< 累计STOP时间（按RTC测量）
+  uint32_t early_wakes;          ///< 被RTC以外的中断提前唤醒的STOP次数
+  uint32_t resume_max_us;        ///< 唤醒后恢复时钟的最长时间
+} IDLE_Stats_t;
+
+/**
+ * @brief 空闲管理初始化：启动LSE并配置RTC亚秒计数与唤醒中断
+ * @note 在 TIME_Init() 之后调用；LSE未起振时只使用WFI与退出时睡眠
+ */
+void IDLE_Init(void);
+
+/**
+ * @brief 登记一个有唤醒延迟要求的模块
+ * @param name 模块名称
+ * @retval 模块编号，表满返回0xFF
+ * @note 登记后容限为 IDLE_LATENCY_ANY；可在 IDLE_Init() 之前调用
+ */
+uint8_t IDLE_Register(const char *name);
+
+/**
+ * @brief 声明模块可接受的唤醒延迟
+ * @param id IDLE_Register() 返回的编号
+ * @param us 唤醒延迟容限（微秒），IDLE_LATENCY_ANY表示不限制
+ * @note 可在中断中调用
+ */
+void IDLE_SetLatency(uint8_t id, uint32_t us);
+
+/**
+ * @brief 获取当前全部模块容限的最小值
+ */
+uint32_t IDLE_GetLatency(void);
+
+/**
+ * @brief 空闲睡眠
+ * @param ms 距最近截止时刻的毫秒数，0xFFFFFFFF表示没有定时
+ * @retval 补偿的节拍数
+ * @note 必须在关中断(PRIMASK=1)状态下调用，返回时仍为关中断
+ */
+uint32_t IDLE_Sleep(uint32_t ms);
+
+/**
+ * @brief 结束退出时睡眠，中断返回后回到线程
+ * @note 在中断中投递任务时调用（SCHED_Post() 已调用）
+ */
+void IDLE_Wake(void);
+
+/**
+ * @brief 节拍处理，在SysTick_Handler中 TIME_IncTick() 之后调用
+ * @note 退出时睡眠期间检查截止时刻与连续节拍申请
+ */
+void IDLE_Tick(void);
+
+/**
+ * @brief RTC唤醒中断处理，在RTC_WKUP_IRQHandler中调用
+ */
+void IDLE_RTC_IRQHandler(void);
+
+/**
+ * @brief 获取空闲统计
+ */
+const IDLE_Stats_t *IDLE_GetStats(void);
+
+#endif
@@ -1,6 +1,6 @@
 /**
  * @file myInit.c
- * @brief STM32F4xx GPIO初始化及延时函数实现
+ * @brief STM32F4xx 板级引脚表、批量GPIO初始化及引脚读写实现
  * @author flowkite-0689
  * @version v1.0
  * @date 2025.11.8
@@ -9,31 +9,129 @@
 #include "./myInit.h"
 
 /**
- * @brief 简单的循环延时函数
- * @param count 延时循环次数
- * @note 这是一个简单的软件延时，延时时间取决于CPU频率
+ * @brief 板级引脚描述表
  */
-void delay(uint32_t count)
+#define BOARD_PIN_DESC(name, port, pin, active_low, mode, speed) {port, pin, active_low},
+const BOARD_Pin_t BOARD_Pins[BOARD_PIN_NUM] = {BOARD_PIN_LIST(BOARD_PIN_DESC)};
+
+/**
+ * @brief GPIO端口数量（GPIOA~GPIOK）及端口编号换算
+ */
+#define GPIO_PORT_NUM 11
+#define GPIO_PORT_INDEX(GPIOx) (((uint32_t)(GPIOx) - GPIOA_BASE) >> 10)
+#define GPIO_PORT_FROM_INDEX(i) ((GPIO_TypeDef *)(GPIOA_BASE + ((uint32_t)(i) << 10)))
+
+/**
+ * @brief 板级GPIO配置表
+ * @note 每个引脚一项；GPIO_BatchInit() 按端口合成寄存器映像，项数不影响寄存器写入次数
+ */
+#define BOARD_PIN_CFG(name, port, pin, active_low, mode, speed) \
+  {port, pin, mode, speed, GPIO_OType_PP, GPIO_PuPd_NOPULL, 0},
+static const GPIO_PinCfg_t board_gpio_cfg[] = {BOARD_PIN_LIST(BOARD_PIN_CFG)};
+
+/**
+ * @brief 单个端口的寄存器映像
+ */
+typedef struct
 {
-  while (count--)
-    ;
-}
+  uint32_t moder;
+  uint32_t ospeedr;
+  uint32_t otyper;
+  uint32_t pupdr;
+  uint32_t afr[2];
+} GPIO_PortImage_t;
 
 /**
- * @brief 毫秒级延时函数
- * @param ms 延时时间（单位：毫秒）
- * @note 基于168MHz系统时钟的简单延时，约1ms=32000个循环周期
- * @warning 此函数为软件延时，精度较低，不适合需要精确计时的场景
+ * @brief 批量GPIO初始化函数
+ * @param cfg 配置项数组
+ * @param n 配置项数量
+ * @note 只遍历掩码中置位的引脚，不做16次逐位循环
  */
-void Delay_ms(uint32_t ms)
+void GPIO_BatchInit(const GPIO_PinCfg_t *cfg, uint32_t n)
 {
+  GPIO_PortImage_t img[GPIO_PORT_NUM];
+  uint32_t touched = 0;
   uint32_t i;
-  for (i = 0; i < ms; i++)
+
+  // 1. 收集涉及的端口，一次写入使能全部时钟
+  for (i = 0; i < n; i++)
   {
-    delay(32000); // 168MHz 下大约1ms
+    touched |= 1UL << GPIO_PORT_INDEX(cfg[i].port);
+  }
+  RCC->AHB1ENR |= touched; // GPIOxEN 位序与端口编号一致
+  (void)RCC->AHB1ENR;      // 时钟使能后需等待至少2个周期再访问外设
+
+  // 2. 读出当前配置，未配置的引脚保持不变
+  for (i = 0; i < GPIO_PORT_NUM; i++)
+  {
+    if (touched & (1UL << i))
+    {
+      GPIO_TypeDef *GPIOx = GPIO_PORT_FROM_INDEX(i);
+
+      img[i].moder = GPIOx->MODER;
+      img[i].ospeedr = GPIOx->OSPEEDR;
+      img[i].otyper = GPIOx->OTYPER;
+      img[i].pupdr = GPIOx->PUPDR;
+      img[i].afr[0] = GPIOx->AFR[0];
+      img[i].afr[1] = GPIOx->AFR[1];
+    }
+  }
+
+  // 3. 在RAM中合成寄存器映像
+  for (i = 0; i < n; i++)
+  {
+    GPIO_PortImage_t *p = &img[GPIO_PORT_INDEX(cfg[i].port)];
+    uint32_t pins = cfg[i].pins;
+    uint8_t outlike = (cfg[i].mode == GPIO_Mode_OUT) || (cfg[i].mode == GPIO_Mode_AF);
+
+    while (pins)
+    {
+      uint32_t pos = __CLZ(__RBIT(pins));
+      uint32_t pos2 = pos * 2;
+      uint32_t pos4 = (pos & 7) * 4;
+
+      pins &= pins - 1;
+
+      p->moder = (p->moder & ~(3UL << pos2)) | ((uint32_t)cfg[i].mode << pos2);
+      p->pupdr = (p->pupdr & ~(3UL << pos2)) | ((uint32_t)cfg[i].pupd << pos2);
+      if (outlike)
+      {
+        p->ospeedr = (p->ospeedr & ~(3UL << pos2)) | ((uint32_t)cfg[i].speed << pos2);
+        p->otyper = (p->otyper & ~(1UL << pos)) | ((uint32_t)cfg[i].otype << pos);
+      }
+      if (cfg[i].mode == GPIO_Mode_AF && cfg[i].af != GPIO_AF_KEEP)
+      {
+        p->afr[pos >> 3] = (p->afr[pos >> 3] & ~(0xFUL << pos4)) | ((uint32_t)cfg[i].af << pos4);
+      }
+    }
+  }
+
+  // 4. 每个寄存器写一次，MODER最后写入
+  for (i = 0; i < GPIO_PORT_NUM; i++)
+  {
+    if (touched & (1UL << i))
+    {
+      GPIO_TypeDef *GPIOx = GPIO_PORT_FROM_INDEX(i);
+
+      GPIOx->OSPEEDR = img[i].ospeedr;
+      GPIOx->OTYPER = img[i].otyper;
+      GPIOx->PUPDR = img[i].pupdr;
+      GPIOx->AFR[0] = img[i].afr[0];
+      GPIOx->AFR[1] = img[i].afr[1];
+      GPIOx->MODER = img[i].moder;
+    }
   }
 }
 
+/**
+ * @brief 板级GPIO初始化
+ * @note 3个端口，共一次时钟使能写入和18次寄存器写入
+ */
+void BOARD_Init(void)
+{
+  GPIO_BatchInit(board_gpio_cfg, sizeof(board_gpio_cfg) / sizeof(board_gpio_cfg[0]));
+}
+
 /**
  * @brief GPIO通用初始化函数
  * @param GPIOx GPIO端口（如GPIOA、GPIOB等）
@@ -48,52 +146,16 @@ void GPIO_MyInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin, GPIOMode_TypeDef GPIO_M
                  GPIOSpeed_TypeDef GPIO_Speed, GPIOOType_TypeDef GPIO_OType,
                  GPIOPuPd_TypeDef GPIO_PuPd)
 {
-  GPIO_InitTypeDef GPIO_InitStructure;
-
-  // 根据实际使用的GPIO端口使能对应时钟
-  if (GPIOx == GPIOA)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA, ENABLE);
-  }
-  else if (GPIOx == GPIOB)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOB, ENABLE);
-  }
-  else if (GPIOx == GPIOC)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOC, ENABLE);
-  }
-  else if (GPIOx == GPIOD)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOD, ENABLE);
-  }
-  else if (GPIOx == GPIOE)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOE, ENABLE);
-  }
-  else if (GPIOx == GPIOF)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOF, ENABLE);
-  }
-  else if (GPIOx == GPIOG)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOG, ENABLE);
-  }
-  else if (GPIOx == GPIOH)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOH, ENABLE);
-  }
-  else if (GPIOx == GPIOI)
-  {
-    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOI, ENABLE);
-  }
+  GPIO_PinCfg_t cfg;
 
-  GPIO_InitStructure.GPIO_Pin = GPIO_Pin;
-  GPIO_InitStructure.GPIO_Mode = GPIO_Mode;
-  GPIO_InitStructure.GPIO_OType = GPIO_OType;
-  GPIO_InitStructure.GPIO_Speed = GPIO_Speed;
-  GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd;
-  GPIO_Init(GPIOx, &GPIO_InitStructure);
+  cfg.port = GPIOx;
+  cfg.pins = (uint16_t)GPIO_Pin;
+  cfg.mode = (uint8_t)GPIO_Mode;
+  cfg.speed = (uint8_t)GPIO_Speed;
+  cfg.otype = (uint8_t)GPIO_OType;
+  cfg.pupd = (uint8_t)GPIO_PuPd;
+  cfg.af = GPIO_AF_KEEP;
+  GPIO_BatchInit(&cfg, 1);
 }
 
 /**
@@ -135,76 +197,140 @@ void BEEP_Init(uint32_t BEEP_PIN, GPIO_TypeDef *GPIOx)
 /**
  * @brief 按键GPIO初始化二次封装函数实现
  * @param x 按键编号(0-3)
- * @note 通过switch-case语句根据编号选择对应的按键GPIO进行初始化
+ * @note 根据编号从 BOARD_Pins[] 查表选择对应的按键GPIO进行初始化
  * @note 该函数简化了按键初始化调用，只需要传入编号即可
  * @note 不支持0-3以外的编号，传入其他值将不执行任何操作
  */
 void KEY_Initx(uint32_t x)
 {
-  switch (x)
+  if (x < 4)
   {
-  case 0:
-    KEY_Init(KEY0_PIN, KEY0_PORT);
-    break;
-  case 1:
-    KEY_Init(KEY1_PIN, KEY1_PORT);
-    break;
-  case 2:
-    KEY_Init(KEY2_PIN, KEY2_PORT);
-    break;
-  case 3:
-    KEY_Init(KEY3_PIN, KEY3_PORT);
-    break;
-
-  default:
-    break;
+    KEY_Init(BOARD_Pins[BOARD_KEY0 + x].mask, BOARD_Pins[BOARD_KEY0 + x].port);
   }
 }
 
 /**
  * @brief LED GPIO初始化二次封装函数实现
  * @param x LED编号(0-3)
- * @note 通过switch-case语句根据编号选择对应的LED GPIO进行初始化
+ * @note 根据编号从 BOARD_Pins[] 查表选择对应的LED GPIO进行初始化
  * @note 该函数简化了LED初始化调用，只需要传入编号即可
  * @note 不支持0-3以外的编号，传入其他值将不执行任何操作
  */
 void LED_Initx(uint32_t x)
 {
-  switch (x)
+  if (x < 4)
   {
-  case 0:
-    LED_Init(LED0_PIN, LED0_PORT);
-    break;
-  case 1:
-    LED_Init(LED1_PIN, LED1_PORT);
-    break;
-  case 2:
-    LED_Init(LED2_PIN, LED2_PORT);
-    break;
-  case 3:
-    LED_Init(LED3_PIN, LED3_PORT);
-    break;
-  default:
-    break;
+    LED_Init(BOARD_Pins[BOARD_LED0 + x].mask, BOARD_Pins[BOARD_LED0 + x].port);
   }
 }
 
 /**
  * @brief 蜂鸣器GPIO初始化二次封装函数实现
  * @param x 蜂鸣器编号
- * @note 通过switch-case语句根据编号选择对应的蜂鸣器GPIO进行初始化
+ * @note 根据编号从 BOARD_Pins[] 查表选择对应的蜂鸣器GPIO进行初始化
  * @note 当前仅支持编号0，为后续扩展预留接口
  * @note 不支持编号0以外的值，传入其他值将不执行任何操作
  */
 void BEEP_Initx(uint32_t x)
 {
-  switch (x)
+  if (x < 1)
   {
-  case 0:
-    BEEP_Init(BEEP0_PIN, BEEP0_PORT);
-    break;
+    BEEP_Init(BOARD_Pins[BOARD_BEEP0 + x].mask, BOARD_Pins[BOARD_BEEP0 + x].port);
+  }
+}
 
-  default:
-    break;
+/**
+ * @brief 计算引脚的BSRR写入值
+ * @param pin 引脚描述
+ * @param on 逻辑状态
+ * @retval 置位时为低16位掩码，复位时为高16位掩码
+ */
+static uint32_t PIN_BsrrWord(const BOARD_Pin_t *pin, uint8_t on)
+{
+  // 有效电平与极性相异时置位，否则复位
+  return (on ? !pin->active_low : pin->active_low) ? (uint32_t)pin->mask
+                                                   : (uint32_t)pin->mask << 16;
+}
+
+/**
+ * @brief 设置单个引脚的逻辑状态
+ * @param id 引脚编号（BOARD_PinId）
+ * @param on 1: 有效，0: 无效
+ */
+void PIN_Write(uint32_t id, uint8_t on)
+{
+  const BOARD_Pin_t *pin;
+
+  if (id >= BOARD_PIN_NUM)
+  {
+    return;
   }
+
+  pin = &BOARD_Pins[id];
+  GPIO_BSRR32(pin->port) = PIN_BsrrWord(pin, on);
+}
+
+/**
+ * @brief 批量设置多个引脚的逻辑状态
+ * @param change_mask 需要修改的引脚位图
+ * @param on_mask 需要置为有效的引脚位图
+ * @note 先在栈上按端口累积BSRR值，再对每个涉及的端口执行一次32位写入
+ */
+void PIN_BankWrite(uint32_t change_mask, uint32_t on_mask)
+{
+  uint32_t bsrr[GPIO_PORT_NUM] = {0};
+  uint32_t touched = 0;
+  uint32_t id;
+  uint32_t i;
+
+  change_mask &= BOARD_PIN_BIT(BOARD_PIN_NUM) - 1;
+
+  for (id = 0; change_mask; id++, change_mask >>= 1)
+  {
+    if (change_mask & 1)
+    {
+      const BOARD_Pin_t *pin = &BOARD_Pins[id];
+
+      i = GPIO_PORT_INDEX(pin->port);
+      bsrr[i] |= PIN_BsrrWord(pin, (on_mask >> id) & 1);
+      touched |= 1UL << i;
+    }
+  }
+
+  for (i = 0; touched; i++, touched >>= 1)
+  {
+    if (touched & 1)
+    {
+      GPIO_BSRR32(GPIO_PORT_FROM_INDEX(i)) = bsrr[i];
+    }
+  }
+}
+
+/**
+ * @brief 读取单个引脚的逻辑状态
+ * @param id 引脚编号（BOARD_PinId）
+ * @retval 1: 有效，0: 无效
+ */
+uint8_t PIN_Read(uint32_t id)
+{
+  const BOARD_Pin_t *pin;
+  uint32_t level;
+
+  if (id >= BOARD_PIN_NUM)
+  {
+    return 0;
+  }
+
+  pin = &BOARD_Pins[id];
+  // MODER为输出模式时读ODR，否则读IDR
+  if (((pin->port->MODER >> (2 * __CLZ(__RBIT(pin->mask)))) & 0x3) == GPIO_Mode_OUT)
+  {
+    level = pin->port->ODR & pin->mask;
+  }
+  else
+  {
+    level = pin->port->IDR & pin->mask;
+  }
+
+  return (level != 0) != pin->active_low;
 }
@@ -1,12 +1,12 @@
 /**
  * @file myInit.h
- * @brief STM32F4xx GPIO初始化及延时函数封装库
+ * @brief STM32F4xx GPIO初始化函数封装库
  * @author flowkite-0689
  * @version v1.0
  * @date 2025.11.8
  *
- * 本文件提供了STM32F4系列微控制器的GPIO初始化、延时函数等
- * 基础功能的封装，简化了硬件初始化流程。
+ * 本文件提供了STM32F4系列微控制器的GPIO初始化等基础功能的封装，
+ * 简化了硬件初始化流程。延时函数见 myTime.h。
  */
 
 #ifndef _MYINIT_H_
@@ -16,8 +16,14 @@
 #include "stm32f4xx_gpio.h"
 #include "stm32f4xx_rcc.h"
 
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
 /**
  * @defgroup LED_Definitions LED引脚定义
+ * @note 以下引脚宏在C++中解析为 myPin.hpp 的类型别名，见文件末尾
  * @{
  */
 #define LED0_PIN GPIO_Pin_9  ///< LED0引脚定义
@@ -53,11 +59,96 @@
 /** @} */
 
 /**
- * @brief 毫秒级延时函数
- * @param ms 延时时间（单位：毫秒）
- * @note 基于系统时钟的软件延时，精度较低，适用于非精确延时场景
+ * @defgroup BOARD_Pin_Table 板级引脚描述表
+ * @{
+ */
+
+/**
+ * @brief 板级引脚列表：X(名称, 端口, 引脚, 低电平有效, GPIO模式, 输出速度)
+ * @note BOARD_PinId、BOARD_Pins[] 与 BOARD_Init() 的批量配置都由该列表生成
  */
-void Delay_ms(uint32_t ms);
+#define BOARD_PIN_LIST(X)                                             \
+  X(LED0, LED0_PORT, LED0_PIN, 1, GPIO_Mode_OUT, GPIO_High_Speed)     \
+  X(LED1, LED1_PORT, LED1_PIN, 1, GPIO_Mode_OUT, GPIO_High_Speed)     \
+  X(LED2, LED2_PORT, LED2_PIN, 1, GPIO_Mode_OUT, GPIO_High_Speed)     \
+  X(LED3, LED3_PORT, LED3_PIN, 1, GPIO_Mode_OUT, GPIO_High_Speed)     \
+  X(KEY0, KEY0_PORT, KEY0_PIN, 1, GPIO_Mode_IN, GPIO_High_Speed)      \
+  X(KEY1, KEY1_PORT, KEY1_PIN, 1, GPIO_Mode_IN, GPIO_High_Speed)      \
+  X(KEY2, KEY2_PORT, KEY2_PIN, 1, GPIO_Mode_IN, GPIO_High_Speed)      \
+  X(KEY3, KEY3_PORT, KEY3_PIN, 1, GPIO_Mode_IN, GPIO_High_Speed)      \
+  X(BEEP0, BEEP0_PORT, BEEP0_PIN, 0, GPIO_Mode_OUT, GPIO_Speed_50MHz)
+
+/**
+ * @brief 板级引脚编号，作为 BOARD_Pins[] 的下标
+ */
+#define BOARD_PIN_ID(name, port, pin, active_low, mode, speed) BOARD_##name,
+typedef enum
+{
+  BOARD_PIN_LIST(BOARD_PIN_ID)
+  BOARD_PIN_NUM
+} BOARD_PinId;
+
+#define BOARD_PIN_BIT(id) (1UL << (id)) ///< 引脚编号转换为 PIN_BankWrite 使用的位
+#define BOARD_LED_MASK (BOARD_PIN_BIT(BOARD_LED0) | BOARD_PIN_BIT(BOARD_LED1) | \
+                        BOARD_PIN_BIT(BOARD_LED2) | BOARD_PIN_BIT(BOARD_LED3)) ///< 全部LED
+
+/**
+ * @brief 引脚描述
+ */
+typedef struct
+{
+  GPIO_TypeDef *port; ///< 所在端口
+  uint16_t mask;      ///< 引脚掩码（GPIO_Pin_x）
+  uint8_t active_low; ///< 1: 低电平有效（LED、按键），0: 高电平有效（蜂鸣器）
+} BOARD_Pin_t;
+
+/**
+ * @brief 板级引脚描述表，按 BOARD_PinId 排列
+ */
+extern const BOARD_Pin_t BOARD_Pins[BOARD_PIN_NUM];
+
+/**
+ * @brief 以32位方式访问BSRR（低16位置位、高16位复位）
+ * @note 库中GPIO_TypeDef把BSRR拆成BSRRL/BSRRH两个16位寄存器，
+ *       32位单次写入可在一个总线周期内同时完成置位和复位
+ */
+#define GPIO_BSRR32(GPIOx) (*(__IO uint32_t *)&(GPIOx)->BSRRL)
+/** @} */
+
+/**
+ * @brief 批量GPIO配置项
+ * @note 一项描述同一端口上配置相同的一组引脚
+ */
+typedef struct
+{
+  GPIO_TypeDef *port; ///< GPIO端口
+  uint16_t pins;      ///< 引脚掩码（GPIO_Pin_x的组合）
+  uint8_t mode;       ///< GPIOMode_TypeDef
+  uint8_t speed;      ///< GPIOSpeed_TypeDef（仅输出/复用模式有效）
+  uint8_t otype;      ///< GPIOOType_TypeDef（仅输出/复用模式有效）
+  uint8_t pupd;       ///< GPIOPuPd_TypeDef
+  uint8_t af;         ///< 复用功能编号GPIO_AF_xxx（仅复用模式有效），GPIO_AF_KEEP表示不修改AFR
+} GPIO_PinCfg_t;
+
+#define GPIO_AF_KEEP 0xFF ///< GPIO_PinCfg_t.af 取此值时保留原有复用功能配置
+
+/**
+ * @brief 批量GPIO初始化函数
+ * @param cfg 配置项数组
+ * @param n 配置项数量
+ * @note 先用一次 RCC->AHB1ENR 写入使能所有涉及端口的时钟，再在RAM中
+ *       合成每个端口的 MODER/OSPEEDR/OTYPER/PUPDR/AFR 映像，最后每个
+ *       寄存器只读一次、写一次；MODER最后写入，引脚切换模式时其余
+ *       配置已经生效
+ * @note 未出现在配置中的引脚保持原有配置
+ */
+void GPIO_BatchInit(const GPIO_PinCfg_t *cfg, uint32_t n);
+
+/**
+ * @brief 板级GPIO初始化
+ * @note 通过 GPIO_BatchInit() 一次性配置 BOARD_Pins[] 中的全部LED、按键、蜂鸣器引脚
+ */
+void BOARD_Init(void);
 
 /**
  * @brief GPIO通用初始化函数
@@ -68,6 +159,7 @@ void Delay_ms(uint32_t ms);
  * @param GPIO_OType GPIO输出类型（推挽、开漏）
  * @param GPIO_PuPd GPIO上下拉配置（上拉、下拉、无上下拉）
  * @note 函数会自动根据GPIOx参数使能对应的时钟
+ * @note 内部调用 GPIO_BatchInit()，配置多个端口时直接使用批量接口更快
  */
 void GPIO_MyInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin, GPIOMode_TypeDef GPIO_Mode,
                  GPIOSpeed_TypeDef GPIO_Speed, GPIOOType_TypeDef GPIO_OType,
@@ -101,7 +193,7 @@ void BEEP_Init(uint32_t BEEP_PIN, GPIO_TypeDef *GPIOx);
 /**
  * @brief 按键GPIO初始化二次封装函数
  * @param x 按键编号(0-3)
- * @note 根据编号初始化对应的按键GPIO:
+ * @note 根据编号从 BOARD_Pins[] 中查表初始化对应的按键GPIO:
  *       - 0: 初始化KEY0 (PA0)
  *       - 1: 初始化KEY1 (PE2)
  *       - 2: 初始化KEY2 (PE3)
@@ -113,7 +205,7 @@ void KEY_Initx(uint32_t x);
 /**
  * @brief LED GPIO初始化二次封装函数
  * @param x LED编号(0-3)
- * @note 根据编号初始化对应的LED GPIO:
+ * @note 根据编号从 BOARD_Pins[] 中查表初始化对应的LED GPIO:
  *       - 0: 初始化LED0 (PF9)
  *       - 1: 初始化LED1 (PF10)
  *       - 2: 初始化LED2 (PE13)
@@ -132,5 +224,86 @@ void LED_Initx(uint32_t x);
  */
 void BEEP_Initx(uint32_t x);
 
+/**
+ * @brief 设置单个引脚的逻辑状态
+ * @param id 引脚编号（BOARD_PinId）
+ * @param on 1: 有效（LED点亮/蜂鸣器鸣叫），0: 无效
+ * @note 按描述表中的极性换算电平，一次BSRR写入完成
+ */
+void PIN_Write(uint32_t id, uint8_t on);
+
+/**
+ * @brief 批量设置多个引脚的逻辑状态
+ * @param change_mask 需要修改的引脚位图（BOARD_PIN_BIT(id) 的组合）
+ * @param on_mask 其中需要置为有效的引脚位图，其余置为无效
+ * @note 按端口合并后每个端口只写一次32位BSRR，同一端口上的多个引脚
+ *       同时翻转，不会出现中间状态
+ */
+void PIN_BankWrite(uint32_t change_mask, uint32_t on_mask);
+
+/**
+ * @brief 读取单个引脚的逻辑状态
+ * @param id 引脚编号（BOARD_PinId）
+ * @retval 1: 有效（按键按下/LED点亮），0: 无效
+ * @note 输入引脚读IDR，输出引脚读ODR
+ */
+uint8_t PIN_Read(uint32_t id);
+
+#ifdef __cplusplus
+}
+
+/*
+ * C++中引脚宏解析为编译期类型别名：掩码为常量表达式，端口为固定地址。
+ * 先在编译期检查别名的掩码与上面的C定义一致（端口地址不是常量表达式，
+ * 由主机测试 Sim/pin_test.cpp 对照 BOARD_Pins[] 检查）
+ */
+#include "../myPin/myPin.hpp"
+
+static_assert(pin::Led0::mask == LED0_PIN && pin::Led1::mask == LED1_PIN &&
+                  pin::Led2::mask == LED2_PIN && pin::Led3::mask == LED3_PIN,
+              "LED aliases out of sync with myInit.h");
+static_assert(pin::Key0::mask == KEY0_PIN && pin::Key1::mask == KEY1_PIN &&
+                  pin::Key2::mask == KEY2_PIN && pin::Key3::mask == KEY3_PIN,
+              "KEY aliases out of sync with myInit.h");
+static_assert(pin::Beep0::mask == BEEP0_PIN, "BEEP alias out of sync with myInit.h");
+
+#undef LED0_PIN
+#undef LED0_PORT
+#undef LED1_PIN
+#undef LED1_PORT
+#undef LED2_PIN
+#undef LED2_PORT
+#undef LED3_PIN
+#undef LED3_PORT
+#undef KEY0_PIN
+#undef KEY0_PORT
+#undef KEY1_PIN
+#undef KEY1_PORT
+#undef KEY2_PIN
+#undef KEY2_PORT
+#undef KEY3_PIN
+#undef KEY3_PORT
+#undef BEEP0_PIN
+#undef BEEP0_PORT
+#define LED0_PIN (pin::Led0::mask)
+#define LED0_PORT (pin::Led0::port::regs())
+#define LED1_PIN (pin::Led1::mask)
+#define LED1_PORT (pin::Led1::port::regs())
+#define LED2_PIN (pin::Led2::mask)
+#define LED2_PORT (pin::Led2::port::regs())
+#define LED3_PIN (pin::Led3::mask)
+#define LED3_PORT (pin::Led3::port::regs())
+#define KEY0_PIN (pin::Key0::mask)
+#define KEY0_PORT (pin::Key0::port::regs())
+#define KEY1_PIN (pin::Key1::mask)
+#define KEY1_PORT (pin::Key1::port::regs())
+#define KEY2_PIN (pin::Key2::mask)
+#define KEY2_PORT (pin::Key2::port::regs())
+#define KEY3_PIN (pin::Key3::mask)
+#define KEY3_PORT (pin::Key3::port::regs())
+#define BEEP0_PIN (pin::Beep0::mask)
+#define BEEP0_PORT (pin::Beep0::port::regs())
+#endif
+
 #endif
 
@@ -0,0 +1,359 @@
+/**
+ * @file myKey.c
+ * @brief 整端口采样的非阻塞按键引擎实现
+ * @author flowkite-0689
+ * @version v1.1
+ * @date 2026.10.18
+ */
+
+#include "./myKey.h"
+#include "../myMem/myMem.h"
+
+/**
+ * @brief 单个端口的采样与消抖状态
+ * @note 每个位对应端口上的一个引脚，16个引脚并行消抖（垂直计数器）
+ */
+typedef struct
+{
+  GPIO_TypeDef *port;     ///< 端口
+  uint16_t mask;          ///< 端口上的按键引脚掩码
+  uint16_t state;         ///< 消抖后的状态，1表示按下
+  uint16_t ct0;           ///< 垂直计数器低位
+  uint16_t ct1;           ///< 垂直计数器高位
+  uint8_t key_of_bit[16]; ///< 引脚位号到按键编号的映射
+} KEY_Port_t;
+
+/**
+ * @brief 单个按键的时序状态
+ */
+typedef struct
+{
+  uint32_t press_tick;   ///< 确认按下的时刻
+  uint32_t release_tick; ///< 上次释放的时刻
+  uint32_t repeat_tick;  ///< 下一次连发的时刻
+  uint8_t long_sent;     ///< 本次按下是否已上报长按
+  uint8_t click_armed;   ///< 上次是短按，可与下一次按下组成双击
+  uint8_t double_sent;   ///< 本次按下是否已上报双击
+} KEY_Ctx_t;
+
+static KEY_Port_t key_ports[KEY_PORT_MAX] MEM_CCM;
+static uint8_t key_port_num;
+static uint32_t key_exti_lines; ///< 全部按键使用的EXTI线
+static KEY_Ctx_t key_ctx[KEY_NUM] MEM_CCM;
+static volatile uint16_t key_down;  ///< 当前按下的按键位图（按键编号）
+static volatile uint8_t key_active; ///< 非0时节拍执行扫描
+static uint8_t key_scan_div;
+
+static KEY_Event_t key_queue[KEY_QUEUE_SIZE] MEM_CCM;
+static volatile uint8_t key_q_head; ///< 仅由生产者(KEY_Tick)修改
+static volatile uint8_t key_q_tail; ///< 仅由消费者(KEY_GetEvent)修改
+static volatile uint32_t key_q_drop;
+static void (*key_notify)(void); ///< 事件入队后的通知回调
+
+/**
+ * @brief 事件入队（仅在节拍中断中调用）
+ */
+static void KEY_Push(uint8_t key, uint8_t type, uint16_t mask, uint32_t now)
+{
+  uint8_t head = key_q_head;
+  uint8_t next = (uint8_t)((head + 1) & (KEY_QUEUE_SIZE - 1));
+
+  if (next == key_q_tail)
+  {
+    key_q_drop++;
+    return;
+  }
+
+  key_queue[head].key = key;
+  key_queue[head].type = type;
+  key_queue[head].mask = mask;
+  key_queue[head].tick = now;
+  __DMB(); // 先写数据再发布head
+  key_q_head = next;
+
+  if (key_notify)
+  {
+    key_notify();
+  }
+}
+
+/**
+ * @brief 开始扫描，申请保持1ms节拍
+ * @note 扫描期间屏蔽全部按键EXTI线，避免抖动产生中断风暴
+ */
+static void KEY_Activate(void)
+{
+  EXTI->IMR &= ~key_exti_lines;
+  if (!key_active)
+  {
+    key_active = 1;
+    key_scan_div = KEY_SCAN_MS - 1; // 下一个节拍立即采样
+    TIME_HoldTick();
+  }
+}
+
+/**
+ * @brief 全部按键释放且稳定后停止扫描，重新使能EXTI
+ * @retval 1: 已停止，0: 使能后发现有按键按下，需要继续扫描
+ * @note 使能后再采样一次，防止在最后一次采样与使能之间按下的边沿丢失
+ */
+static uint8_t KEY_Rearm(void)
+{
+  uint8_t p;
+
+  EXTI->PR = key_exti_lines;
+  EXTI->IMR |= key_exti_lines;
+
+  for (p = 0; p < key_port_num; p++)
+  {
+    if (~key_ports[p].port->IDR & key_ports[p].mask)
+    {
+      EXTI->IMR &= ~key_exti_lines;
+      return 0;
+    }
+  }
+
+  if (key_active)
+  {
+    key_active = 0;
+    TIME_ReleaseTick();
+  }
+  return 1;
+}
+
+/**
+ * @brief 处理一个按键消抖后的按下/释放
+ */
+static void KEY_Edge(uint8_t key, uint8_t pressed, uint32_t now)
+{
+  KEY_Ctx_t *ctx = &key_ctx[key];
+  uint16_t bit = (uint16_t)(1U << key);
+
+  if (pressed)
+  {
+    key_down |= bit;
+    ctx->press_tick = now;
+    ctx->long_sent = 0;
+    ctx->double_sent = 0;
+    KEY_Push(key, KEY_EVT_PRESS, bit, now);
+
+    if (ctx->click_armed && (now - ctx->release_tick) <= KEY_DOUBLE_MS)
+    {
+      ctx->click_armed = 0;
+      ctx->double_sent = 1;
+      KEY_Push(key, KEY_EVT_DOUBLE, bit, now);
+    }
+
+    if (key_down & (uint16_t)~bit)
+    {
+      KEY_Push(key, KEY_EVT_CHORD, key_down, now);
+    }
+  }
+  else
+  {
+    key_down &= (uint16_t)~bit;
+    ctx->release_tick = now;
+    // 长按或已构成双击的按下，其释放不再参与双击（三连按只上报一次双击）
+    ctx->click_armed = !ctx->long_sent && !ctx->double_sent;
+    KEY_Push(key, KEY_EVT_RELEASE, bit, now);
+  }
+}
+
+void KEY_EngineInit(void)
+{
+  EXTI_InitTypeDef EXTI_InitStructure;
+  uint8_t i;
+  uint8_t p;
+
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+
+  key_port_num = 0;
+  key_exti_lines = 0;
+
+  // 按端口归并按键，EXTI线号等于引脚号
+  for (i = 0; i < KEY_NUM; i++)
+  {
+    const BOARD_Pin_t *pin = &BOARD_Pins[BOARD_KEY0 + i];
+    uint8_t pos = (uint8_t)__CLZ(__RBIT(pin->mask));
+    IRQn_Type irqn;
+
+    for (p = 0; p < key_port_num; p++)
+    {
+      if (key_ports[p].port == pin->port)
+      {
+        break;
+      }
+    }
+    if (p == key_port_num)
+    {
+      if (key_port_num == KEY_PORT_MAX)
+      {
+        continue;
+      }
+      key_ports[p].port = pin->port;
+      key_ports[p].mask = 0;
+      key_ports[p].state = 0;
+      key_ports[p].ct0 = 0xFFFF;
+      key_ports[p].ct1 = 0xFFFF;
+      key_port_num++;
+    }
+    key_ports[p].mask |= pin->mask;
+    key_ports[p].key_of_bit[pos] = i;
+
+    SYSCFG_EXTILineConfig((uint8_t)(((uint32_t)pin->port - GPIOA_BASE) >> 10), pos);
+    key_exti_lines |= pin->mask;
+
+    if (pos <= 4)
+    {
+      irqn = (IRQn_Type)(EXTI0_IRQn + pos);
+    }
+    else if (pos <= 9)
+    {
+      irqn = EXTI9_5_IRQn;
+    }
+    else
+    {
+      irqn = EXTI15_10_IRQn;
+    }
+    // 与SysTick同为最低优先级，EXTI与节拍处理互不抢占
+    NVIC_SetPriority(irqn, (1 << __NVIC_PRIO_BITS) - 1);
+    NVIC_EnableIRQ(irqn);
+
+    key_ctx[i].long_sent = 0;
+    key_ctx[i].click_armed = 0;
+    key_ctx[i].double_sent = 0;
+  }
+
+  key_q_head = 0;
+  key_q_tail = 0;
+  key_q_drop = 0;
+  key_down = 0;
+  key_active = 0;
+
+  EXTI_InitStructure.EXTI_Line = key_exti_lines;
+  EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+  EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+  EXTI_Init(&EXTI_InitStructure);
+
+  // 上电时已按下的按键直接开始扫描
+  if (!KEY_Rearm())
+  {
+    KEY_Activate();
+  }
+}
+
+void KEY_EXTI_IRQHandler(uint32_t EXTI_Line)
+{
+  EXTI->PR = EXTI_Line;
+  if (EXTI_Line & key_exti_lines)
+  {
+    KEY_Activate();
+  }
+}
+
+MEM_RAMFUNC void KEY_Tick(void)
+{
+  uint32_t now;
+  uint16_t pressed;
+  uint8_t settled = 1;
+  uint8_t p;
+  uint8_t i;
+
+  if (!key_active || ++key_scan_div < KEY_SCAN_MS)
+  {
+    return;
+  }
+  key_scan_div = 0;
+  now = TIME_GetTick32();
+
+  for (p = 0; p < key_port_num; p++)
+  {
+    KEY_Port_t *kp = &key_ports[p];
+    uint16_t raw = (uint16_t)(~kp->port->IDR & kp->mask); // 每个端口只读一次IDR
+    uint16_t chg = kp->state ^ raw;
+
+    // 2位垂直计数器：某位连续4次采样都与消抖状态不同才翻转
+    kp->ct0 = (uint16_t)~(kp->ct0 & chg);
+    kp->ct1 = kp->ct0 ^ (kp->ct1 & chg);
+    chg &= kp->ct0 & kp->ct1;
+    kp->state ^= chg;
+
+    if (raw != kp->state)
+    {
+      settled = 0;
+    }
+
+    while (chg)
+    {
+      uint8_t pos = (uint8_t)__CLZ(__RBIT(chg));
+
+      chg &= (uint16_t)(chg - 1);
+      KEY_Edge(kp->key_of_bit[pos], (kp->state >> pos) & 1, now);
+    }
+  }
+
+  // 长按与连发
+  pressed = key_down;
+  for (i = 0; pressed; i++, pressed >>= 1)
+  {
+    KEY_Ctx_t *ctx;
+
+    if ((pressed & 1) == 0)
+    {
+      continue;
+    }
+
+    ctx = &key_ctx[i];
+    if (!ctx->long_sent)
+    {
+      if ((now - ctx->press_tick) >= KEY_LONG_MS)
+      {
+        ctx->long_sent = 1;
+        ctx->repeat_tick = now + KEY_REPEAT_MS;
+        KEY_Push(i, KEY_EVT_LONG, (uint16_t)(1U << i), now);
+      }
+    }
+    else if ((int32_t)(now - ctx->repeat_tick) >= 0)
+    {
+      ctx->repeat_tick += KEY_REPEAT_MS;
+      KEY_Push(i, KEY_EVT_REPEAT, (uint16_t)(1U << i), now);
+    }
+  }
+
+  if (key_down == 0 && settled)
+  {
+    KEY_Rearm();
+  }
+}
+
+uint8_t KEY_GetEvent(KEY_Event_t *evt)
+{
+  uint8_t tail = key_q_tail;
+
+  if (tail == key_q_head)
+  {
+    return 0;
+  }
+
+  __DMB(); // 读到head之后再读数据
+  *evt = key_queue[tail];
+  __DMB();
+  key_q_tail = (uint8_t)((tail + 1) & (KEY_QUEUE_SIZE - 1));
+  return 1;
+}
+
+uint16_t KEY_GetDown(void)
+{
+  return key_down;
+}
+
+void KEY_SetNotify(void (*notify)(void))
+{
+  key_notify = notify;
+}
+
+uint32_t KEY_GetDropCount(void)
+{
+  return key_q_drop;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file myKey.h
+ * @brief 整端口采样的非阻塞按键引擎
+ * @author flowkite-0689
+ * @version v1.1
+ * @date 2026.10.18
+ *
+ * KEY0~KEY3 (PA0/PE2/PE3/PE4) 的下降沿通过EXTI唤醒扫描，之后每 KEY_SCAN_MS
+ * 个节拍对涉及的每个端口只读一次IDR（当前为GPIOA和GPIOE），用按位并行的
+ * 垂直计数器同时消抖端口上的全部按键，扫描开销与按键数量无关。
+ * 产生的按下/释放/长按/连发/双击/组合键事件写入无锁队列，主循环只需
+ * 调用 KEY_GetEvent() 取事件，不会在按键上等待。
+ */
+
+#ifndef _MYKEY_H_
+#define _MYKEY_H_
+
+#include "stm32f4xx.h"
+#include "../myInit/myInit.h"
+#include "../myTime/myTime.h"
+
+/**
+ * @defgroup KEY_Engine_Config 按键引擎参数
+ * @{
+ */
+#define KEY_NUM 4          ///< 按键数量（BOARD_KEY0起连续编号，不超过16）
+#define KEY_PORT_MAX 4     ///< 按键最多分布的端口数
+#define KEY_SCAN_MS 4      ///< 采样间隔，消抖时间为4次采样即16ms
+#define KEY_LONG_MS 800    ///< 长按判定时间
+#define KEY_REPEAT_MS 150  ///< 长按后的连发间隔
+#define KEY_DOUBLE_MS 300  ///< 双击判定：短按释放后在此时间内再次按下
+#define KEY_QUEUE_SIZE 16  ///< 事件队列长度，必须为2的幂
+/** @} */
+
+/**
+ * @brief 按键事件类型
+ */
+typedef enum
+{
+  KEY_EVT_PRESS = 0, ///< 按下（消抖确认后）
+  KEY_EVT_RELEASE,   ///< 释放（消抖确认后）
+  KEY_EVT_LONG,      ///< 长按（按下持续 KEY_LONG_MS）
+  KEY_EVT_REPEAT,    ///< 长按后每 KEY_REPEAT_MS 连发一次
+  KEY_EVT_DOUBLE,    ///< 双击，紧跟在第二次按下的 KEY_EVT_PRESS 之后；连续多次按下只在第二次上报
+  KEY_EVT_CHORD      ///< 组合键，有按键按下时其他按键仍处于按下状态，mask为全部按下的按键
+} KEY_EventType;
+
+/**
+ * @brief 按键事件
+ */
+typedef struct
+{
+  uint8_t key;   ///< 按键编号(0-3)，组合键为最后按下的按键
+  uint8_t type;  ///< 事件类型，见 KEY_EventType
+  uint16_t mask; ///< 相关按键位图（bit n 对应按键n）
+  uint32_t tick; ///< 事件产生时刻（TIME_GetTick32()）
+} KEY_Event_t;
+
+/**
+ * @brief 按键引擎初始化
+ * @note 按 BOARD_Pins[] 中的按键引脚按端口归并，初始化SYSCFG的EXTI映射、
+ *       EXTI下降沿触发以及NVIC，EXTI与SysTick使用相同的优先级，二者互不抢占
+ * @note 按键GPIO须先由 BOARD_Init() 配置；EXTI线按引脚号分配，
+ *       不同端口上引脚号相同的按键不能同时使用
+ * @note 需要另外以1ms周期调用 KEY_Tick()（在SysTick_Handler中调用），
+ *       事件时间戳取自 myTime 时基，须先调用 TIME_Init()
+ */
+void KEY_EngineInit(void);
+
+/**
+ * @brief 按键节拍处理函数
+ * @note 在1ms周期中断中调用；全部按键释放并稳定后立即返回
+ * @note 扫描期间通过 TIME_HoldTick() 保持节拍，空闲时允许时基进入无节拍睡眠
+ */
+void KEY_Tick(void);
+
+/**
+ * @brief 按键EXTI中断处理函数
+ * @param EXTI_Line 触发的EXTI线（EXTI_Line0/2/3/4）
+ * @note 在对应的EXTIx_IRQHandler中调用，屏蔽全部按键EXTI线并启动扫描
+ */
+void KEY_EXTI_IRQHandler(uint32_t EXTI_Line);
+
+/**
+ * @brief 从事件队列中取出一个按键事件
+ * @param evt 事件输出
+ * @retval 1: 取到事件，0: 队列为空
+ * @note 单生产者(KEY_Tick)单消费者(主循环)无锁队列，不需要关中断
+ */
+uint8_t KEY_GetEvent(KEY_Event_t *evt);
+
+/**
+ * @brief 获取当前消抖后按下的按键
+ * @retval 按键位图（bit n 对应按键n）
+ */
+uint16_t KEY_GetDown(void);
+
+/**
+ * @brief 设置事件通知回调
+ * @param notify 每个事件入队后在节拍中断中调用，可为NULL
+ * @note 用于唤醒调度器中的按键处理任务，回调须短小且可在中断中执行
+ */
+void KEY_SetNotify(void (*notify)(void));
+
+/**
+ * @brief 获取因队列满而丢弃的事件数
+ * @retval 丢弃计数
+ */
+uint32_t KEY_GetDropCount(void);
+
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @file myLed.c
+ * @brief 基于TIM1 + DMA2写GPIO BSRR的LED亮度/闪烁引擎实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myLed.h"
+#include "../myMem/myMem.h"
+#include "../myClock/myClock.h"
+#include "../myIdle/myIdle.h"
+#include "../myDma/myDma.h"
+
+/**
+ * @brief LED端口通道：一个端口的帧缓冲及驱动它的DMA请求
+ */
+typedef struct
+{
+  GPIO_TypeDef *port;           ///< LED所在端口
+  DMAM_Request req;             ///< 驱动该端口的TIM1 DMA请求
+  uint16_t tim_dma;             ///< 对应的TIM1 DMA请求使能位
+} LED_Lane_t;
+
+#define LED_LANE_NUM 2
+
+static const LED_Lane_t led_lanes[LED_LANE_NUM] = {
+    {GPIOF, DMAM_REQ_TIM1_UP, TIM_DMA_Update}, // LED0/LED1
+    {GPIOE, DMAM_REQ_TIM1_CH1, TIM_DMA_CC1},   // LED2/LED3
+};
+
+static uint8_t led_dma[LED_LANE_NUM] = {DMAM_INVALID, DMAM_INVALID}; ///< 各端口分配到的数据流
+
+/**
+ * @brief BSRR帧缓冲，每个PWM步一个字
+ */
+MEM_DMA_BUF(static uint32_t, led_frame, [LED_LANE_NUM][LED_PWM_STEPS]);
+
+/**
+ * @brief 单个LED的状态
+ */
+typedef struct
+{
+  uint8_t lane;      ///< 所在端口通道
+  uint8_t level;     ///< 当前输出亮度
+  uint8_t pattern;   ///< 效果，见 LED_Pattern
+  uint8_t peak;      ///< 效果峰值亮度
+  uint16_t period;   ///< 效果周期（毫秒）
+  uint16_t phase;    ///< 效果当前相位（毫秒）
+} LED_Ctx_t;
+
+static LED_Ctx_t led_ctx[LED_NUM] MEM_CCM;
+static uint8_t led_idle_id = 0xFF; ///< 空闲管理中的模块编号
+
+/**
+ * @brief 把一个LED的亮度写入所在端口的帧缓冲
+ * @note 只修改该LED对应的置位/复位位，同端口其他LED不受影响
+ */
+static void LED_Render(uint8_t led, uint8_t level)
+{
+  const BOARD_Pin_t *pin = &BOARD_Pins[BOARD_LED0 + led];
+  uint32_t *frame = led_frame[led_ctx[led].lane];
+  uint32_t bits = (uint32_t)pin->mask | ((uint32_t)pin->mask << 16);
+  uint32_t on = pin->active_low ? (uint32_t)pin->mask << 16 : pin->mask;
+  uint32_t off = bits ^ on;
+  uint32_t s;
+
+  for (s = 0; s < LED_PWM_STEPS; s++)
+  {
+    frame[s] = (frame[s] & ~bits) | (s < level ? on : off);
+  }
+}
+
+/**
+ * @brief 更新LED输出亮度，亮度不变时不改写帧缓冲
+ * @note 有LED处于全灭与常亮之间时需要TIM1与DMA持续运行，不允许进入STOP；
+ *       全灭/常亮时帧缓冲各字相同，STOP期间引脚保持不变
+ */
+static void LED_Apply(uint8_t led, uint8_t level)
+{
+  uint8_t pwm = 0;
+  uint8_t i;
+
+  if (led_ctx[led].level == level)
+  {
+    return;
+  }
+  led_ctx[led].level = level;
+  LED_Render(led, level);
+
+  for (i = 0; i < LED_NUM; i++)
+  {
+    if (led_ctx[i].level != 0 && led_ctx[i].level < LED_PWM_STEPS)
+    {
+      pwm = 1;
+    }
+  }
+  IDLE_SetLatency(led_idle_id, pwm ? 0 : IDLE_LATENCY_ANY);
+}
+
+void LED_EngineInit(void)
+{
+  DMA_InitTypeDef DMA_InitStructure;
+  TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+  TIM_OCInitTypeDef TIM_OCInitStructure;
+  DMA_Stream_TypeDef *stream;
+  uint32_t tim_clk;
+  uint8_t i;
+  uint8_t l;
+
+  if (led_idle_id == 0xFF)
+  {
+    led_idle_id = IDLE_Register("led");
+  }
+
+  // 按端口分配通道，初始全部熄灭
+  for (i = 0; i < LED_NUM; i++)
+  {
+    for (l = 0; l < LED_LANE_NUM; l++)
+    {
+      if (led_lanes[l].port == BOARD_Pins[BOARD_LED0 + i].port)
+      {
+        break;
+      }
+    }
+    led_ctx[i].lane = l < LED_LANE_NUM ? l : 0;
+    led_ctx[i].pattern = LED_PATTERN_STEADY;
+    led_ctx[i].level = 1;
+    LED_Apply(i, 0);
+  }
+
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1, ENABLE);
+
+  // 每个端口一个循环DMA：帧缓冲 -> GPIOx->BSRR
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+  DMA_InitStructure.DMA_BufferSize = LED_PWM_STEPS;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+  for (l = 0; l < LED_LANE_NUM; l++)
+  {
+    if (led_dma[l] == DMAM_INVALID)
+    {
+      led_dma[l] = DMAM_Alloc(led_lanes[l].req, "led");
+    }
+    stream = DMAM_GetStream(led_dma[l]);
+    if (stream == 0)
+    {
+      continue; // 数据流冲突，该端口的LED不输出
+    }
+    DMA_Cmd(stream, DISABLE);
+    DMA_DeInit(stream);
+    DMA_InitStructure.DMA_Channel = DMAM_GetChannel(led_dma[l]);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&GPIO_BSRR32(led_lanes[l].port);
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)MEM_DMA_PTR(led_frame)[l];
+    DMA_Init(stream, &DMA_InitStructure);
+    DMA_Cmd(stream, ENABLE);
+  }
+
+  tim_clk = CLOCK_GetTimerClock(TIM1);
+
+  TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+  TIM_TimeBaseStructure.TIM_Prescaler = 0;
+  TIM_TimeBaseStructure.TIM_Period = tim_clk / (LED_PWM_HZ * LED_PWM_STEPS) - 1;
+  TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
+
+  // CC1只用于产生第二路DMA请求，不输出到引脚
+  TIM_OCStructInit(&TIM_OCInitStructure);
+  TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+  TIM_OCInitStructure.TIM_Pulse = 0;
+  TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+
+  TIM_DMACmd(TIM1, TIM_DMA_Update | TIM_DMA_CC1, ENABLE);
+  TIM_Cmd(TIM1, ENABLE);
+
+  // 切换时钟档位后保持步进速率
+  CLOCK_RegisterTimer(TIM1, 0, LED_PWM_HZ * LED_PWM_STEPS);
+}
+
+void LED_SetBrightness(uint8_t led, uint8_t level)
+{
+  if (led >= LED_NUM)
+  {
+    return;
+  }
+
+  led_ctx[led].pattern = LED_PATTERN_STEADY;
+  LED_Apply(led, level);
+}
+
+uint8_t LED_GetBrightness(uint8_t led)
+{
+  return led < LED_NUM ? led_ctx[led].level : 0;
+}
+
+void LED_SetPattern(uint8_t led, LED_Pattern pattern, uint16_t period_ms, uint8_t level)
+{
+  if (led >= LED_NUM)
+  {
+    return;
+  }
+
+  if (period_ms < 2 * LED_PATTERN_MS)
+  {
+    period_ms = 2 * LED_PATTERN_MS;
+  }
+
+  led_ctx[led].peak = level;
+  led_ctx[led].period = period_ms;
+  led_ctx[led].phase = 0;
+  led_ctx[led].pattern = (uint8_t)pattern;
+  if (pattern == LED_PATTERN_STEADY)
+  {
+    LED_Apply(led, level);
+  }
+}
+
+void LED_PatternTick(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < LED_NUM; i++)
+  {
+    LED_Ctx_t *ctx = &led_ctx[i];
+    uint32_t half;
+    uint32_t ramp;
+
+    if (ctx->pattern == LED_PATTERN_STEADY)
+    {
+      continue;
+    }
+
+    ctx->phase += LED_PATTERN_MS;
+    if (ctx->phase >= ctx->period)
+    {
+      ctx->phase -= ctx->period;
+    }
+    half = ctx->period / 2;
+
+    if (ctx->pattern == LED_PATTERN_BLINK)
+    {
+      LED_Apply(i, ctx->phase < half ? ctx->peak : 0);
+    }
+    else
+    {
+      // 三角波，再平方近似人眼的亮度感知
+      ramp = ctx->phase < half ? ctx->phase : ctx->period - ctx->phase;
+      ramp = ramp * 255 / half;
+      LED_Apply(i, (uint8_t)(ramp * ramp * ctx->peak / (255 * 255)));
+    }
+  }
+}
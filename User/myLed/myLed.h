@@ -0,0 +1,84 @@
+/**
+ * @file myLed.h
+ * @brief 基于TIM1 + DMA2写GPIO BSRR的LED亮度/闪烁引擎
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 每个LED端口对应一个RAM中的BSRR帧缓冲（LED_PWM_STEPS个32位字），
+ * TIM1每个PWM步产生一次DMA请求，DMA2以循环模式把下一个字写入该端口的
+ * BSRR，实现8位软件PWM，每个PWM步不占用CPU周期。CPU只在亮度变化时
+ * 改写帧缓冲。闪烁/呼吸效果由 LED_PatternTick() 以 LED_PATTERN_MS 为
+ * 周期更新亮度，亮度不变时不改写缓冲。
+ *
+ * GPIO位于AHB1，只有DMA2能访问。LED0/LED1(GPIOF)使用TIM1更新事件
+ * (DMA2 Stream5 Ch6)，LED2/LED3(GPIOE)使用同一计数周期的TIM1 CC1事件
+ * (DMA2 Stream1 Ch6，被占用时由 DMAM_Alloc() 改用Stream3/Stream6)，
+ * 两路在同一个定时器周期内同步推进。
+ */
+
+#ifndef _MYLED_H_
+#define _MYLED_H_
+
+#include "stm32f4xx.h"
+#include "../myInit/myInit.h"
+
+/**
+ * @defgroup LED_Engine_Config LED引擎参数
+ * @{
+ */
+#define LED_NUM 4             ///< LED数量（BOARD_LED0起连续编号）
+#define LED_PWM_STEPS 255     ///< 每个PWM周期的步数，亮度255为常亮
+#define LED_PWM_HZ 200        ///< PWM频率，步进速率为 LED_PWM_HZ * LED_PWM_STEPS
+#define LED_PATTERN_MS 20     ///< LED_PatternTick() 调用周期
+#define LED_BRIGHTNESS_MAX 255 ///< 最大亮度
+/** @} */
+
+/**
+ * @brief LED效果
+ */
+typedef enum
+{
+  LED_PATTERN_STEADY = 0, ///< 常亮（按设定亮度）
+  LED_PATTERN_BLINK,      ///< 闪烁：半个周期亮、半个周期灭
+  LED_PATTERN_BREATHE     ///< 呼吸：亮度按周期渐亮渐暗
+} LED_Pattern;
+
+/**
+ * @brief LED引擎初始化
+ * @note 须在 BOARD_Init() 之后调用；初始全部熄灭
+ * @note 引擎运行后LED引脚由DMA持续刷新，PIN_Write() 对LED的写入会在
+ *       下一个PWM步被覆盖，应改用 LED_SetBrightness()
+ */
+void LED_EngineInit(void);
+
+/**
+ * @brief 设置LED亮度
+ * @param led LED编号(0-3)
+ * @param level 亮度(0-255)，0熄灭，255常亮
+ * @note 取消该LED的效果；亮度不变时直接返回，不改写帧缓冲
+ */
+void LED_SetBrightness(uint8_t led, uint8_t level);
+
+/**
+ * @brief 获取LED当前输出亮度
+ * @param led LED编号(0-3)
+ * @retval 亮度(0-255)
+ */
+uint8_t LED_GetBrightness(uint8_t led);
+
+/**
+ * @brief 设置LED效果
+ * @param led LED编号(0-3)
+ * @param pattern 效果
+ * @param period_ms 效果周期（毫秒）
+ * @param level 效果的峰值亮度
+ */
+void LED_SetPattern(uint8_t led, LED_Pattern pattern, uint16_t period_ms, uint8_t level);
+
+/**
+ * @brief 效果节拍，每 LED_PATTERN_MS 毫秒调用一次（例如作为调度器周期任务）
+ */
+void LED_PatternTick(void);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file myMem.h
+ * @brief 内存区域放置：CCM RAM与DMA缓冲区
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * STM32F407的64KB CCM RAM(0x10000000)只连接在CPU的D总线上，访问不经过
+ * 总线矩阵，不与DMA争用；但DMA无法访问CCM，且CCM没有位带别名。
+ *
+ * - 栈、堆、中断中使用的临时缓冲、只由CPU访问的热点表放入CCM（MEM_CCM）；
+ * - DMA读写的缓冲区用 MEM_DMA_BUF() 定义，放在主SRAM；
+ * - 上电后会被整体重写的大缓冲（采集、日志）用 MEM_NOINIT 或
+ *   MEM_DMA_NOINIT_BUF() 定义，启动时不清零，复位后内容保留；
+ * - SRAM2(0x2001C000，16KB)是总线矩阵上独立的从设备，DMA读写其中的缓冲
+ *   不与CPU访问SRAM1争用，这类缓冲用 MEM_SRAM2 定义（启动时不清零）；
+ * - 中断处理函数与热点函数用 MEM_RAMFUNC 放入SRAM1执行，取指不经过
+ *   Flash等待周期与ART加速器（CCM只能存放数据，不能执行代码）；
+ * - 填写DMA地址时用 MEM_DMA_PTR() 取址，未用 MEM_DMA_BUF() 定义的变量
+ *   （包括CCM中的变量）会在编译时报错，从而避免DMA指向CCM。
+ *
+ * 段的放置由链接脚本完成：Keil工程使用 Project/stm32f407_ccm.sct，
+ * 启动时由 __main 的分散加载完成CCM段、.ramfunc段的复制与清零；GCC构建见
+ * Bench/stm32f405_qemu.ld 与 Bench/startup_gcc.c。CCM时钟
+ * (RCC_AHB1ENR_CCMDATARAMEN) 复位后默认开启。
+ */
+
+#ifndef _MYMEM_H_
+#define _MYMEM_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @defgroup MEM_Regions 内存区域
+ * @{
+ */
+#define MEM_CCM_BASE CCMDATARAM_BASE ///< CCM起始地址
+#define MEM_CCM_SIZE 0x10000         ///< CCM大小（64KB）
+#define MEM_SRAM2_BASE 0x2001C000    ///< SRAM2起始地址
+#define MEM_SRAM2_SIZE 0x4000        ///< SRAM2大小（16KB）
+/** @} */
+
+/**
+ * @defgroup MEM_Sections 段属性
+ * @{
+ */
+#if defined(__CC_ARM)
+#define MEM_CCM __attribute__((section(".bss.ccmram"), zero_init))       ///< CCM，启动时清零
+#define MEM_CCM_DATA __attribute__((section(".data.ccmram")))            ///< CCM，带初值
+#define MEM_DMA_SECTION __attribute__((section(".bss.dmaram"), zero_init)) ///< 主SRAM，启动时清零
+#define MEM_NOINIT __attribute__((section(".bss.noinit"), zero_init))    ///< 主SRAM，启动时不清零
+#define MEM_SRAM2 __attribute__((section(".bss.sram2"), zero_init))      ///< SRAM2，启动时不清零
+#define MEM_RAMFUNC __attribute__((section(".ramfunc"), noinline))         ///< 代码放入SRAM1，启动时从Flash复制
+#else
+#define MEM_CCM __attribute__((section(".bss.ccmram")))
+#define MEM_CCM_DATA __attribute__((section(".data.ccmram")))
+#define MEM_DMA_SECTION __attribute__((section(".bss.dmaram")))
+#define MEM_NOINIT __attribute__((section(".bss.noinit")))
+#define MEM_SRAM2 __attribute__((section(".bss.sram2")))
+#define MEM_RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#endif
+/** @} */
+
+/**
+ * @brief 定义DMA缓冲区
+ * @param decl 存储类与类型，如 static uint16_t
+ * @param name 变量名
+ * @param dims 数组维数，如 [16]
+ * @note 同时定义类型 name##_mem_dma_t 作为标记，供 MEM_DMA_PTR() 检查
+ */
+#define MEM_DMA_BUF(decl, name, dims) \
+  typedef char name##_mem_dma_t;      \
+  decl name dims MEM_DMA_SECTION
+
+/**
+ * @brief 定义启动时不清零的DMA缓冲区，用法同 MEM_DMA_BUF()
+ */
+#define MEM_DMA_NOINIT_BUF(decl, name, dims) \
+  typedef char name##_mem_dma_t;             \
+  decl name dims MEM_NOINIT
+
+/**
+ * @brief 取DMA缓冲区地址
+ * @param name 由 MEM_DMA_BUF() 定义的变量名
+ * @note 变量不是由 MEM_DMA_BUF() 定义时编译报错
+ */
+#define MEM_DMA_PTR(name) ((void)sizeof(name##_mem_dma_t), (name))
+
+/**
+ * @brief 运行时判断地址是否位于CCM
+ * @note 用于检查调用者传入的指针（如栈上的缓冲区）能否交给DMA
+ */
+#define MEM_IS_CCM(addr) ((uint32_t)(addr) - MEM_CCM_BASE < MEM_CCM_SIZE)
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file myPin.hpp
+ * @brief 编译期GPIO引脚模板（C++11，仅头文件）
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * Pin<Port, N> 在编译期确定端口基地址与引脚掩码，set()/clear()/read()
+ * 内联后分别只有一次BSRR写入或一次IDR读取，没有函数调用，也没有
+ * assert_param 运行时检查；非法的端口、引脚号、复用功能号由
+ * static_assert 在编译期拒绝。
+ *
+ * 板级引脚的类型别名见文件末尾；C++中包含 myInit.h 时，LED0_PIN/LED0_PORT
+ * 等宏解析为这些别名，并在编译期检查与C定义一致。
+ */
+
+#ifndef _MYPIN_HPP_
+#define _MYPIN_HPP_
+
+#include "stm32f4xx.h"
+
+namespace pin
+{
+
+/**
+ * @brief GPIO端口编号
+ */
+enum PortId
+{
+  PortA = 0,
+  PortB,
+  PortC,
+  PortD,
+  PortE,
+  PortF,
+  PortG,
+  PortH,
+  PortI
+};
+
+/**
+ * @brief 引脚模式，数值与MODER字段一致
+ */
+enum Mode
+{
+  Input = 0,
+  Output = 1,
+  Alternate = 2,
+  Analog = 3
+};
+
+/**
+ * @brief 输出速度，数值与OSPEEDR字段一致
+ */
+enum Speed
+{
+  Low = 0,
+  Medium = 1,
+  Fast = 2,
+  High = 3
+};
+
+/**
+ * @brief 上下拉，数值与PUPDR字段一致
+ */
+enum Pull
+{
+  NoPull = 0,
+  PullUp = 1,
+  PullDown = 2
+};
+
+/**
+ * @brief 输出类型，数值与OTYPER字段一致
+ */
+enum OutType
+{
+  PushPull = 0,
+  OpenDrain = 1
+};
+
+/**
+ * @brief GPIO端口
+ * @tparam P 端口编号
+ */
+template <PortId P>
+struct Port
+{
+  static_assert(P <= PortI, "STM32F40x/41x only has GPIOA..GPIOI");
+
+  static constexpr uint32_t base = GPIOA_BASE + 0x400u * P; ///< 端口基地址
+  static constexpr uint32_t clock = 1u << P;                  ///< RCC->AHB1ENR 中的时钟使能位
+
+  /**
+   * @brief 端口寄存器块
+   */
+  static GPIO_TypeDef *regs()
+  {
+    return reinterpret_cast<GPIO_TypeDef *>(base);
+  }
+
+  /**
+   * @brief 32位BSRR（低16位置位、高16位复位）
+   */
+  static volatile uint32_t &bsrr()
+  {
+    return *reinterpret_cast<volatile uint32_t *>(base + 0x18);
+  }
+
+  /**
+   * @brief 使能端口时钟
+   */
+  static void enableClock()
+  {
+    RCC->AHB1ENR |= clock;
+    (void)RCC->AHB1ENR;
+  }
+};
+
+/**
+ * @brief GPIO引脚
+ * @tparam P 端口编号
+ * @tparam N 引脚号(0-15)
+ * @tparam ActiveLow 为true时 on()/off()/isOn() 按低电平有效换算
+ */
+template <PortId P, unsigned N, bool ActiveLow = false>
+struct Pin
+{
+  static_assert(N < 16, "GPIO pin number must be 0..15");
+
+  typedef Port<P> port;
+
+  static constexpr uint16_t mask = static_cast<uint16_t>(1u << N); ///< 引脚掩码，等同GPIO_Pin_N
+  static constexpr unsigned number = N;                              ///< 引脚号
+  static constexpr bool active_low = ActiveLow;                      ///< 极性
+
+  /**
+   * @brief 输出高电平，一次BSRR写入
+   */
+  static void set()
+  {
+    port::bsrr() = mask;
+  }
+
+  /**
+   * @brief 输出低电平，一次BSRR写入
+   */
+  static void clear()
+  {
+    port::bsrr() = static_cast<uint32_t>(mask) << 16;
+  }
+
+  /**
+   * @brief 输出指定电平，一次BSRR写入
+   */
+  static void write(bool high)
+  {
+    port::bsrr() = high ? static_cast<uint32_t>(mask) : static_cast<uint32_t>(mask) << 16;
+  }
+
+  /**
+   * @brief 翻转输出，一次ODR读取加一次BSRR写入
+   * @note 不对ODR做读改写，不会覆盖中断中对同端口其他引脚的修改
+   */
+  static void toggle()
+  {
+    write((port::regs()->ODR & mask) == 0);
+  }
+
+  /**
+   * @brief 读输入电平，一次IDR读取
+   */
+  static bool read()
+  {
+    return (port::regs()->IDR & mask) != 0;
+  }
+
+  /**
+   * @brief 置为有效（按极性换算）
+   */
+  static void on()
+  {
+    write(!ActiveLow);
+  }
+
+  /**
+   * @brief 置为无效（按极性换算）
+   */
+  static void off()
+  {
+    write(ActiveLow);
+  }
+
+  /**
+   * @brief 读取逻辑状态（按极性换算）
+   */
+  static bool isOn()
+  {
+    return read() != ActiveLow;
+  }
+
+  /**
+   * @brief 配置引脚
+   * @tparam M 模式
+   * @tparam S 输出速度（仅输出/复用模式有效）
+   * @tparam U 上下拉
+   * @tparam T 输出类型（仅输出/复用模式有效）
+   * @tparam AF 复用功能号（仅复用模式有效）
+   * @note 参数合法性在编译期检查；需要同时配置大量引脚时使用 GPIO_BatchInit()
+   */
+  template <Mode M, Speed S = High, Pull U = NoPull, OutType T = PushPull, unsigned AF = 0>
+  static void configure()
+  {
+    static_assert(AF < 16, "alternate function number must be 0..15");
+    static_assert(M == Alternate || AF == 0, "alternate function only applies to Alternate mode");
+    static_assert(M != Analog || U == NoPull, "analog pins must not enable pull-up/pull-down");
+
+    GPIO_TypeDef *regs = port::regs();
+
+    port::enableClock();
+    if (M == Output || M == Alternate)
+    {
+      regs->OSPEEDR = (regs->OSPEEDR & ~(3u << (2 * N))) | (static_cast<uint32_t>(S) << (2 * N));
+      regs->OTYPER = (regs->OTYPER & ~(1u << N)) | (static_cast<uint32_t>(T) << N);
+    }
+    if (M == Alternate)
+    {
+      regs->AFR[N >> 3] = (regs->AFR[N >> 3] & ~(0xFu << (4 * (N & 7)))) | (AF << (4 * (N & 7)));
+    }
+    regs->PUPDR = (regs->PUPDR & ~(3u << (2 * N))) | (static_cast<uint32_t>(U) << (2 * N));
+    regs->MODER = (regs->MODER & ~(3u << (2 * N))) | (static_cast<uint32_t>(M) << (2 * N));
+  }
+};
+
+/**
+ * @defgroup Pin_Board_Aliases 板级引脚类型别名
+ * @note 与 myInit.h 中的引脚宏一一对应，由 myInit.h 在编译期交叉检查
+ * @{
+ */
+typedef Pin<PortF, 9, true> Led0;
+typedef Pin<PortF, 10, true> Led1;
+typedef Pin<PortE, 13, true> Led2;
+typedef Pin<PortE, 14, true> Led3;
+typedef Pin<PortA, 0, true> Key0;
+typedef Pin<PortE, 2, true> Key1;
+typedef Pin<PortE, 3, true> Key2;
+typedef Pin<PortE, 4, true> Key3;
+typedef Pin<PortF, 8, false> Beep0;
+/** @} */
+
+} // namespace pin
+
+#endif
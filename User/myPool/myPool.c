@@ -0,0 +1,171 @@
+/**
+ * @file myPool.c
+ * @brief 确定性O(1)固定块内存池实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myPool.h"
+
+/**
+ * @brief 空闲块链表节点，存放在空闲块的开头
+ */
+typedef struct POOL_Node
+{
+  struct POOL_Node *next;
+} POOL_Node_t;
+
+/**
+ * @brief 尺寸等级
+ */
+typedef struct
+{
+  uint8_t *base;      ///< 存储区
+  POOL_Node_t *free;  ///< 已释放块的链表
+  uint16_t fresh;     ///< 从未分配过的第一个块的序号
+  POOL_Stats_t stats; ///< 统计
+} POOL_Class_t;
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK，可嵌套在中断中使用）
+ */
+#define POOL_ENTER_CRITICAL()                \
+  uint32_t pool_primask = __get_PRIMASK();   \
+  __disable_irq()
+#define POOL_EXIT_CRITICAL() __set_PRIMASK(pool_primask)
+
+#define POOL_STORAGE(size, count, section)                                                 \
+  typedef char pool_size_check_##size[((size) % 16 == 0 && (count) < 0x10000) ? 1 : -1]; \
+  static uint32_t pool_mem_##size[(size) / 4 * (count)] __attribute__((aligned(16))) section;
+POOL_CLASS_LIST(POOL_STORAGE)
+
+#define POOL_CLASS(size, count, section) {(uint8_t *)pool_mem_##size, 0, 0, {size, count}},
+static POOL_Class_t pool_cls[] MEM_CCM_DATA = {POOL_CLASS_LIST(POOL_CLASS)};
+
+#define POOL_CLASS_NUM (sizeof(pool_cls) / sizeof(pool_cls[0]))
+
+static uint32_t pool_fails;
+static uint32_t pool_bad_frees;
+
+/**
+ * @brief 从一个等级取出一块（调用者处于临界区）
+ */
+static void *POOL_Take(POOL_Class_t *c)
+{
+  void *p;
+
+  if (c->free)
+  {
+    p = c->free;
+    c->free = c->free->next;
+  }
+  else if (c->fresh < c->stats.count)
+  {
+    p = c->base + (uint32_t)c->fresh * c->stats.size;
+    c->fresh++;
+  }
+  else
+  {
+    c->stats.fails++;
+    return 0;
+  }
+
+  c->stats.allocs++;
+  if (++c->stats.used > c->stats.peak)
+  {
+    c->stats.peak = c->stats.used;
+  }
+  return p;
+}
+
+/**
+ * @brief 按尺寸分配
+ * @param dma 非0时跳过CCM中的等级
+ */
+static void *POOL_AllocFrom(uint32_t size, uint8_t dma)
+{
+  void *p = 0;
+  uint8_t i;
+  POOL_ENTER_CRITICAL();
+
+  for (i = 0; i < POOL_CLASS_NUM && p == 0; i++)
+  {
+    POOL_Class_t *c = &pool_cls[i];
+
+    if (c->stats.size >= size && !(dma && MEM_IS_CCM(c->base)))
+    {
+      p = POOL_Take(c);
+    }
+  }
+  if (p == 0)
+  {
+    pool_fails++;
+  }
+
+  POOL_EXIT_CRITICAL();
+  return p;
+}
+
+void *POOL_Alloc(uint32_t size)
+{
+  return POOL_AllocFrom(size, 0);
+}
+
+void *POOL_AllocDma(uint32_t size)
+{
+  return POOL_AllocFrom(size, 1);
+}
+
+void POOL_Free(void *p)
+{
+  uint8_t i;
+  POOL_Class_t *c;
+  uint32_t off;
+  POOL_ENTER_CRITICAL();
+
+  if (p == 0)
+  {
+    POOL_EXIT_CRITICAL();
+    return;
+  }
+
+  for (i = 0; i < POOL_CLASS_NUM; i++)
+  {
+    c = &pool_cls[i];
+    off = (uint32_t)((uint8_t *)p - c->base);
+
+    if (off < (uint32_t)c->stats.size * c->stats.count)
+    {
+      // 只接受分配过的块；used为0或与链表头相同必然是重复释放
+      if (off % c->stats.size == 0 && off < (uint32_t)c->stats.size * c->fresh && c->stats.used != 0 &&
+          (POOL_Node_t *)p != c->free)
+      {
+        ((POOL_Node_t *)p)->next = c->free;
+        c->free = (POOL_Node_t *)p;
+        c->stats.used--;
+        POOL_EXIT_CRITICAL();
+        return;
+      }
+      break;
+    }
+  }
+
+  pool_bad_frees++;
+  POOL_EXIT_CRITICAL();
+}
+
+const POOL_Stats_t *POOL_GetStats(uint8_t cls)
+{
+  return cls < POOL_CLASS_NUM ? &pool_cls[cls].stats : 0;
+}
+
+uint32_t POOL_GetFailCount(void)
+{
+  return pool_fails;
+}
+
+uint32_t POOL_GetBadFreeCount(void)
+{
+  return pool_bad_frees;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file myPool.h
+ * @brief 确定性O(1)固定块内存池，可在中断中使用
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 按 POOL_CLASS_LIST 定义若干尺寸等级，每个等级是一组等长内存块。
+ * 分配取满足尺寸的最小等级，该等级耗尽时依次尝试更大的等级；释放按地址
+ * 找回所属等级。分配与释放只做一次空闲链表的出栈/入栈，临界区仅几条指令，
+ * 执行时间与块数量无关，任务与中断中均可调用。
+ *
+ * 未分配过的块不需要预先串入空闲链表（按序号顺次取出），因此存储区可以放在
+ * MEM_NOINIT 段，启动时不清零也不需要初始化。
+ */
+
+#ifndef _MYPOOL_H_
+#define _MYPOOL_H_
+
+#include "stm32f4xx.h"
+#include "../myMem/myMem.h"
+
+/**
+ * @brief 尺寸等级表：X(块大小, 块数量, 存储段属性)
+ * @note 块大小须为16的倍数且按升序排列。存储段可用 MEM_CCM（仅CPU访问，
+ *       不参与 POOL_AllocDma()）、MEM_SRAM2（DMA缓冲，不与CPU争用SRAM1）、
+ *       MEM_NOINIT（SRAM1）等 myMem.h 中的段属性
+ */
+#define POOL_CLASS_LIST(X) \
+  X(32, 16, MEM_CCM)       \
+  X(128, 8, MEM_SRAM2)     \
+  X(512, 4, MEM_NOINIT)
+
+/**
+ * @brief 单个尺寸等级的统计
+ */
+typedef struct
+{
+  uint16_t size;   ///< 块大小（字节）
+  uint16_t count;  ///< 块数量
+  uint16_t used;   ///< 当前已分配块数
+  uint16_t peak;   ///< 已分配块数的峰值
+  uint32_t allocs; ///< 成功分配次数
+  uint32_t fails;  ///< 本等级已耗尽的次数（可能随后由更大的等级满足）
+} POOL_Stats_t;
+
+/**
+ * @brief 分配内存块
+ * @param size 需要的字节数
+ * @retval 块地址（16字节对齐），全部可用等级都耗尽时返回NULL
+ */
+void *POOL_Alloc(uint32_t size);
+
+/**
+ * @brief 分配可用于DMA的内存块（跳过CCM中的等级）
+ * @param size 需要的字节数
+ * @retval 块地址，失败返回NULL
+ */
+void *POOL_AllocDma(uint32_t size);
+
+/**
+ * @brief 释放内存块
+ * @param p POOL_Alloc()/POOL_AllocDma() 的返回值，NULL时不做任何事
+ * @note 不属于任何等级、未按块对齐、从未分配过的地址，以及可识别的重复释放（等级内
+ *       已无分配块，或与最近释放的块相同）被忽略并计入 POOL_GetBadFreeCount()
+ */
+void POOL_Free(void *p);
+
+/**
+ * @brief 获取等级统计
+ * @param cls 等级序号（按 POOL_CLASS_LIST 顺序）
+ * @retval 统计数据，序号无效时返回NULL
+ */
+const POOL_Stats_t *POOL_GetStats(uint8_t cls);
+
+/**
+ * @brief 全部等级都无法满足的分配次数
+ */
+uint32_t POOL_GetFailCount(void);
+
+/**
+ * @brief 非法释放次数
+ */
+uint32_t POOL_GetBadFreeCount(void);
+
+#endif
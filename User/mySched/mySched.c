@@ -0,0 +1,349 @@
+/**
+ * @file mySched.c
+ * @brief 运行至完成(run-to-completion)的协作式事件循环调度器实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./mySched.h"
+#include "../myMem/myMem.h"
+
+/**
+ * @brief 任务控制块
+ */
+typedef struct
+{
+  SCHED_TaskFn fn;      ///< 任务函数，NULL表示未使用
+  void *arg;            ///< 任务参数
+  const char *name;     ///< 任务名称
+  uint8_t prio;         ///< 优先级
+  uint8_t timer_on;     ///< 定时投递是否有效
+  uint32_t period;      ///< 周期（毫秒），0表示单次
+  uint64_t deadline;    ///< 下一次定时投递时刻
+  uint32_t post_cycles; ///< 最近一次投递时的DWT周期数
+  SCHED_Stats_t stats;  ///< 运行统计
+} SCHED_Task_t;
+
+static SCHED_Task_t sched_tasks[SCHED_MAX_TASKS] MEM_CCM;
+static uint8_t sched_task_num;
+static volatile uint32_t sched_ready[SCHED_PRIO_NUM]; ///< 每个优先级的就绪位图
+static uint64_t sched_idle_cycles;
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK，可嵌套在中断中使用）
+ */
+#define SCHED_ENTER_CRITICAL()                \
+  uint32_t sched_primask = __get_PRIMASK();   \
+  __disable_irq()
+#define SCHED_EXIT_CRITICAL() __set_PRIMASK(sched_primask)
+
+/**
+ * @brief 标记任务就绪（调用者处于临界区）
+ */
+static void SCHED_MakeReady(uint8_t id)
+{
+  uint32_t bit = 1UL << id;
+  volatile uint32_t *ready = &sched_ready[sched_tasks[id].prio];
+
+  if ((*ready & bit) == 0)
+  {
+    sched_tasks[id].post_cycles = TIME_GetCycles();
+    *ready |= bit;
+  }
+  IDLE_Wake();
+}
+
+void SCHED_Init(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < SCHED_MAX_TASKS; i++)
+  {
+    sched_tasks[i].fn = 0;
+    sched_tasks[i].timer_on = 0;
+  }
+  for (i = 0; i < SCHED_PRIO_NUM; i++)
+  {
+    sched_ready[i] = 0;
+  }
+  sched_task_num = 0;
+  SCHED_ResetStats();
+}
+
+uint8_t SCHED_Create(SCHED_TaskFn fn, void *arg, uint8_t prio, const char *name)
+{
+  SCHED_Task_t *t;
+
+  if (fn == 0 || prio >= SCHED_PRIO_NUM || sched_task_num >= SCHED_MAX_TASKS)
+  {
+    return SCHED_INVALID;
+  }
+
+  t = &sched_tasks[sched_task_num];
+  t->arg = arg;
+  t->name = name;
+  t->prio = prio;
+  t->timer_on = 0;
+  t->period = 0;
+  t->fn = fn;
+  return sched_task_num++;
+}
+
+void SCHED_Post(uint8_t id)
+{
+  if (id >= sched_task_num)
+  {
+    return;
+  }
+
+  {
+    SCHED_ENTER_CRITICAL();
+    SCHED_MakeReady(id);
+    SCHED_EXIT_CRITICAL();
+  }
+}
+
+void SCHED_PostAfter(uint8_t id, uint32_t ms)
+{
+  uint64_t deadline = TIME_Deadline(ms);
+
+  if (id >= sched_task_num)
+  {
+    return;
+  }
+
+  {
+    SCHED_ENTER_CRITICAL();
+    sched_tasks[id].deadline = deadline;
+    sched_tasks[id].period = 0;
+    sched_tasks[id].timer_on = 1;
+    SCHED_EXIT_CRITICAL();
+  }
+}
+
+void SCHED_PostEvery(uint8_t id, uint32_t period_ms)
+{
+  uint64_t deadline = TIME_Deadline(period_ms);
+
+  if (id >= sched_task_num || period_ms == 0)
+  {
+    return;
+  }
+
+  {
+    SCHED_ENTER_CRITICAL();
+    sched_tasks[id].deadline = deadline;
+    sched_tasks[id].period = period_ms;
+    sched_tasks[id].timer_on = 1;
+    SCHED_EXIT_CRITICAL();
+  }
+}
+
+void SCHED_Cancel(uint8_t id)
+{
+  if (id >= sched_task_num)
+  {
+    return;
+  }
+
+  {
+    SCHED_ENTER_CRITICAL();
+    sched_tasks[id].timer_on = 0;
+    SCHED_EXIT_CRITICAL();
+  }
+}
+
+/**
+ * @brief 处理到期的定时投递
+ * @param now 当前时刻
+ * @retval 距离最近一个未到期定时的毫秒数，没有定时返回0xFFFFFFFF
+ */
+static uint32_t SCHED_PollTimers(uint64_t now)
+{
+  uint64_t next = (uint64_t)-1;
+  uint8_t i;
+
+  for (i = 0; i < sched_task_num; i++)
+  {
+    SCHED_Task_t *t = &sched_tasks[i];
+    SCHED_ENTER_CRITICAL();
+
+    if (t->timer_on)
+    {
+      if (now >= t->deadline)
+      {
+        SCHED_MakeReady(i);
+        if (t->period)
+        {
+          t->deadline += t->period;
+          if (t->deadline <= now) // 落后超过一个周期时不补投
+          {
+            t->deadline = now + t->period;
+          }
+        }
+        else
+        {
+          t->timer_on = 0;
+        }
+      }
+      if (t->timer_on && t->deadline < next)
+      {
+        next = t->deadline;
+      }
+    }
+
+    SCHED_EXIT_CRITICAL();
+  }
+
+  if (next == (uint64_t)-1)
+  {
+    return 0xFFFFFFFF;
+  }
+  return (next - now) > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)(next - now);
+}
+
+/**
+ * @brief 取出最高优先级的就绪任务
+ * @retval 任务编号，无就绪任务返回 SCHED_INVALID
+ * @note 同一优先级内编号小的先运行
+ */
+static uint8_t SCHED_PickReady(void)
+{
+  uint8_t p;
+  uint8_t id = SCHED_INVALID;
+  SCHED_ENTER_CRITICAL();
+
+  for (p = 0; p < SCHED_PRIO_NUM; p++)
+  {
+    uint32_t ready = sched_ready[p];
+
+    if (ready)
+    {
+      id = (uint8_t)__CLZ(__RBIT(ready));
+      sched_ready[p] = ready & (ready - 1);
+      break;
+    }
+  }
+
+  SCHED_EXIT_CRITICAL();
+  return id;
+}
+
+/**
+ * @brief 运行一个任务并更新统计
+ */
+static void SCHED_Dispatch(uint8_t id)
+{
+  SCHED_Task_t *t = &sched_tasks[id];
+  uint32_t start;
+  uint32_t latency;
+  uint32_t run;
+#if STACK_STATS
+  uint32_t sp = STACK_ProbeBegin(); // 重新填充的开销不计入运行时间
+  uint32_t used;
+#endif
+
+  start = TIME_GetCycles();
+  latency = start - t->post_cycles;
+
+  t->fn(t->arg);
+
+  run = TIME_GetCycles() - start;
+#if STACK_STATS
+  used = STACK_ProbeEnd(sp);
+  if (used > t->stats.stack_max)
+  {
+    t->stats.stack_max = used;
+  }
+#endif
+  t->stats.runs++;
+  t->stats.run_total += run;
+  t->stats.latency_total += latency;
+  if (run > t->stats.run_max)
+  {
+    t->stats.run_max = run;
+  }
+  if (latency > t->stats.latency_max)
+  {
+    t->stats.latency_max = latency;
+  }
+}
+
+/**
+ * @brief 无就绪任务时睡眠到最近的截止时刻或下一个中断
+ * @param sleep_ms 距最近截止时刻的毫秒数
+ */
+static void SCHED_Idle(uint32_t sleep_ms)
+{
+  uint32_t start;
+  uint8_t p;
+
+  __disable_irq();
+
+  // 关中断后再确认一次，避免在检查与WFI之间被投递的任务被延误
+  for (p = 0; p < SCHED_PRIO_NUM; p++)
+  {
+    if (sched_ready[p])
+    {
+      __enable_irq();
+      return;
+    }
+  }
+
+  start = TIME_GetCycles();
+  IDLE_Sleep(sleep_ms);
+  sched_idle_cycles += TIME_GetCycles() - start;
+
+  __enable_irq();
+}
+
+void SCHED_Run(void)
+{
+  uint8_t id;
+  uint32_t sleep_ms;
+
+  while (1)
+  {
+    sleep_ms = SCHED_PollTimers(TIME_GetTick());
+
+    id = SCHED_PickReady();
+    if (id != SCHED_INVALID)
+    {
+      SCHED_Dispatch(id);
+      continue;
+    }
+
+    SCHED_Idle(sleep_ms);
+  }
+}
+
+const SCHED_Stats_t *SCHED_GetStats(uint8_t id)
+{
+  if (id >= sched_task_num)
+  {
+    return 0;
+  }
+  return &sched_tasks[id].stats;
+}
+
+uint64_t SCHED_GetIdleCycles(void)
+{
+  return sched_idle_cycles;
+}
+
+void SCHED_ResetStats(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < SCHED_MAX_TASKS; i++)
+  {
+    sched_tasks[i].stats.runs = 0;
+    sched_tasks[i].stats.run_max = 0;
+    sched_tasks[i].stats.run_total = 0;
+    sched_tasks[i].stats.latency_max = 0;
+    sched_tasks[i].stats.latency_total = 0;
+    sched_tasks[i].stats.stack_max = 0;
+  }
+  sched_idle_cycles = 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file mySched.h
+ * @brief 运行至完成(run-to-completion)的协作式事件循环调度器
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 任务是普通函数，被投递后按优先级执行一次直至返回。任务可以由中断
+ * 投递（SCHED_Post），也可以由定时器投递（SCHED_PostAfter/SCHED_PostEvery）。
+ * 没有就绪任务时调度器计算最近的截止时刻，交给 IDLE_Sleep()
+ * 按唤醒延迟预算以WFI或STOP睡眠到该时刻或下一个中断。每个任务统计运行次数、运行时间与
+ * 投递到运行之间的延迟（DWT周期数），以及运行时的最大栈用量。
+ */
+
+#ifndef _MYSCHED_H_
+#define _MYSCHED_H_
+
+#include "stm32f4xx.h"
+#include "../myTime/myTime.h"
+#include "../myStack/myStack.h"
+#include "../myIdle/myIdle.h"
+
+/**
+ * @defgroup SCHED_Config 调度器参数
+ * @{
+ */
+#define SCHED_MAX_TASKS 16 ///< 最大任务数（不超过32）
+#define SCHED_PRIO_NUM 4   ///< 优先级数量，0为最高
+#define SCHED_INVALID 0xFF ///< 无效任务编号
+/** @} */
+
+/**
+ * @brief 不返回函数属性，调用者之后的代码不再需要返回路径
+ */
+#if defined(__CC_ARM)
+#define SCHED_NORETURN __declspec(noreturn)
+#else
+#define SCHED_NORETURN __attribute__((noreturn))
+#endif
+
+/**
+ * @brief 任务函数
+ * @param arg 创建任务时传入的参数
+ */
+typedef void (*SCHED_TaskFn)(void *arg);
+
+/**
+ * @brief 任务运行统计（时间单位均为DWT周期）
+ */
+typedef struct
+{
+  uint32_t runs;          ///< 运行次数
+  uint32_t run_max;       ///< 单次最长运行时间
+  uint64_t run_total;     ///< 累计运行时间
+  uint32_t latency_max;   ///< 投递到开始运行的最长延迟
+  uint64_t latency_total; ///< 累计延迟
+  uint32_t stack_max;     ///< 单次运行的最大栈用量（字节），STACK_STATS 为0时不统计
+} SCHED_Stats_t;
+
+/**
+ * @brief 调度器初始化
+ * @note 须在 TIME_Init() 之后调用
+ */
+void SCHED_Init(void);
+
+/**
+ * @brief 创建任务
+ * @param fn 任务函数
+ * @param arg 任务参数
+ * @param prio 优先级(0 ~ SCHED_PRIO_NUM-1)，0最高
+ * @param name 任务名称，仅用于调试查看
+ * @retval 任务编号，失败返回 SCHED_INVALID
+ */
+uint8_t SCHED_Create(SCHED_TaskFn fn, void *arg, uint8_t prio, const char *name);
+
+/**
+ * @brief 投递任务，使其尽快运行一次
+ * @param id 任务编号
+ * @note 可在任务与中断中调用；任务尚未运行时重复投递只运行一次
+ */
+void SCHED_Post(uint8_t id);
+
+/**
+ * @brief 延时投递任务
+ * @param id 任务编号
+ * @param ms 延时（毫秒）
+ * @note 覆盖该任务之前设置的定时
+ */
+void SCHED_PostAfter(uint8_t id, uint32_t ms);
+
+/**
+ * @brief 周期投递任务
+ * @param id 任务编号
+ * @param period_ms 周期（毫秒），首次投递在一个周期后
+ * @note 覆盖该任务之前设置的定时；错过的周期不补投
+ */
+void SCHED_PostEvery(uint8_t id, uint32_t period_ms);
+
+/**
+ * @brief 取消任务的定时投递
+ * @param id 任务编号
+ */
+void SCHED_Cancel(uint8_t id);
+
+/**
+ * @brief 运行调度循环，不返回
+ */
+SCHED_NORETURN void SCHED_Run(void);
+
+/**
+ * @brief 获取任务统计
+ * @param id 任务编号
+ * @retval 统计数据指针，无效编号返回NULL
+ */
+const SCHED_Stats_t *SCHED_GetStats(uint8_t id);
+
+/**
+ * @brief 获取累计空闲（睡眠）周期数
+ * @retval 空闲周期数，与总周期数相比可得CPU占用率
+ * @note STOP期间DWT停止计数，不计入；STOP时间见 IDLE_GetStats()
+ */
+uint64_t SCHED_GetIdleCycles(void);
+
+/**
+ * @brief 清零全部任务统计与空闲统计
+ */
+void SCHED_ResetStats(void);
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * @file myStack.c
+ * @brief 栈/堆高水位统计实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myStack.h"
+
+extern uint32_t __stack_base[]; ///< 栈底（最低地址），启动文件定义
+extern uint32_t __initial_sp[]; ///< 栈顶
+extern uint32_t __heap_base[];  ///< 堆底
+extern uint32_t __heap_limit[]; ///< 堆顶
+
+static STACK_Ctx_t *stack_ctx[STACK_CTX_MAX];
+static uint8_t stack_ctx_num;
+
+/**
+ * @brief 探针重新填充后无法从栈区找回的历史最深位置
+ */
+static uint32_t *stack_low = 0;
+
+/**
+ * @brief 任务探针期间被中断入口重新填充抹掉的最深位置
+ */
+static uint32_t *stack_erased = 0;
+
+/**
+ * @brief 从p开始向上查找第一个被改写的字
+ */
+static uint32_t *STACK_ScanUp(uint32_t *p, const uint32_t *end)
+{
+  while (p < end && *p == STACK_PAINT)
+  {
+    p++;
+  }
+  return p;
+}
+
+/**
+ * @brief 重新填充前记下即将抹掉的最深位置（与中断互斥）
+ */
+static void STACK_Keep(uint32_t **mark, uint32_t *p)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if (*mark == 0 || p < *mark)
+  {
+    *mark = p;
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 当前栈区中被使用过的最低地址
+ */
+static uint32_t *STACK_Lowest(void)
+{
+  uint32_t *p = STACK_ScanUp(__stack_base, __initial_sp);
+
+  if (stack_low && stack_low < p)
+  {
+    p = stack_low;
+  }
+  return p;
+}
+
+uint32_t STACK_GetSize(void)
+{
+  return (uint32_t)((uint8_t *)__initial_sp - (uint8_t *)__stack_base);
+}
+
+uint32_t STACK_GetMspHighWater(void)
+{
+  return (uint32_t)((uint8_t *)__initial_sp - (uint8_t *)STACK_Lowest());
+}
+
+uint32_t STACK_GetHeapSize(void)
+{
+  return (uint32_t)((uint8_t *)__heap_limit - (uint8_t *)__heap_base);
+}
+
+uint32_t STACK_GetHeapHighWater(void)
+{
+  uint32_t *p = __heap_limit;
+
+  // 堆向上增长，从堆顶向下找第一个被改写的字
+  while (p > __heap_base && p[-1] == STACK_PAINT)
+  {
+    p--;
+  }
+  return (uint32_t)((uint8_t *)p - (uint8_t *)__heap_base);
+}
+
+uint32_t STACK_ProbeBegin(void)
+{
+  uint32_t sp = __get_MSP();
+  uint32_t *p;
+  uint32_t *end;
+
+  if (sp <= (uint32_t)__stack_base || sp > (uint32_t)__initial_sp)
+  {
+    return 0;
+  }
+
+  // 记录重新填充前的最深位置，保证MSP高水位不丢失
+  STACK_Keep(&stack_low, STACK_Lowest());
+
+  // 留出本函数栈帧以下的8个字不填充，避免改写正在使用的栈
+  end = (uint32_t *)(sp & ~3UL) - 8;
+  for (p = stack_low; p < end; p++)
+  {
+    *p = STACK_PAINT;
+  }
+  stack_erased = 0;
+  return sp;
+}
+
+uint32_t STACK_ProbeEnd(uint32_t entry_sp)
+{
+  uint32_t *p;
+
+  if (entry_sp == 0)
+  {
+    return 0;
+  }
+
+  p = STACK_ScanUp(__stack_base, (uint32_t *)entry_sp);
+  STACK_Keep(&stack_low, p);
+  // 任务曾经到达、之后被中断入口重新填充的位置
+  if (stack_erased && stack_erased < p)
+  {
+    p = stack_erased;
+  }
+  return entry_sp - (uint32_t)p;
+}
+
+void STACK_CtxRegister(STACK_Ctx_t *ctx)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if (!ctx->listed && stack_ctx_num < STACK_CTX_MAX)
+  {
+    ctx->listed = 1;
+    stack_ctx[stack_ctx_num] = ctx;
+    __DMB(); // 先写表项再发布数量
+    stack_ctx_num++;
+  }
+  __set_PRIMASK(primask);
+}
+
+const STACK_Ctx_t *STACK_GetCtx(uint8_t i)
+{
+  return i < stack_ctx_num ? stack_ctx[i] : 0;
+}
+
+/**
+ * @brief 由处理函数序言保存的EXC_RETURN找到被打断处的SP
+ * @param sp 当前SP
+ * @retval 硬件压栈前的SP，找不到时返回sp
+ */
+static uint32_t STACK_FrameTop(uint32_t sp)
+{
+  uint32_t *p = (uint32_t *)sp;
+  uint32_t *end = p + STACK_ISR_SEARCH;
+  uint32_t *frame;
+
+  if (end > __initial_sp)
+  {
+    end = __initial_sp;
+  }
+  // EXC_RETURN为0xFFFFFFE1/E9/ED/F1/F9/FD，是序言压栈的最高一个字，其上即硬件压栈帧
+  while (p < end && (*p | 0x1CUL) != 0xFFFFFFFDUL)
+  {
+    p++;
+  }
+  if (p == end)
+  {
+    return sp;
+  }
+  frame = p + 1;
+
+  // 位4为0时含浮点寄存器（26字），否则8字；压栈的xPSR位9表示另有一个对齐字
+  p = frame + ((*p & 0x10UL) ? 8 : 26);
+  if (p <= __initial_sp && (frame[7] & (1UL << 9)))
+  {
+    p++;
+  }
+  return p <= __initial_sp ? (uint32_t)p : sp;
+}
+
+uint32_t STACK_IsrEnter(void)
+{
+  uint32_t sp = __get_MSP();
+  uint32_t entry;
+  uint32_t *lo;
+  uint32_t *hi;
+  uint32_t *p;
+
+  if (sp <= (uint32_t)__stack_base || sp > (uint32_t)__initial_sp)
+  {
+    return 0;
+  }
+  entry = STACK_FrameTop(sp);
+
+  // 入口以下的区域可能残留先前更深的任务栈帧，重新填充后出口只看到本次中断的用量；
+  // 与 STACK_ProbeBegin() 一样留出当前SP以下8个字
+  lo = (uint32_t *)(entry - STACK_ISR_WINDOW);
+  hi = (uint32_t *)(sp & ~3UL) - 8;
+  if (lo < __stack_base)
+  {
+    lo = __stack_base;
+  }
+  if (lo < hi)
+  {
+    p = STACK_ScanUp(lo, hi);
+    if (p < hi)
+    {
+      STACK_Keep(&stack_low, p);
+      STACK_Keep(&stack_erased, p);
+    }
+    for (p = lo; p < hi; p++)
+    {
+      *p = STACK_PAINT;
+    }
+  }
+  return entry;
+}
+
+void STACK_IsrExit(STACK_Ctx_t *ctx, uint32_t entry_sp)
+{
+  uint32_t *lo = (uint32_t *)(entry_sp - STACK_ISR_WINDOW);
+  uint32_t used;
+
+  if (!ctx->listed)
+  {
+    STACK_CtxRegister(ctx);
+  }
+  if (entry_sp <= (uint32_t)__stack_base || entry_sp > (uint32_t)__initial_sp)
+  {
+    return;
+  }
+  if (lo < __stack_base)
+  {
+    lo = __stack_base;
+  }
+
+  used = entry_sp - (uint32_t)STACK_ScanUp(lo, (uint32_t *)entry_sp);
+  if (used > ctx->max)
+  {
+    ctx->max = used;
+  }
+}
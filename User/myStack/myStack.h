@@ -0,0 +1,123 @@
+/**
+ * @file myStack.h
+ * @brief 栈/堆填充与最坏情况使用量（高水位）统计
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 启动文件在 Reset_Handler 中把整个栈(STACK)与堆(HEAP)填充为 STACK_PAINT，
+ * 之后从栈底向上找到第一个被改写的字即可得到MSP的最大使用量。
+ *
+ * 调度器是运行至完成模式，所有任务与中断共用MSP。单个上下文的用量用探针测量：
+ * - 任务：STACK_ProbeBegin() 重新填充当前SP以下的空闲区，STACK_ProbeEnd()
+ *   找出本次运行到达的最深位置（含期间嵌套的中断，结果偏保守）；
+ * - 中断：STACK_IsrEnter() 由处理函数保存的EXC_RETURN找到硬件压栈帧，
+ *   取被打断处的SP为入口（计入压栈帧与处理函数序言），并只重新填充入口以下
+ *   STACK_ISR_WINDOW 字节；STACK_IsrExit() 在同一范围内查找，开销固定，
+ *   结果只含本次中断及其中嵌套的中断。
+ *
+ * 要求栈位于 UNINIT 区域（见 Project/stm32f407_ccm.sct），否则 __main 清零
+ * 会抹掉填充。
+ */
+
+#ifndef _MYSTACK_H_
+#define _MYSTACK_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @defgroup STACK_Config 栈统计参数
+ * @{
+ */
+#define STACK_PAINT 0xA5A5A5A5UL ///< 填充值，须与启动文件一致
+#define STACK_ISR_WINDOW 256     ///< 中断探针的填充与查找范围（字节）
+#define STACK_ISR_SEARCH 32      ///< 中断入口向上查找EXC_RETURN的字数
+#define STACK_CTX_MAX 8          ///< 可登记的中断上下文数量
+#define STACK_STATS 1            ///< 1: 启用任务与中断的栈探针，0: 只保留整体高水位
+/** @} */
+
+/**
+ * @brief 中断上下文的栈统计
+ */
+typedef struct
+{
+  const char *name; ///< 上下文名称
+  uint32_t max;     ///< 最大用量（字节），达到 STACK_ISR_WINDOW 表示可能更多
+  uint8_t listed;   ///< 已登记到上下文表
+} STACK_Ctx_t;
+
+/**
+ * @brief 中断处理函数的栈探针，STACK_ISR_BEGIN() 须是处理函数的第一条语句
+ * @note 首次退出时自动登记上下文
+ */
+#if STACK_STATS
+#define STACK_ISR_BEGIN() uint32_t stack_isr_sp = STACK_IsrEnter()
+#define STACK_ISR_END(ctx) STACK_IsrExit(&(ctx), stack_isr_sp)
+#else
+#define STACK_ISR_BEGIN()
+#define STACK_ISR_END(ctx)
+#endif
+
+/**
+ * @brief 栈区总大小（字节）
+ */
+uint32_t STACK_GetSize(void);
+
+/**
+ * @brief MSP自复位以来的最大用量（字节）
+ */
+uint32_t STACK_GetMspHighWater(void);
+
+/**
+ * @brief 堆区总大小（字节）
+ */
+uint32_t STACK_GetHeapSize(void);
+
+/**
+ * @brief 堆自复位以来被使用到的最高位置距堆底的字节数
+ */
+uint32_t STACK_GetHeapHighWater(void);
+
+/**
+ * @brief 任务探针开始：重新填充当前SP以下的空闲栈
+ * @retval 入口SP，传给 STACK_ProbeEnd()；SP不在栈区内时返回0
+ * @note 开销与空闲栈大小成正比，仅在线程模式调用
+ */
+uint32_t STACK_ProbeBegin(void);
+
+/**
+ * @brief 任务探针结束
+ * @param entry_sp STACK_ProbeBegin() 的返回值
+ * @retval 本次在入口SP以下使用的字节数
+ */
+uint32_t STACK_ProbeEnd(uint32_t entry_sp);
+
+/**
+ * @brief 登记中断上下文，之后可通过 STACK_GetCtx() 查看
+ * @param ctx 统计对象（静态存储）
+ * @note 使用 STACK_ISR_END() 时自动登记，无需调用
+ */
+void STACK_CtxRegister(STACK_Ctx_t *ctx);
+
+/**
+ * @brief 获取已登记的中断上下文
+ * @param i 序号
+ * @retval 统计对象，序号无效时返回NULL
+ */
+const STACK_Ctx_t *STACK_GetCtx(uint8_t i);
+
+/**
+ * @brief 中断入口：重新填充入口SP以下 STACK_ISR_WINDOW 字节
+ * @retval 被打断处的SP（硬件压栈前），找不到压栈帧时为当前SP；不在栈区内时返回0
+ * @note 须在处理函数中直接调用（处理函数序言已把EXC_RETURN压栈）
+ */
+uint32_t STACK_IsrEnter(void);
+
+/**
+ * @brief 中断出口：在入口SP以下查找本次用量并更新统计
+ * @param ctx 统计对象
+ * @param entry_sp STACK_IsrEnter() 的返回值
+ */
+void STACK_IsrExit(STACK_Ctx_t *ctx, uint32_t entry_sp);
+
+#endif
@@ -0,0 +1,292 @@
+/**
+ * @file myStream.c
+ * @brief 零拷贝N缓冲连续采集/播放流实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myStream.h"
+#include "../myMem/myMem.h"
+#include "../myIdle/myIdle.h"
+
+/**
+ * @brief 缓冲状态
+ */
+enum
+{
+  STREAM_ST_DMA = 0, ///< 在地址寄存器中或排队等待装入
+  STREAM_ST_READY,   ///< 在使用者队列中
+  STREAM_ST_HELD     ///< 使用者持有
+};
+
+/**
+ * @brief 临界区（保存并恢复PRIMASK）
+ */
+#define STREAM_ENTER_CRITICAL()              \
+  uint32_t stream_primask = __get_PRIMASK(); \
+  __disable_irq()
+#define STREAM_EXIT_CRITICAL() __set_PRIMASK(stream_primask)
+
+/**
+ * @brief 队列入队/出队（队列长度不超过缓冲数，不会溢出）
+ */
+static void STREAM_Push(uint8_t *q, uint8_t head, uint8_t *count, uint8_t idx)
+{
+  q[(head + *count) % STREAM_BUF_MAX] = idx;
+  (*count)++;
+}
+
+static uint8_t STREAM_Pop(uint8_t *q, uint8_t *head, uint8_t *count)
+{
+  uint8_t idx = q[*head];
+
+  *head = (uint8_t)((*head + 1) % STREAM_BUF_MAX);
+  (*count)--;
+  return idx;
+}
+
+/**
+ * @brief 从使用者队列中删除指定缓冲（被DMA重新占用）
+ */
+static void STREAM_Drop(STREAM_t *s, uint8_t idx)
+{
+  uint8_t n = s->user_count;
+  uint8_t i;
+  uint8_t v;
+
+  for (i = 0; i < n; i++)
+  {
+    v = STREAM_Pop(s->user_q, &s->user_head, &s->user_count);
+    if (v != idx)
+    {
+      STREAM_Push(s->user_q, s->user_head, &s->user_count, v);
+    }
+  }
+}
+
+/**
+ * @brief 空闲地址寄存器仍是交给使用者的缓冲时，换成排队的缓冲
+ * @note 只在传输完成/半传输中断中调用，距离下一次切换至少半个缓冲时长
+ */
+MEM_RAMFUNC static void STREAM_Rearm(STREAM_t *s, DMA_Stream_TypeDef *stream)
+{
+  uint8_t r = DMA_GetCurrentMemoryTarget(stream) ? 0 : 1;
+  uint8_t idx;
+
+  if (s->dma_count == 0 || s->state[s->reg[r]] == STREAM_ST_DMA)
+  {
+    return;
+  }
+  idx = STREAM_Pop(s->dma_q, &s->dma_head, &s->dma_count);
+  DMA_MemoryTargetConfig(stream, (uint32_t)s->bufs[idx], r ? DMA_Memory_1 : DMA_Memory_0);
+  s->reg[r] = idx;
+}
+
+/**
+ * @brief DMA事件：传输完成时交出缓冲并补装空闲寄存器
+ */
+MEM_RAMFUNC static void STREAM_DmaEvent(void *arg, uint32_t evts)
+{
+  STREAM_t *s = (STREAM_t *)arg;
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(s->dma);
+  uint8_t r;
+  uint8_t done;
+  uint8_t active;
+
+  if (evts & DMAM_EVT_TE)
+  {
+    // 传输错误时硬件已关闭数据流，由使用者 STREAM_Start() 重新开始
+    s->errors++;
+    return;
+  }
+  if (evts & DMAM_EVT_TC)
+  {
+    // CT已切换到正在传输的寄存器，另一个是刚完成的
+    r = DMA_GetCurrentMemoryTarget(stream) ? 0 : 1;
+    done = s->reg[r];
+    active = s->reg[r ^ 1];
+    s->buffers++;
+
+    // DMA切换到的缓冲仍在使用者一侧：使用者跟不上，该缓冲被覆盖/重播
+    if (s->state[active] != STREAM_ST_DMA)
+    {
+      s->overruns++;
+      if (s->state[active] == STREAM_ST_READY)
+      {
+        STREAM_Drop(s, active);
+        s->state[active] = STREAM_ST_DMA;
+      }
+    }
+    if (s->state[done] == STREAM_ST_DMA)
+    {
+      s->state[done] = STREAM_ST_READY;
+      STREAM_Push(s->user_q, s->user_head, &s->user_count, done);
+    }
+    STREAM_Rearm(s, stream);
+    if (s->notify)
+    {
+      s->notify(s->notify_arg);
+    }
+  }
+  else if (evts & DMAM_EVT_HT)
+  {
+    STREAM_Rearm(s, stream);
+  }
+}
+
+ErrorStatus STREAM_Init(STREAM_t *s, const char *name, DMAM_Request req, DMA_InitTypeDef *init, void *const *bufs,
+                        uint8_t num)
+{
+  DMA_Stream_TypeDef *stream;
+  uint8_t i;
+
+  if (num < 2 || num > STREAM_BUF_MAX)
+  {
+    return ERROR;
+  }
+  init->DMA_MemoryInc = DMA_MemoryInc_Enable;
+  init->DMA_Mode = DMA_Mode_Circular;
+  // 每个缓冲都要符合突发/FIFO配置的对齐要求，也不能位于CCM
+  for (i = 0; i < num; i++)
+  {
+    init->DMA_Memory0BaseAddr = (uint32_t)bufs[i];
+    if (bufs[i] == 0 || DMAM_Validate(init) != SUCCESS)
+    {
+      return ERROR;
+    }
+    s->bufs[i] = bufs[i];
+  }
+  s->num = num;
+  s->items = (uint16_t)init->DMA_BufferSize;
+  s->playback = init->DMA_DIR == DMA_DIR_MemoryToPeripheral;
+  s->notify = 0;
+  s->dma = DMAM_Alloc(req, name);
+  if (s->dma == DMAM_INVALID)
+  {
+    return ERROR;
+  }
+  s->idle_id = IDLE_Register(name);
+
+  stream = DMAM_GetStream(s->dma);
+  DMA_DeInit(stream);
+  init->DMA_Channel = DMAM_GetChannel(s->dma);
+  init->DMA_Memory0BaseAddr = (uint32_t)bufs[0];
+  DMA_Init(stream, init);
+  DMA_DoubleBufferModeConfig(stream, (uint32_t)bufs[1], DMA_Memory_0);
+  DMA_DoubleBufferModeCmd(stream, ENABLE);
+  DMA_ITConfig(stream, DMA_IT_TC | DMA_IT_HT | DMA_IT_TE, ENABLE);
+
+  if (DMAM_SetCallback(s->dma, STREAM_DmaEvent, s, STREAM_IRQ_PRIO) != SUCCESS)
+  {
+    DMAM_Free(s->dma);
+    s->dma = DMAM_INVALID;
+    return ERROR;
+  }
+  return SUCCESS;
+}
+
+void STREAM_SetNotify(STREAM_t *s, STREAM_Notify notify, void *arg)
+{
+  STREAM_ENTER_CRITICAL();
+  s->notify_arg = arg;
+  s->notify = notify;
+  STREAM_EXIT_CRITICAL();
+}
+
+void STREAM_Start(STREAM_t *s)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(s->dma);
+  uint8_t i;
+
+  if (stream == 0)
+  {
+    return;
+  }
+  STREAM_Stop(s);
+
+  s->dma_head = s->dma_count = 0;
+  s->user_head = s->user_count = 0;
+  for (i = 0; i < s->num; i++)
+  {
+    s->state[i] = STREAM_ST_DMA;
+    if (i < 2)
+    {
+      continue;
+    }
+    // 其余缓冲：采集时排队等待装入，播放时交给生产者填充
+    if (s->playback)
+    {
+      s->state[i] = STREAM_ST_READY;
+      STREAM_Push(s->user_q, s->user_head, &s->user_count, i);
+    }
+    else
+    {
+      STREAM_Push(s->dma_q, s->dma_head, &s->dma_count, i);
+    }
+  }
+  s->reg[0] = 0;
+  s->reg[1] = 1;
+  DMA_MemoryTargetConfig(stream, (uint32_t)s->bufs[0], DMA_Memory_0);
+  DMA_DoubleBufferModeConfig(stream, (uint32_t)s->bufs[1], DMA_Memory_0);
+  DMA_SetCurrDataCounter(stream, s->items);
+  DMAM_ClearFlags(s->dma, DMAM_EVT_ALL);
+
+  // 外设时钟须在传输期间持续运行
+  IDLE_SetLatency(s->idle_id, 0);
+  DMA_Cmd(stream, ENABLE);
+}
+
+void STREAM_Stop(STREAM_t *s)
+{
+  DMA_Stream_TypeDef *stream = DMAM_GetStream(s->dma);
+
+  if (stream == 0)
+  {
+    return;
+  }
+  DMA_Cmd(stream, DISABLE);
+  while (DMA_GetCmdStatus(stream) != DISABLE)
+    ;
+  DMAM_ClearFlags(s->dma, DMAM_EVT_ALL);
+  IDLE_SetLatency(s->idle_id, IDLE_LATENCY_ANY);
+}
+
+void *STREAM_Get(STREAM_t *s)
+{
+  uint8_t idx;
+  STREAM_ENTER_CRITICAL();
+
+  if (s->user_count == 0)
+  {
+    STREAM_EXIT_CRITICAL();
+    return 0;
+  }
+  idx = STREAM_Pop(s->user_q, &s->user_head, &s->user_count);
+  s->state[idx] = STREAM_ST_HELD;
+
+  STREAM_EXIT_CRITICAL();
+  return s->bufs[idx];
+}
+
+void STREAM_Release(STREAM_t *s, void *buf)
+{
+  uint8_t idx;
+  STREAM_ENTER_CRITICAL();
+
+  for (idx = 0; idx < s->num && s->bufs[idx] != buf; idx++)
+    ;
+  if (idx == s->num || s->state[idx] != STREAM_ST_HELD)
+  {
+    STREAM_EXIT_CRITICAL();
+    return;
+  }
+  s->state[idx] = STREAM_ST_DMA;
+  // 仍在地址寄存器中的缓冲（乒乓缓冲）原地复用，其余排队等待装入
+  if (s->reg[0] != idx && s->reg[1] != idx)
+  {
+    STREAM_Push(s->dma_q, s->dma_head, &s->dma_count, idx);
+  }
+
+  STREAM_EXIT_CRITICAL();
+}
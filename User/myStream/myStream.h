@@ -0,0 +1,117 @@
+/**
+ * @file myStream.h
+ * @brief 基于DMA双缓冲模式的零拷贝N缓冲连续采集/播放流
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 数据流工作在双缓冲模式(DBM)：M0AR与M1AR各指向一个缓冲，传输完成时硬件
+ * 切换CT继续写(读)另一个，中间不停顿。本模块在传输完成中断中把刚完成的
+ * 缓冲交给使用者，并用 DMA_MemoryTargetConfig() 只改写此时空闲的地址寄存器，
+ * 装入下一个缓冲；缓冲只以指针传递，连续采集不需要逐点拷贝。
+ *
+ * 采集（外设到存储器，ADC/I2S/DCMI）：STREAM_Get() 取得已写满的缓冲，
+ * 处理完用 STREAM_Release() 归还，归还的缓冲排队等待再次装入。
+ * 播放（存储器到外设，DAC/I2S）：STREAM_Get() 取得已播完的空闲缓冲，
+ * 填好后用 STREAM_Release() 提交，按提交顺序播放。
+ *
+ * 没有排队的缓冲可装入时，空闲寄存器暂时保留刚完成的缓冲，半传输中断时
+ * 再检查一次，期间归还的缓冲仍来得及装入；若DMA切换回该缓冲时
+ * 它仍未被取走（或仍被使用者持有），说明使用者跟不上：该缓冲被覆盖（采集）
+ * 或重播（播放），计入 overruns，未取走的直接作废。两个缓冲即经典的乒乓
+ * 缓冲，使用者须在一个缓冲时长内归还；更多缓冲允许更长的处理抖动。
+ */
+
+#ifndef _MYSTREAM_H_
+#define _MYSTREAM_H_
+
+#include "stm32f4xx.h"
+#include "../myDma/myDma.h"
+
+/**
+ * @defgroup STREAM_Config 配置
+ * @{
+ */
+#define STREAM_BUF_MAX 8 ///< 每个流的最大缓冲数
+#define STREAM_IRQ_PRIO ((1 << __NVIC_PRIO_BITS) - 2) ///< 中断优先级，高于蜂鸣器与异步拷贝
+/** @} */
+
+/**
+ * @brief 缓冲就绪通知，在DMA中断中调用（如投递处理任务）
+ */
+typedef void (*STREAM_Notify)(void *arg);
+
+/**
+ * @brief 流对象，由调用者分配存储，成员由本模块维护
+ */
+typedef struct
+{
+  void *bufs[STREAM_BUF_MAX];   ///< 缓冲地址
+  uint8_t num;                  ///< 缓冲数
+  uint16_t items;               ///< 每个缓冲的数据项数
+  uint8_t playback;             ///< 1: 存储器到外设
+  uint8_t dma;                  ///< DMA数据流句柄
+  uint8_t idle_id;              ///< 空闲管理中的模块编号
+  uint8_t reg[2];               ///< M0AR/M1AR中的缓冲序号
+  uint8_t state[STREAM_BUF_MAX]; ///< 各缓冲状态
+  uint8_t dma_q[STREAM_BUF_MAX]; ///< 等待装入的缓冲
+  uint8_t dma_head;
+  uint8_t dma_count;
+  uint8_t user_q[STREAM_BUF_MAX]; ///< 交给使用者的缓冲
+  uint8_t user_head;
+  uint8_t user_count;
+  STREAM_Notify notify;         ///< 缓冲就绪通知
+  void *notify_arg;
+  uint32_t buffers;             ///< 完成的缓冲数
+  uint32_t overruns;            ///< 使用者跟不上的次数
+  uint32_t errors;              ///< DMA传输错误次数
+} STREAM_t;
+
+/**
+ * @brief 初始化流：分配数据流并配置为双缓冲循环模式
+ * @param s 流对象
+ * @param name 使用者名称
+ * @param req DMA请求
+ * @param init DMA配置：由调用者填写外设地址、方向、数据宽度、每个缓冲的
+ *             数据项数(DMA_BufferSize)、优先级与FIFO；通道、存储器地址、
+ *             存储器递增与循环模式由本函数设置
+ * @param bufs 缓冲地址数组，不能位于CCM
+ * @param num 缓冲数，2 ~ STREAM_BUF_MAX
+ * @retval SUCCESS；参数错误、任一缓冲不符合 DMAM_Validate() 或数据流冲突时返回ERROR
+ * @note 突发/FIFO配置可先用 DMAM_Tune() 按第一个缓冲选择
+ * @note 在 VEC_Init() 之后调用；外设自身的DMA请求（ADC_DMACmd 等）由调用者使能
+ */
+ErrorStatus STREAM_Init(STREAM_t *s, const char *name, DMAM_Request req, DMA_InitTypeDef *init, void *const *bufs,
+                        uint8_t num);
+
+/**
+ * @brief 登记缓冲就绪通知
+ */
+void STREAM_SetNotify(STREAM_t *s, STREAM_Notify notify, void *arg);
+
+/**
+ * @brief 开始传输：前两个缓冲装入M0AR/M1AR
+ * @note 播放时前两个缓冲的内容立即输出，其余缓冲交给生产者填充
+ */
+void STREAM_Start(STREAM_t *s);
+
+/**
+ * @brief 停止传输，全部缓冲收回
+ */
+void STREAM_Stop(STREAM_t *s);
+
+/**
+ * @brief 取得缓冲：采集时为已写满的缓冲，播放时为可填充的空闲缓冲
+ * @retval 缓冲地址，没有时返回NULL
+ * @note 可在中断中调用
+ */
+void *STREAM_Get(STREAM_t *s);
+
+/**
+ * @brief 归还缓冲：采集时交回重新装入，播放时提交播放
+ * @param buf STREAM_Get() 返回的地址
+ * @note 可在中断中调用
+ */
+void STREAM_Release(STREAM_t *s, void *buf);
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * @file myTime.c
+ * @brief 基于SysTick + DWT的单调时基与精确延时实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myTime.h"
+#include "../myMem/myMem.h"
+
+/**
+ * @brief 64位毫秒计数，拆成两个32位字以便无锁读取
+ * @note 只有SysTick中断写入；读取方通过高位前后比较检测进位
+ */
+static volatile uint32_t time_tick_lo;
+static volatile uint32_t time_tick_hi;
+static volatile uint32_t time_hold; ///< TIME_HoldTick() 嵌套计数
+
+/**
+ * @brief 节拍计数一次增加多个节拍（调用者保证关中断）
+ */
+static void TIME_StepTick(uint32_t ticks)
+{
+  uint32_t lo = time_tick_lo + ticks;
+
+  if (lo < time_tick_lo)
+  {
+    time_tick_hi++;
+  }
+  time_tick_lo = lo;
+}
+
+void TIME_Init(void)
+{
+  // 使能DWT周期计数器（启动文件已从复位开始计数，不清零以保留启动计时）
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  time_tick_lo = 0;
+  time_tick_hi = 0;
+
+  TIME_Recalibrate();
+}
+
+void TIME_Recalibrate(void)
+{
+  // SysTick_Config 同时把SysTick设为最低优先级并使能中断
+  if (SysTick_Config(SystemCoreClock / TIME_TICK_HZ))
+  {
+    while (1)
+      ;
+  }
+}
+
+MEM_RAMFUNC void TIME_IncTick(void)
+{
+  if (++time_tick_lo == 0)
+  {
+    time_tick_hi++;
+  }
+}
+
+void TIME_HoldTick(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  time_hold++;
+  __set_PRIMASK(primask);
+}
+
+void TIME_ReleaseTick(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if (time_hold)
+  {
+    time_hold--;
+  }
+  __set_PRIMASK(primask);
+}
+
+uint8_t TIME_IsTickHeld(void)
+{
+  return time_hold != 0;
+}
+
+void TIME_Compensate(uint32_t ticks)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  TIME_StepTick(ticks);
+  __set_PRIMASK(primask);
+}
+
+uint32_t TIME_TicklessSleep(uint32_t ticks)
+{
+  uint32_t cpt = SystemCoreClock / TIME_TICK_HZ; // 每节拍周期数
+  uint32_t max_ticks = SysTick_LOAD_RELOAD_Msk / cpt;
+  uint32_t reload;
+  uint32_t done;
+  uint32_t elapsed;
+  uint32_t ctrl;
+
+  if (ticks > max_ticks)
+  {
+    ticks = max_ticks;
+  }
+
+  if (ticks <= 1 || time_hold)
+  {
+    __DSB();
+    __WFI();
+    __ISB();
+    return 0;
+  }
+
+  // 暂停SysTick，把本节拍剩余部分与后续 ticks-1 个节拍合并为一次重装
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  reload = SysTick->VAL + cpt * (ticks - 1);
+  if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+  {
+    // 暂停前节拍已到，放弃本次睡眠
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    return 0;
+  }
+  SysTick->LOAD = reload;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+  __DSB();
+  __WFI();
+  __ISB();
+
+  // 读CTRL会清除COUNTFLAG，只读一次
+  ctrl = SysTick->CTRL;
+  SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+  if (ctrl & SysTick_CTRL_COUNTFLAG_Msk)
+  {
+    // 睡满：最后一个节拍由挂起的SysTick中断计入，下一节拍扣除已走过的部分
+    elapsed = reload - SysTick->VAL;
+    SysTick->LOAD = (elapsed < cpt) ? cpt - 1 - elapsed : cpt - 1;
+    done = ticks - 1;
+  }
+  else
+  {
+    // 被其他中断提前唤醒：按本节拍起点以来走过的周期数补偿整节拍
+    elapsed = ticks * cpt - SysTick->VAL;
+    done = elapsed / cpt;
+    SysTick->LOAD = (done + 1) * cpt - elapsed;
+  }
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  SysTick->LOAD = cpt - 1; // 下一次重装恢复为1ms
+
+  TIME_StepTick(done);
+  return done;
+}
+
+uint64_t TIME_GetTick(void)
+{
+  uint32_t hi;
+  uint32_t lo;
+
+  do
+  {
+    hi = time_tick_hi;
+    lo = time_tick_lo;
+  } while (hi != time_tick_hi);
+
+  return ((uint64_t)hi << 32) | lo;
+}
+
+uint32_t TIME_GetTick32(void)
+{
+  return time_tick_lo;
+}
+
+uint64_t TIME_GetUs(void)
+{
+  uint64_t ms;
+  uint32_t val;
+  uint32_t load;
+
+  do
+  {
+    ms = TIME_GetTick();
+    val = SysTick->VAL;
+  } while (ms != TIME_GetTick());
+
+  // 计数器已回绕但中断尚未执行（例如在更高优先级中断中调用）
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && val > (SysTick->LOAD >> 1))
+  {
+    ms++;
+  }
+
+  load = SysTick->LOAD + 1;
+  return ms * 1000 + ((uint64_t)(load - 1 - val) * 1000) / load;
+}
+
+uint32_t TIME_CyclesToUs(uint32_t cycles)
+{
+  return (uint32_t)(((uint64_t)cycles * 1000000) / SystemCoreClock);
+}
+
+uint32_t TIME_UsToCycles(uint32_t us)
+{
+  uint64_t cycles = ((uint64_t)us * SystemCoreClock) / 1000000;
+
+  return cycles > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)cycles;
+}
+
+uint64_t TIME_Deadline(uint32_t ms)
+{
+  return TIME_GetTick() + ms;
+}
+
+uint8_t TIME_Expired(uint64_t deadline)
+{
+  return TIME_GetTick() >= deadline;
+}
+
+uint64_t TIME_Elapsed(uint64_t since)
+{
+  return TIME_GetTick() - since;
+}
+
+void Delay_us(uint32_t us)
+{
+  uint32_t start;
+  uint32_t cycles;
+  // 分段等待，保证单段周期数远小于CYCCNT回绕周期
+  const uint32_t chunk_us = 1000000;
+
+  while (us)
+  {
+    uint32_t step = us > chunk_us ? chunk_us : us;
+
+    cycles = TIME_UsToCycles(step);
+    start = DWT->CYCCNT;
+    while ((DWT->CYCCNT - start) < cycles)
+      ;
+    us -= step;
+  }
+}
+
+void Delay_ms(uint32_t ms)
+{
+  while (ms--)
+  {
+    Delay_us(1000);
+  }
+}
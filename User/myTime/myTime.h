@@ -0,0 +1,156 @@
+/**
+ * @file myTime.h
+ * @brief 基于SysTick + DWT的单调时基与精确延时
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * SysTick提供1ms节拍并累计为64位单调计数，DWT->CYCCNT提供周期级
+ * 计时。所有换算都在调用时读取 SystemCoreClock，因此修改系统时钟后
+ * 只需调用 TIME_Recalibrate() 重新装载SysTick即可，延时精度与编译
+ * 优化等级无关。
+ */
+
+#ifndef _MYTIME_H_
+#define _MYTIME_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @brief 时基节拍频率（Hz）
+ */
+#define TIME_TICK_HZ 1000
+
+/**
+ * @brief 时基初始化
+ * @note 使能DWT周期计数器，并按当前 SystemCoreClock 配置1ms SysTick中断
+ */
+void TIME_Init(void);
+
+/**
+ * @brief 系统时钟变化后重新配置SysTick
+ * @note 节拍计数保持连续，当前未满1ms的部分被丢弃
+ */
+void TIME_Recalibrate(void);
+
+/**
+ * @brief 节拍递增，在SysTick_Handler中调用
+ */
+void TIME_IncTick(void);
+
+/**
+ * @brief 申请保持1ms节拍
+ * @note 需要连续节拍的模块（如按键消抖）在活动期间调用，
+ *       期间 TIME_TicklessSleep() 最多只睡眠1个节拍；可嵌套
+ */
+void TIME_HoldTick(void);
+
+/**
+ * @brief 释放 TIME_HoldTick() 的申请
+ */
+void TIME_ReleaseTick(void);
+
+/**
+ * @brief 是否有 TIME_HoldTick() 的申请
+ * @retval 1: 有模块需要连续节拍，0: 无
+ */
+uint8_t TIME_IsTickHeld(void);
+
+/**
+ * @brief 用外部时基补偿SysTick停止期间的节拍
+ * @param ticks 补偿的节拍数
+ * @note 用于STOP模式等SysTick停止计数的场合，由RTC测量经过的时间
+ */
+void TIME_Compensate(uint32_t ticks);
+
+/**
+ * @brief 无节拍睡眠：暂停周期节拍并用WFI等待至多 ticks 个节拍
+ * @param ticks 期望睡眠的节拍数
+ * @retval 睡眠期间补偿的节拍数
+ * @note 必须在关中断(PRIMASK=1)状态下调用，返回时仍为关中断；
+ *       关中断下中断挂起同样可以唤醒WFI，由调用者开中断后处理
+ * @note 单次睡眠受SysTick 24位重装值限制（168MHz下约99ms），
+ *       有 TIME_HoldTick() 申请时退化为普通WFI
+ */
+uint32_t TIME_TicklessSleep(uint32_t ticks);
+
+/**
+ * @brief 获取64位单调毫秒计数
+ * @retval 自 TIME_Init() 以来的毫秒数
+ * @note 可在任务与中断中调用，无需关中断
+ */
+uint64_t TIME_GetTick(void);
+
+/**
+ * @brief 获取毫秒计数的低32位
+ * @retval 毫秒计数低32位（约49.7天回绕，差值运算仍然正确）
+ * @note 单次读取，开销最小，适合中断中打时间戳
+ */
+uint32_t TIME_GetTick32(void);
+
+/**
+ * @brief 获取64位单调微秒计数
+ * @retval 自 TIME_Init() 以来的微秒数
+ * @note 由毫秒计数与SysTick当前计数值合成，关中断超过1ms时结果不可靠
+ */
+uint64_t TIME_GetUs(void);
+
+/**
+ * @brief 获取DWT周期计数
+ * @retval CYCCNT当前值（32位，168MHz下约25.5秒回绕）
+ */
+static __INLINE uint32_t TIME_GetCycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+ * @brief 周期数转换为微秒
+ * @param cycles 周期数
+ * @retval 微秒数（按当前 SystemCoreClock 换算）
+ */
+uint32_t TIME_CyclesToUs(uint32_t cycles);
+
+/**
+ * @brief 微秒转换为周期数
+ * @param us 微秒数
+ * @retval 周期数（按当前 SystemCoreClock 换算，溢出时饱和为0xFFFFFFFF）
+ */
+uint32_t TIME_UsToCycles(uint32_t us);
+
+/**
+ * @brief 计算从现在起 ms 毫秒后的截止时刻
+ * @param ms 相对时间（毫秒）
+ * @retval 截止时刻（64位毫秒计数）
+ */
+uint64_t TIME_Deadline(uint32_t ms);
+
+/**
+ * @brief 判断截止时刻是否已到
+ * @param deadline TIME_Deadline() 返回的截止时刻
+ * @retval 1: 已到期，0: 未到期
+ */
+uint8_t TIME_Expired(uint64_t deadline);
+
+/**
+ * @brief 计算自某时刻以来经过的毫秒数
+ * @param since 起始时刻（TIME_GetTick() 的返回值）
+ * @retval 经过的毫秒数
+ */
+uint64_t TIME_Elapsed(uint64_t since);
+
+/**
+ * @brief 微秒级延时
+ * @param us 延时时间（单位：微秒）
+ * @note 基于DWT->CYCCNT忙等，按当前 SystemCoreClock 换算，关中断时也可使用
+ */
+void Delay_us(uint32_t us);
+
+/**
+ * @brief 毫秒级延时
+ * @param ms 延时时间（单位：毫秒）
+ * @note 基于 Delay_us 实现，精度与编译优化等级无关
+ */
+void Delay_ms(uint32_t ms);
+
+#endif
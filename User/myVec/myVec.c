@@ -0,0 +1,67 @@
+/**
+ * @file myVec.c
+ * @brief 向量表重定位与中断处理函数注册实现
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ */
+
+#include "./myVec.h"
+#include "../myMem/myMem.h"
+
+extern const uint32_t __Vectors[]; ///< 启动文件中的Flash向量表
+
+/**
+ * @brief SRAM向量表（主SRAM，启动时不清零，由 VEC_Init() 整表写入）
+ */
+static uint32_t vec_table[VEC_NUM] __attribute__((aligned(VEC_ALIGN))) MEM_NOINIT;
+
+void VEC_Init(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t i;
+
+  if (SCB->VTOR == (uint32_t)vec_table)
+  {
+    return;
+  }
+
+  for (i = 0; i < VEC_NUM; i++)
+  {
+    vec_table[i] = __Vectors[i];
+  }
+
+  __disable_irq();
+  __DSB();
+  SCB->VTOR = (uint32_t)vec_table;
+  __DSB();
+  __ISB();
+  __set_PRIMASK(primask);
+}
+
+VEC_Handler VEC_SetHandler(IRQn_Type irq, VEC_Handler handler)
+{
+  int32_t idx = 16 + (int32_t)irq;
+  VEC_Handler old;
+
+  if (idx < 2 || idx >= VEC_NUM || SCB->VTOR != (uint32_t)vec_table)
+  {
+    return 0;
+  }
+
+  old = (VEC_Handler)vec_table[idx];
+  vec_table[idx] = (uint32_t)handler;
+  __DSB(); // 写入完成后该中断才可能使用新向量
+  return old;
+}
+
+VEC_Handler VEC_GetHandler(IRQn_Type irq)
+{
+  int32_t idx = 16 + (int32_t)irq;
+
+  if (idx < 2 || idx >= VEC_NUM)
+  {
+    return 0;
+  }
+  return (VEC_Handler)((const uint32_t *)SCB->VTOR)[idx];
+}
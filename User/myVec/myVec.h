@@ -0,0 +1,53 @@
+/**
+ * @file myVec.h
+ * @brief 向量表重定位到SRAM与运行时中断处理函数注册
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * VEC_Init() 把启动文件中的Flash向量表 __Vectors 复制到SRAM并写入
+ * SCB->VTOR。之后中断入口的向量读取不再经过Flash等待周期，且可以用
+ * VEC_SetHandler() 在运行时替换处理函数。处理函数本身放入SRAM见
+ * myMem.h 中的 MEM_RAMFUNC。
+ */
+
+#ifndef _MYVEC_H_
+#define _MYVEC_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @defgroup VEC_Config 向量表参数
+ * @{
+ */
+#define VEC_NUM (16 + 82) ///< 16个内核异常 + 82个外设中断
+#define VEC_ALIGN 512      ///< VTOR要求按表大小向上取2的幂对齐
+/** @} */
+
+/**
+ * @brief 中断处理函数
+ */
+typedef void (*VEC_Handler)(void);
+
+/**
+ * @brief 复制向量表到SRAM并切换VTOR
+ * @note 应在使能任何中断之前、main开始处调用；重复调用无副作用
+ */
+void VEC_Init(void);
+
+/**
+ * @brief 注册中断处理函数
+ * @param irq 中断号，内核异常使用负值（如 SysTick_IRQn）
+ * @param handler 新的处理函数
+ * @retval 原处理函数，irq无效或未调用 VEC_Init() 时返回NULL且不修改
+ */
+VEC_Handler VEC_SetHandler(IRQn_Type irq, VEC_Handler handler);
+
+/**
+ * @brief 获取当前中断处理函数
+ * @param irq 中断号
+ * @retval 处理函数，irq无效时返回NULL
+ */
+VEC_Handler VEC_GetHandler(IRQn_Type irq);
+
+#endif
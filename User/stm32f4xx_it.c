@@ -29,6 +29,11 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx_it.h"
+#include "./myTime/myTime.h"
+#include "./myKey/myKey.h"
+#include "./myMem/myMem.h"
+#include "./myStack/myStack.h"
+#include "./myIdle/myIdle.h"
 
 
 /** @addtogroup Template_Project
@@ -39,6 +44,12 @@
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if STACK_STATS
+static STACK_Ctx_t systick_stack = {"SysTick"};
+static STACK_Ctx_t exti_stack = {"EXTI"};
+static STACK_Ctx_t rtc_wkup_stack = {"RTC_WKUP"};
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -134,6 +145,22 @@ void PendSV_Handler(void)
 {
 }
 
+/**
+  * @brief  This function handles SysTick Handler.
+  * @param  None
+  * @retval None
+  */
+MEM_RAMFUNC void SysTick_Handler(void)
+{
+  STACK_ISR_BEGIN();
+
+  TIME_IncTick();
+  IDLE_Tick();
+  KEY_Tick();
+
+  STACK_ISR_END(systick_stack);
+}
+
 /******************************************************************************/
 /*                 STM32F4xx Peripherals Interrupt Handlers                   */
 /*  Add here the Interrupt Handler for the used peripheral(s) (PPP), for the  */
@@ -150,6 +177,76 @@ void PendSV_Handler(void)
 {
 }*/
 
+/**
+  * @brief  This function handles RTC wakeup timer interrupt request (STOP wakeup).
+  * @param  None
+  * @retval None
+  */
+void RTC_WKUP_IRQHandler(void)
+{
+  STACK_ISR_BEGIN();
+
+  IDLE_RTC_IRQHandler();
+
+  STACK_ISR_END(rtc_wkup_stack);
+}
+
+/**
+  * @brief  This function handles External line 0 interrupt request (KEY0).
+  * @param  None
+  * @retval None
+  */
+void EXTI0_IRQHandler(void)
+{
+  STACK_ISR_BEGIN();
+
+  KEY_EXTI_IRQHandler(EXTI_Line0);
+
+  STACK_ISR_END(exti_stack);
+}
+
+/**
+  * @brief  This function handles External line 2 interrupt request (KEY1).
+  * @param  None
+  * @retval None
+  */
+void EXTI2_IRQHandler(void)
+{
+  STACK_ISR_BEGIN();
+
+  KEY_EXTI_IRQHandler(EXTI_Line2);
+
+  STACK_ISR_END(exti_stack);
+}
+
+/**
+  * @brief  This function handles External line 3 interrupt request (KEY2).
+  * @param  None
+  * @retval None
+  */
+void EXTI3_IRQHandler(void)
+{
+  STACK_ISR_BEGIN();
+
+  KEY_EXTI_IRQHandler(EXTI_Line3);
+
+  STACK_ISR_END(exti_stack);
+}
+
+/**
+  * @brief  This function handles External line 4 interrupt request (KEY3).
+  * @param  None
+  * @retval None
+  */
+void EXTI4_IRQHandler(void)
+{
+  STACK_ISR_BEGIN();
+
+  KEY_EXTI_IRQHandler(EXTI_Line4);
+
+  STACK_ISR_END(exti_stack);
+}
+
 /**
   * @}
   */ 
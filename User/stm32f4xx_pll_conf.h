@@ -0,0 +1,125 @@
+/**
+ * @file stm32f4xx_pll_conf.h
+ * @brief 编译期PLL参数求解：由 HSE_VALUE 与目标频率计算 M/N/P/Q 及PLLI2S参数
+ * @author flowkite-0689
+ * @version v1.0
+ * @date 2026.10.18
+ *
+ * 全部结果都是整型常量表达式，可直接用于寄存器初始化与数组维数，
+ * system_stm32f4xx.c 的 SetSysClock() 与 myClock 的档位表都使用这里的结果。
+ * 与 stm32f4xx_conf.h 一样由工程提供、经包含路径找到，CMSIS不依赖 User/ 下的模块目录。
+ * 求解规则（STM32F405/407，RM0090 6.3.2）：
+ *   - M：VCO输入取2MHz（抖动最小），HSE不是2MHz整数倍时取1MHz；
+ *   - P：在2/4/6/8中取最小的、使 VCO = SYSCLK * P 落在100~432MHz、
+ *     能被VCO输入整除且能整除出 CLOCK_USB_HZ 的值；找不到精确的48MHz时
+ *     退而取VCO合法的最小P，Q四舍五入；
+ *   - PLLI2S：R在2~7中遍历，N四舍五入，取与 CLOCK_I2S_HZ 误差最小者。
+ * 参数越界在编译时报错；实际频率与误差见 CLOCK_PLL_xxx_HZ / CLOCK_xxx_ERR_HZ。
+ *
+ * HSE_VALUE 带有类型转换，不能用于 #if，因此校验用数组维数实现。
+ */
+
+#ifndef _STM32F4XX_PLL_CONF_H_
+#define _STM32F4XX_PLL_CONF_H_
+
+#include "stm32f4xx.h"
+
+/**
+ * @defgroup CLOCK_Pll_Target 目标频率，可在编译选项中覆盖
+ * @{
+ */
+#ifndef CLOCK_SYSCLK_HZ
+#define CLOCK_SYSCLK_HZ 168000000UL ///< SYSCLK
+#endif
+#ifndef CLOCK_USB_HZ
+#define CLOCK_USB_HZ 48000000UL ///< PLL Q输出（USB OTG FS/SDIO/RNG）
+#endif
+#ifndef CLOCK_USB_EXACT
+#define CLOCK_USB_EXACT 1 ///< 1: 要求Q输出精确等于 CLOCK_USB_HZ
+#endif
+#ifndef CLOCK_I2S_HZ
+#define CLOCK_I2S_HZ 86000000UL ///< PLLI2S R输出（48kHz音频、MCLK输出时的常用值）
+#endif
+/** @} */
+
+/**
+ * @defgroup CLOCK_Pll_Limits 器件限制（STM32F405/407）
+ * @{
+ */
+#define CLOCK_SYSCLK_MAX 168000000UL
+#define CLOCK_VCO_MIN 100000000UL
+#define CLOCK_VCO_MAX 432000000UL
+#define CLOCK_N_MIN 50
+#define CLOCK_N_MAX 432
+/** @} */
+
+/**
+ * @brief 编译期断言
+ */
+#define CLOCK_STATIC_ASSERT(cond, name) typedef char clock_assert_##name[(cond) ? 1 : -1]
+
+/* ----------------------------- 主PLL ----------------------------------- */
+
+#define CLOCK_PLL_M (((uint32_t)HSE_VALUE % 2000000UL == 0 && (uint32_t)HSE_VALUE / 2000000UL >= 2) \
+                         ? (uint32_t)HSE_VALUE / 2000000UL                                           \
+                         : (uint32_t)HSE_VALUE / 1000000UL)
+#define CLOCK_PLL_IN_HZ ((uint32_t)HSE_VALUE / CLOCK_PLL_M) ///< VCO输入
+
+#define CLOCK_VCO_FOR(p) (CLOCK_SYSCLK_HZ * (p))
+#define CLOCK_VCO_OK(p)                                                                 \
+  (CLOCK_VCO_FOR(p) >= CLOCK_VCO_MIN && CLOCK_VCO_FOR(p) <= CLOCK_VCO_MAX &&            \
+   CLOCK_VCO_FOR(p) % CLOCK_PLL_IN_HZ == 0)
+#define CLOCK_USB_OK(p)                                                                 \
+  (CLOCK_VCO_OK(p) && CLOCK_VCO_FOR(p) % CLOCK_USB_HZ == 0 &&                           \
+   CLOCK_VCO_FOR(p) / CLOCK_USB_HZ >= 2 && CLOCK_VCO_FOR(p) / CLOCK_USB_HZ <= 15)
+
+#define CLOCK_PLL_P                                                                     \
+  (CLOCK_USB_OK(2) ? 2 : CLOCK_USB_OK(4) ? 4 : CLOCK_USB_OK(6) ? 6 : CLOCK_USB_OK(8) ? 8 \
+   : CLOCK_VCO_OK(2) ? 2 : CLOCK_VCO_OK(4) ? 4 : CLOCK_VCO_OK(6) ? 6 : 8)
+#define CLOCK_PLL_VCO_HZ CLOCK_VCO_FOR(CLOCK_PLL_P)
+#define CLOCK_PLL_N (CLOCK_PLL_VCO_HZ / CLOCK_PLL_IN_HZ)
+#define CLOCK_PLL_Q ((CLOCK_PLL_VCO_HZ + CLOCK_USB_HZ / 2) / CLOCK_USB_HZ)
+
+#define CLOCK_PLL_SYSCLK_HZ (CLOCK_PLL_IN_HZ * CLOCK_PLL_N / CLOCK_PLL_P) ///< 实际SYSCLK
+#define CLOCK_PLL_USB_HZ (CLOCK_PLL_IN_HZ * CLOCK_PLL_N / CLOCK_PLL_Q)    ///< 实际Q输出
+#define CLOCK_SYSCLK_ERR_HZ ((int32_t)(CLOCK_PLL_SYSCLK_HZ - CLOCK_SYSCLK_HZ))
+#define CLOCK_USB_ERR_HZ ((int32_t)(CLOCK_PLL_USB_HZ - CLOCK_USB_HZ))
+
+CLOCK_STATIC_ASSERT((uint32_t)HSE_VALUE % 1000000UL == 0, hse_multiple_of_1mhz);
+CLOCK_STATIC_ASSERT(CLOCK_PLL_M >= 2 && CLOCK_PLL_M <= 63, pll_m_range);
+CLOCK_STATIC_ASSERT(CLOCK_SYSCLK_HZ <= CLOCK_SYSCLK_MAX, sysclk_max);
+CLOCK_STATIC_ASSERT(CLOCK_VCO_OK(CLOCK_PLL_P), pll_vco_range);
+CLOCK_STATIC_ASSERT(CLOCK_PLL_N >= CLOCK_N_MIN && CLOCK_PLL_N <= CLOCK_N_MAX, pll_n_range);
+CLOCK_STATIC_ASSERT(CLOCK_PLL_Q >= 2 && CLOCK_PLL_Q <= 15, pll_q_range);
+CLOCK_STATIC_ASSERT(CLOCK_SYSCLK_ERR_HZ == 0, sysclk_exact);
+CLOCK_STATIC_ASSERT(!CLOCK_USB_EXACT || CLOCK_USB_ERR_HZ == 0, usb_exact);
+
+/* ----------------------------- PLLI2S ---------------------------------- */
+
+#define CLOCK_I2S_N_FOR(r) ((CLOCK_I2S_HZ * (r) + CLOCK_PLL_IN_HZ / 2) / CLOCK_PLL_IN_HZ)
+#define CLOCK_I2S_VCO_FOR(r) (CLOCK_PLL_IN_HZ * CLOCK_I2S_N_FOR(r))
+#define CLOCK_I2S_OUT_FOR(r) (CLOCK_I2S_VCO_FOR(r) / (r))
+#define CLOCK_I2S_ERR_FOR(r)                                                            \
+  ((CLOCK_I2S_N_FOR(r) < CLOCK_N_MIN || CLOCK_I2S_N_FOR(r) > CLOCK_N_MAX ||             \
+    CLOCK_I2S_VCO_FOR(r) < CLOCK_VCO_MIN || CLOCK_I2S_VCO_FOR(r) > CLOCK_VCO_MAX)       \
+       ? 0xFFFFFFFFUL                                                                   \
+   : CLOCK_I2S_OUT_FOR(r) > CLOCK_I2S_HZ ? CLOCK_I2S_OUT_FOR(r) - CLOCK_I2S_HZ          \
+                                         : CLOCK_I2S_HZ - CLOCK_I2S_OUT_FOR(r))
+
+#define CLOCK_MIN2(a, b) ((a) < (b) ? (a) : (b))
+#define CLOCK_I2S_ERR_MIN                                                               \
+  CLOCK_MIN2(CLOCK_MIN2(CLOCK_MIN2(CLOCK_I2S_ERR_FOR(2), CLOCK_I2S_ERR_FOR(3)),         \
+                        CLOCK_MIN2(CLOCK_I2S_ERR_FOR(4), CLOCK_I2S_ERR_FOR(5))),        \
+             CLOCK_MIN2(CLOCK_I2S_ERR_FOR(6), CLOCK_I2S_ERR_FOR(7)))
+
+#define CLOCK_PLLI2S_R                                                                  \
+  (CLOCK_I2S_ERR_FOR(2) == CLOCK_I2S_ERR_MIN ? 2 : CLOCK_I2S_ERR_FOR(3) == CLOCK_I2S_ERR_MIN ? 3 \
+   : CLOCK_I2S_ERR_FOR(4) == CLOCK_I2S_ERR_MIN ? 4 : CLOCK_I2S_ERR_FOR(5) == CLOCK_I2S_ERR_MIN ? 5 \
+   : CLOCK_I2S_ERR_FOR(6) == CLOCK_I2S_ERR_MIN ? 6 : 7)
+#define CLOCK_PLLI2S_N CLOCK_I2S_N_FOR(CLOCK_PLLI2S_R)
+#define CLOCK_PLLI2S_HZ CLOCK_I2S_OUT_FOR(CLOCK_PLLI2S_R) ///< 实际PLLI2S R输出
+#define CLOCK_I2S_ERR_HZ ((int32_t)(CLOCK_PLLI2S_HZ - CLOCK_I2S_HZ))
+
+CLOCK_STATIC_ASSERT(CLOCK_I2S_ERR_MIN != 0xFFFFFFFFUL, plli2s_solvable);
+
+#endif